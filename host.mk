@@ -0,0 +1,103 @@
+################################################################################
+################################## Host build ##################################
+# Builds the robot program for Linux against the simulated devices in sim/, so
+# it can run and be measured off the brain. LemLib only ships as a library for
+# the brain, so the host build compiles it from a LemLib 0.5.5 checkout:
+#
+#   make host LEMLIB_SRC=../LemLib
+#   ./bin/host/sim --auton
+#
+# Benchmarks in sim/bench link against the same program and build with
+#
+#   make bench LEMLIB_SRC=../LemLib
+#   ./bin/host/bench/<name>
+#
+# Paths in HOST_PATHS convert from LemLib's path text to the binary format of
+# include/path/binaryPath.h, as static/<name>.path next to static/<name>.txt,
+# with
+#
+#   make paths
+#
+# Host tools in tools/ build with
+#
+#   make tools
+#   ./bin/host/tools/<name>
+HOSTCXX?=g++
+HOSTLD?=ld
+HOSTBINDIR=$(BINDIR)/host
+
+# lemlib/logger/logger.hpp defines FMT_HEADER_ONLY itself. g++ defines
+# _GNU_SOURCE as 1, which pros/screen.h redefines empty, so it is defined
+# empty here to match
+HOST_CPPFLAGS=-DPROS_SIM -D_PROS_INCLUDE_LIBLVGL_LLEMU_H -D_PROS_INCLUDE_LIBLVGL_LLEMU_HPP
+HOST_CPPFLAGS+=-U_GNU_SOURCE -D_GNU_SOURCE=
+HOST_CPPFLAGS+=-I$(INCDIR) -I$(ROOT)/sim/include
+# LVGL's headers mix enums in its style macros
+HOST_CXXFLAGS=-std=gnu++20 -O2 -g -pthread -Wall -Wno-unused-function -Wno-unused-variable
+HOST_CXXFLAGS+=-Wno-deprecated-enum-enum-conversion
+# assets are linked at fixed addresses, the same as on the brain. fopen goes
+# through the simulated SD card, see sim/src/card.cpp. The assets' objects
+# from ld -b binary say nothing about the stack, which would make it
+# executable
+HOST_LDFLAGS=-no-pie -pthread -Wl,--wrap=fopen -Wl,-z,noexecstack
+
+# the brain screen needs LVGL, which the host does not have
+HOST_PROGRAM_SRC=$(filter-out src/graphics.cpp,$(shell find src -name '*.cpp'))
+HOST_SIM_SRC=$(wildcard sim/src/*.cpp)
+HOST_LEMLIB_SRC=$(if $(LEMLIB_SRC),$(shell cd $(LEMLIB_SRC)/src && find . -name '*.cpp'))
+HOST_ASSETS=$(wildcard static/*)
+HOST_BENCH_SRC=$(wildcard sim/bench/*.cpp)
+HOST_PATHS=static/example.txt
+HOST_TOOLS_SRC=$(wildcard tools/*.cpp)
+
+HOST_OBJ=$(patsubst %,$(HOSTBINDIR)/obj/%.o,$(HOST_PROGRAM_SRC) $(HOST_SIM_SRC) $(HOST_ASSETS))
+HOST_OBJ+=$(patsubst ./%,$(HOSTBINDIR)/lemlib/%.o,$(HOST_LEMLIB_SRC))
+
+.PHONY: host bench paths tools
+host: $(HOSTBINDIR)/sim
+bench: $(patsubst sim/bench/%.cpp,$(HOSTBINDIR)/bench/%,$(HOST_BENCH_SRC))
+paths: $(HOST_PATHS:.txt=.path)
+tools: $(patsubst tools/%.cpp,$(HOSTBINDIR)/tools/%,$(HOST_TOOLS_SRC))
+
+ifneq (,$(filter host bench,$(MAKECMDGOALS)))
+ifeq (,$(LEMLIB_SRC))
+$(error LEMLIB_SRC must point at a LemLib 0.5.5 source checkout)
+endif
+endif
+
+$(HOSTBINDIR)/sim: $(HOST_OBJ) $(HOSTBINDIR)/obj/sim/main.cpp.o
+	@echo "Linking $@"
+	$(VV)$(HOSTCXX) $(HOST_LDFLAGS) -o $@ $^
+
+$(HOSTBINDIR)/bench/%: $(HOST_OBJ) $(HOSTBINDIR)/obj/sim/bench/%.cpp.o
+	$(VV)mkdir -p $(dir $@)
+	@echo "Linking $@"
+	$(VV)$(HOSTCXX) $(HOST_LDFLAGS) -o $@ $^
+
+$(HOSTBINDIR)/obj/%.cpp.o: %.cpp
+	$(VV)mkdir -p $(dir $@)
+	@echo "Compiling $< for the host"
+	$(VV)$(HOSTCXX) $(HOST_CPPFLAGS) $(HOST_CXXFLAGS) -MMD -MP -c -o $@ $<
+
+$(HOSTBINDIR)/lemlib/%.cpp.o: $(LEMLIB_SRC)/src/%.cpp
+	$(VV)mkdir -p $(dir $@)
+	@echo "Compiling $< for the host"
+	$(VV)$(HOSTCXX) $(HOST_CPPFLAGS) $(HOST_CXXFLAGS) -MMD -MP -c -o $@ $<
+
+$(HOSTBINDIR)/tools/%: tools/%.cpp
+	$(VV)mkdir -p $(dir $@)
+	@echo "Compiling $< for the host"
+	$(VV)$(HOSTCXX) $(HOST_CPPFLAGS) $(HOST_CXXFLAGS) -o $@ $<
+
+# kept between runs, rather than rebuilt for every path
+.SECONDARY: $(HOSTBINDIR)/tools/pathConverter
+static/%.path: static/%.txt $(HOSTBINDIR)/tools/pathConverter
+	$(VV)$(HOSTBINDIR)/tools/pathConverter $< $@
+
+# static/ files become _binary_static_<name>_start/_end symbols, which is what
+# ASSET() expects
+$(HOSTBINDIR)/obj/static/%.o: static/%
+	$(VV)mkdir -p $(dir $@)
+	$(VV)$(HOSTLD) -r -b binary -o $@ $<
+
+-include $(shell find $(HOSTBINDIR) -name '*.d' 2>/dev/null)
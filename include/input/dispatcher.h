@@ -0,0 +1,70 @@
+#include "pros/misc.hpp"  // IWYU pragma: keep
+#include "pros/rtos.hpp"  // IWYU pragma: keep
+
+#ifndef INPUT_DISPATCHER_H
+#define INPUT_DISPATCHER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace input {
+enum class EventType { press, release, hold };
+
+struct Event {
+  pros::controller_digital_e_t button;
+  EventType type;
+  std::uint32_t time;    // ms timestamp of the sample that saw it
+  std::uint32_t heldFor; // ms the button has been down, 0 for a press
+};
+
+using Handler = std::function<void(const Event &)>;
+
+// Samples a controller's buttons once per tick and turns the edges between
+// samples into events. Every event seen in one sample is handled in that sample, so
+// buttons pressed together respond together. Handlers run on the dispatcher's
+// task and must not block
+class Dispatcher {
+ public:
+  explicit Dispatcher(pros::Controller &controller, std::uint32_t period = 10);
+
+  // calls `handler` for `type` events on `button`. Hold events repeat every
+  // sample while the button stays down
+  void subscribe(pros::controller_digital_e_t button, EventType type,
+                 Handler handler);
+
+  // samples the controller once and dispatches what changed
+  void poll();
+
+  // polls on a task of its own until stop() is called
+  void start();
+  // waits for the task's last poll to finish, unless called from a handler
+  void stop();
+
+ private:
+  struct Subscription {
+    pros::controller_digital_e_t button;
+    EventType type;
+    Handler handler;
+  };
+
+  struct ButtonState {
+    bool down = false;
+    std::uint32_t pressedAt = 0;
+  };
+
+  void dispatch(const Event &event);
+
+  pros::Controller &controller;
+  std::uint32_t period;
+  std::vector<Subscription> subscriptions;
+  // only buttons with a subscriber are sampled
+  std::vector<pros::controller_digital_e_t> watched;
+  ButtonState buttons[pros::E_CONTROLLER_DIGITAL_A + 1];
+  pros::Task *task = nullptr;
+  std::atomic<bool> running{false};
+};
+}  // namespace input
+
+#endif
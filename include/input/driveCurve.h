@@ -0,0 +1,205 @@
+#include "lemlib/chassis/chassis.hpp"  // IWYU pragma: keep
+#include "util/constMath.h"            // IWYU pragma: keep
+
+#ifndef INPUT_DRIVE_CURVE_H
+#define INPUT_DRIVE_CURVE_H
+
+#include <array>
+#include <cstddef>
+
+namespace input {
+// one entry per joystick value, -127 to 127
+constexpr int kCurveSize = 255;
+
+// The shapes below map a joystick value in -127 to 127 to power out of 127,
+// in constexpr, so a TableCurve can bake them when the program is compiled.
+// Any constexpr callable from float to float will do, a lambda included
+
+// LemLib's ExpoDriveCurve, to the same formula
+struct Expo {
+  // joystick deadband out of 127
+  float deadband;
+  // the least power the curve gives past the deadband, out of 127
+  float minOutput;
+  // expo curve gain, 1 for linear
+  float gain;
+
+  constexpr float operator()(float input) const {
+    const double magnitude = input < 0 ? -input : input;
+    if (magnitude <= deadband) return 0;
+    const double g = magnitude - deadband;
+    const double g127 = 127 - deadband;
+    const double i = util::pow(gain, g - 127) * g;
+    const double i127 = util::pow(gain, g127 - 127) * g127;
+    const double output = (127.0 - minOutput) / 127 * i * 127 / i127 +
+                          minOutput;
+    return input < 0 ? -output : output;
+  }
+};
+
+// Past the deadband, minOutput plus the rest of the power by w t^3 +
+// (1 - w) t, where t is how far the stick is past the deadband out of the
+// travel left. 0 is linear, 1 a pure cubic
+struct Cubic {
+  float deadband;
+  float minOutput;
+  float weight;
+
+  constexpr float operator()(float input) const {
+    const double magnitude = input < 0 ? -input : input;
+    if (magnitude <= deadband) return 0;
+    const double t = (magnitude - deadband) / (127 - deadband);
+    const double output =
+        minOutput +
+        (127 - minOutput) * (weight * t * t * t + (1 - weight) * t);
+    return input < 0 ? -output : output;
+  }
+};
+
+// a joystick value on the positive half of a curve, and the power it gives
+struct CurvePoint {
+  float input;
+  float output;
+};
+
+// Straight lines between points on the positive half, in order of input, and
+// the same mirrored for negative input. Past the last point the output holds
+//
+//   input::Piecewise({{5, 0}, {80, 40}, {127, 127}})
+template <std::size_t N> class Piecewise {
+  static_assert(N >= 2, "a piecewise curve needs two points");
+
+ public:
+  constexpr Piecewise(const CurvePoint (&points)[N]) {
+    for (std::size_t i = 0; i < N; i++) this->points[i] = points[i];
+  }
+
+  constexpr float operator()(float input) const {
+    const float magnitude = input < 0 ? -input : input;
+    float output = points[N - 1].output;
+    if (magnitude <= points[0].input) {
+      output = points[0].output;
+    } else {
+      for (std::size_t i = 1; i < N; i++) {
+        if (magnitude > points[i].input) continue;
+        const CurvePoint &a = points[i - 1];
+        const CurvePoint &b = points[i];
+        output = a.output + (magnitude - a.input) / (b.input - a.input) *
+                                (b.output - a.output);
+        break;
+      }
+    }
+    return input < 0 ? -output : output;
+  }
+
+ private:
+  std::array<CurvePoint, N> points = {};
+};
+
+// A smooth curve through points on the positive half, mirrored the same way
+// as Piecewise. Monotone cubic (Fritsch-Carlson) interpolation, so between
+// two points the power never goes past either of them, as a natural spline's
+// would
+template <std::size_t N> class Spline {
+  static_assert(N >= 2, "a spline needs two points");
+
+ public:
+  constexpr Spline(const CurvePoint (&points)[N]) {
+    for (std::size_t i = 0; i < N; i++) this->points[i] = points[i];
+    // the slope of each segment, and at each point the mean of the slopes
+    // either side, or flat where they disagree
+    double slopes[N - 1] = {};
+    for (std::size_t i = 0; i + 1 < N; i++) {
+      slopes[i] = (points[i + 1].output - points[i].output) /
+                  double(points[i + 1].input - points[i].input);
+    }
+    tangents[0] = slopes[0];
+    tangents[N - 1] = slopes[N - 2];
+    for (std::size_t i = 1; i + 1 < N; i++) {
+      tangents[i] = slopes[i - 1] * slopes[i] <= 0
+                        ? 0
+                        : (slopes[i - 1] + slopes[i]) / 2;
+    }
+    // tangents more than three times a segment's slope would overshoot
+    for (std::size_t i = 0; i + 1 < N; i++) {
+      if (slopes[i] == 0) {
+        tangents[i] = 0;
+        tangents[i + 1] = 0;
+        continue;
+      }
+      const double limit = 3 * slopes[i];
+      if (tangents[i] / limit > 1) tangents[i] = limit;
+      if (tangents[i + 1] / limit > 1) tangents[i + 1] = limit;
+    }
+  }
+
+  constexpr float operator()(float input) const {
+    const float magnitude = input < 0 ? -input : input;
+    float output = points[N - 1].output;
+    if (magnitude <= points[0].input) {
+      output = points[0].output;
+    } else {
+      for (std::size_t i = 1; i < N; i++) {
+        if (magnitude > points[i].input) continue;
+        const CurvePoint &a = points[i - 1];
+        const CurvePoint &b = points[i];
+        const double h = b.input - a.input;
+        const double t = (magnitude - a.input) / h;
+        const double t2 = t * t;
+        const double t3 = t2 * t;
+        output = (2 * t3 - 3 * t2 + 1) * a.output +
+                 (t3 - 2 * t2 + t) * h * tangents[i - 1] +
+                 (-2 * t3 + 3 * t2) * b.output + (t3 - t2) * h * tangents[i];
+        break;
+      }
+    }
+    return input < 0 ? -output : output;
+  }
+
+ private:
+  std::array<CurvePoint, N> points = {};
+  std::array<double, N> tangents = {};
+};
+
+// `then` applied to what `first` gives, such as a spline over the output of
+// an expo curve
+template <typename First, typename Then> struct Composed {
+  First first;
+  Then then;
+
+  constexpr float operator()(float input) const { return then(first(input)); }
+};
+
+template <typename First, typename Then>
+constexpr Composed<First, Then> compose(First first, Then then) {
+  return {first, then};
+}
+
+// A drive curve baked into a table of every joystick value. LemLib's
+// ExpoDriveCurve works out two pow calls for every input, and arcade and
+// curvature control call the throttle and steer curves every tick; this one
+// looks the power up, interpolating between entries for input between
+// joystick values, and holds the ends past -127 and 127. Declared constinit,
+// the table is made by the compiler and costs nothing at startup
+//
+//   constinit input::TableCurve throttleCurve(input::Expo{3, 10, 1.019});
+class TableCurve : public lemlib::DriveCurve {
+ public:
+  template <typename Shape> constexpr explicit TableCurve(Shape shape) {
+    for (int i = 0; i < kCurveSize; i++) table[i] = shape(float(i - 127));
+  }
+
+  constexpr float curve(float input) override {
+    const float position =
+        (input < -127 ? -127 : input > 127 ? 127 : input) + 127;
+    const int i = static_cast<int>(position);
+    if (i == kCurveSize - 1) return table[i];
+    return table[i] + (position - i) * (table[i + 1] - table[i]);
+  }
+
+ private:
+  std::array<float, kCurveSize> table = {};
+};
+}  // namespace input
+
+#endif
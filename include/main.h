@@ -39,6 +39,16 @@
 #include "lemlib-tarball/api.hpp"   // IWYU pragma: export
 #include "liblvgl/lvgl.h"           // IWYU pragma: export
 #include "graphics.h"               // IWYU pragma: export
+#include "input/dispatcher.h"       // IWYU pragma: export
+#include "input/driveCurve.h"       // IWYU pragma: export
+#include "motion/chassis.h"         // IWYU pragma: export
+#include "odom/ekf.h"               // IWYU pragma: export
+#include "odom/scheduler.h"         // IWYU pragma: export
+#include "path/tarball.h"           // IWYU pragma: export
+#include "telemetry/log.h"          // IWYU pragma: export
+#include "telemetry/recorder.h"     // IWYU pragma: export
+#include "telemetry/stream.h"       // IWYU pragma: export
+#include "tune/autotuner.h"         // IWYU pragma: export
 
 /**
  * You should add more #includes here
@@ -0,0 +1,311 @@
+#include "lemlib/chassis/chassis.hpp"  // IWYU pragma: keep
+#include "motion/handle.h"             // IWYU pragma: keep
+#include "motion/mixer.h"              // IWYU pragma: keep
+#include "motion/pid.h"                // IWYU pragma: keep
+#include "motion/profile.h"            // IWYU pragma: keep
+#include "motion/settle.h"             // IWYU pragma: keep
+#include "motion/timedPath.h"          // IWYU pragma: keep
+#include "motion/tracker.h"            // IWYU pragma: keep
+#include "odom/scheduler.h"            // IWYU pragma: keep
+#include "path/binaryPath.h"           // IWYU pragma: keep
+#include "path/pathIndex.h"            // IWYU pragma: keep
+
+#ifndef MOTION_CHASSIS_H
+#define MOTION_CHASSIS_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+
+namespace motion {
+// How profiled motions drive: the limits their profiles are made within, and
+// the feedforward that follows them. Constraints of zero leave profiled
+// motions to the lateral PID alone
+struct ProfileSettings {
+  Constraints constraints = {0, 0, 0};
+  Feedforward feedforward = {0, 0, 0};
+  // power per in/s a wheel is short of the speed the RAMSETE or LTV tracker
+  // wants from it, on top of the feedforward
+  float kVelocity = 0;
+};
+
+// Parameters for Chassis::profiledMoveToPoint and profiledMoveToPose, named
+// the same way as LemLib's
+struct ProfiledMoveParams {
+  // whether the robot should move forwards or backwards
+  bool forwards = true;
+  // the most motor power the motion uses, out of 127
+  float maxSpeed = 127;
+  // carrot point multiplier for profiledMoveToPose, as in LemLib's moveToPose
+  float lead = 0.6;
+  // limits for this motion only, instead of the chassis's
+  std::optional<Constraints> constraints;
+  // A profile made ahead of time for the length of the move, such as in
+  // initialize, so starting the motion computes nothing
+  std::optional<Profile> profile;
+  // in/s the robot may still be moving at as it passes the target, when the
+  // move is queued with another after it. 0 stops at the target
+  float exitSpeed = 0;
+};
+
+// Parameters for Chassis::follow over a TimedPath
+struct TimedFollowParams {
+  // how the robot steers along the path
+  Tracker tracker = Tracker::PurePursuit;
+  // inches further along the path than the robot that pure pursuit steers at
+  float lookahead = 15;
+  // whether the robot should move forwards or backwards
+  bool forwards = true;
+};
+
+// LemLib's chassis with the motions this project adds. They run through the
+// same motion queue as LemLib's own, so they can be mixed and waited on the
+// same way. Each also returns a Handle to trigger actions off it, wait on it
+// or cancel it by itself
+class Chassis : public lemlib::Chassis {
+ public:
+  using lemlib::Chassis::Chassis;
+  using lemlib::Chassis::follow;
+
+  // LemLib's constructor, plus the settings for profiled motions
+  Chassis(lemlib::Drivetrain drivetrain,
+          lemlib::ControllerSettings linearSettings,
+          lemlib::ControllerSettings angularSettings,
+          lemlib::OdomSensors sensors, ProfileSettings profileSettings,
+          lemlib::DriveCurve *throttleCurve = &lemlib::defaultDriveCurve,
+          lemlib::DriveCurve *steerCurve = &lemlib::defaultDriveCurve);
+
+  // LemLib's pure pursuit over a path converted by tools/pathConverter.cpp,
+  // read in place from its asset. A step of it does not depend on the length
+  // of the path, see path::PathIndex
+  //
+  //   ASSET(example_path);
+  //   chassis.follow(path::BinaryPath(example_path), 15, 4000);
+  Handle follow(path::BinaryPath path, float lookahead, int timeout,
+                bool forwards = true, bool async = true);
+  // Follows a path by time: how far along it the robot should be follows the
+  // path's velocity profile. With pure pursuit, that takes feedforward from
+  // the profile plus the lateral PID on how far the robot is behind, and
+  // steering at the point `lookahead` inches further along the path than the
+  // robot. The RAMSETE and LTV trackers instead correct the robot towards
+  // where the profile has it, along and across the path and in heading, and
+  // drive each wheel at the speed they want with the feedforward, plus
+  // kVelocity on the wheel speed odometry measures. Once the profile ends,
+  // LemLib's lateral exit conditions end the motion on the distance left to
+  // the end. The path must outlive the motion
+  //
+  //   chassis.follow(route, 4000, {.tracker = motion::Tracker::Ramsete});
+  Handle follow(const TimedPath &path, int timeout,
+                TimedFollowParams params = {}, bool async = true);
+
+  // LemLib's moveToPoint, driven along a motion profile instead of by PID
+  // alone. The robot's distance along the line to the target follows the
+  // profile, with feedforward from the profile's velocity and acceleration
+  // plus the lateral PID on how far the robot is behind it. Once the profile
+  // ends, the lateral PID settles on the target and LemLib's lateral exit
+  // conditions end the motion. Steering is the same as LemLib's
+  Handle profiledMoveToPoint(float x, float y, int timeout,
+                             ProfiledMoveParams params = {},
+                             bool async = true);
+  // LemLib's moveToPose, profiled the same way over the length of the curve
+  // from the robot through the first carrot point to the target. `theta` is
+  // in degrees, the same as LemLib's
+  Handle profiledMoveToPose(float x, float y, float theta, int timeout,
+                            ProfiledMoveParams params = {}, bool async = true);
+
+  // LemLib's turnToHeading, steered by the turn PID if one is set. `theta` is
+  // in degrees, and waitUntil counts degrees turned, the same as LemLib's
+  Handle turnToHeading(float theta, int timeout,
+                       lemlib::TurnToHeadingParams params = {},
+                       bool async = true);
+
+  // LemLib's drive modes for driver control, through the drive curves the
+  // same way. With a mixer set, the motors are driven by voltage, and each
+  // mode's sides are desaturated by the mixer against what the battery can
+  // give. Arcade's desaturateBias desaturates full power by LemLib's own
+  // formula, and splits the cut to what the battery gives, see
+  // DriveMixer::arcade.
+  // Without one, they are LemLib's own
+  void tank(int left, int right, bool disableDriveCurve = false);
+  void arcade(int throttle, int turn, bool disableDriveCurve = false,
+              float desaturateBias = 0.5);
+  void curvature(int throttle, int turn, bool disableDriveCurve = false);
+
+  // A route of motions that run back to back from one task. Each is planned
+  // when it is queued, from where the one before it ends, so nothing is
+  // worked out between them. A move hands on to a move or path after it at
+  // its exitSpeed instead of stopping, slowed by how sharply the route turns
+  // there and to what the next move can still stop from, and the next takes
+  // over just before the target rather than settling on it. Queueing never
+  // waits: with 16 motions queued already, the motion is turned away and its
+  // handle comes back cancelled and done. The first motion starts the route
+  // on a task of its own, which waits out any motion already running, and
+  // the route ends once the last motion queued has, so queue the whole route
+  // before waiting on it. isInMotion, waitUntilDone and the
+  // cancels treat the route as one motion, and waitUntil counts the distance
+  // along all of it. Each motion's handle is its own: cancelling it skips
+  // that motion and carries on with the rest of the route
+  //
+  //   chassis.queueMoveToPoint(0, 24, 2000, {.exitSpeed = 40});
+  //   chassis.queueMoveToPoint(24, 48, 2000, {.exitSpeed = 40});
+  //   chassis.queueFollow(path::BinaryPath(example_path), 15, 4000);
+  //   chassis.waitUntilDone();
+  Handle queueMoveToPoint(float x, float y, int timeout,
+                          ProfiledMoveParams params = {});
+  Handle queueMoveToPose(float x, float y, float theta, int timeout,
+                         ProfiledMoveParams params = {});
+  // LemLib's turnToHeading, in degrees. A move before it stops, and a
+  // minSpeed hands on to the next motion the same way it does in LemLib
+  Handle queueTurnToHeading(float theta, int timeout,
+                            lemlib::TurnToHeadingParams params = {});
+  // the pure pursuit of follow over a BinaryPath
+  Handle queueFollow(path::BinaryPath path, float lookahead, int timeout,
+                     bool forwards = true);
+
+  void setProfileSettings(const ProfileSettings &settings) {
+    profileSettings = settings;
+  }
+  void setRamsete(const Ramsete &controller) { ramsete = controller; }
+  void setLtv(const LtvUnicycle &controller) { ltv = controller; }
+  // Where the trackers read the robot's speed. LemLib's own odometry does
+  // not run when an odom::Scheduler does, so its speed would stay at zero.
+  // Without one, the speed comes from lemlib::getLocalSpeed
+  void setOdometry(const odom::Scheduler &scheduler) { odometry = &scheduler; }
+  // The chassis's own motions control against the pose odometry
+  // extrapolates over its measured latency, see
+  // odom::Scheduler::getCompensatedPose, rather than the last measured one.
+  // Needs setOdometry. LemLib's motions, and getPose, keep the measured pose.
+  // Off by default: with the IMU's bias, scale error and noise, the heading
+  // rate it extrapolates by is noisy enough that turns settle later and
+  // further off than on the measured pose, see sim/bench/latency
+  void setLatencyCompensation(bool enabled) { compensate = enabled; }
+  // Turns, queued or not, steer with `pid` in place of LemLib's angular PID,
+  // on the heading in degrees. The angular exit conditions still end them
+  void setTurnPid(const Pid &pid) { turnPid = pid; }
+  // The chassis's own motions settle by `settings` in place of LemLib's small
+  // error exit, lateral ones on the distance left and turns on the heading.
+  // LemLib's large error exit still applies
+  void setLateralSettle(const SettleSettings &settings) {
+    lateralSettle.emplace(settings);
+  }
+  void setAngularSettle(const SettleSettings &settings) {
+    angularSettle.emplace(settings);
+  }
+  // The drive modes and the chassis's own motions drive the motors by
+  // voltage through a mixer with `settings`, see DriveMixer. LemLib's own
+  // motions still drive them by power
+  void setMixer(const MixerSettings &settings) { mixer.emplace(settings); }
+  // Swaps the lateral or angular controller's gains and exit conditions, such
+  // as for ones tuned by tune::Autotuner. Only between motions
+  void setLateralSettings(const lemlib::ControllerSettings &settings);
+  void setAngularSettings(const lemlib::ControllerSettings &settings);
+  const lemlib::ControllerSettings &getLateralSettings() const {
+    return lateralSettings;
+  }
+  const lemlib::ControllerSettings &getAngularSettings() const {
+    return angularSettings;
+  }
+
+ private:
+  // A motion of a route, with the plan made when it was queued. Directions
+  // are the way the robot travels, in standard radians
+  struct QueuedMotion {
+    enum class Kind { Move, Turn, Follow };
+
+    Kind kind;
+    int timeout;
+    // a move's target, with its heading in standard radians for a pose
+    lemlib::Pose target = {0, 0, 0};
+    std::optional<float> heading;
+    ProfiledMoveParams move;
+    // a turn's heading, in degrees
+    float theta = 0;
+    lemlib::TurnToHeadingParams turn;
+    // a path to follow
+    std::optional<path::BinaryPath> path;
+    float lookahead = 0;
+    bool forwards = true;
+
+    // where the motion starts and ends, with the direction it sets off in
+    // and arrives in as theta
+    lemlib::Pose start = {0, 0, 0};
+    lemlib::Pose end = {0, 0, 0};
+    float length = 0;
+    Profile profile = Profile(0, {0, 0});
+    std::shared_ptr<MotionState> state;
+  };
+
+  static constexpr std::size_t kQueueLength = 16;
+
+  void startMotion(std::shared_ptr<MotionState> state, bool async,
+                   std::function<void()> body);
+  // whether the motion should carry on: neither it nor the chassis's motions
+  // have been cancelled
+  bool running() const;
+  // hands the current motion's progress to its handles
+  void report(float distance);
+  // Drives the sides at power out of 127, both scaled down together if either
+  // is over `limit`, through the mixer if one is set
+  void drive(float left, float right, float limit = 127);
+
+  void followTimed(const TimedPath &path, int timeout,
+                   TimedFollowParams params);
+  // `heading` is standard radians for a pose, or empty for a point
+  void profiledMove(lemlib::Pose target, std::optional<float> heading,
+                    int timeout, ProfiledMoveParams params);
+  // Drives a move along `profile`, and returns the speed it hands on to the
+  // next motion at. While `handoff` is set, the profile is remade from where
+  // the robot has got to whenever the speed it holds changes
+  float profiledDrive(lemlib::Pose target, std::optional<float> heading,
+                      int timeout, const ProfiledMoveParams &params,
+                      Profile profile, float start,
+                      const std::atomic<float> *handoff);
+  void pursue(path::BinaryPath path, float lookahead, int timeout,
+              bool forwards, float start);
+  // `counted` sets distTraveled to the degrees turned, as LemLib's turns do,
+  // rather than leaving it at the route's distance
+  void turn(float theta, int timeout, lemlib::TurnToHeadingParams params,
+            bool counted);
+
+  // the length and directions of a move from `start`
+  void plan(QueuedMotion &motion, lemlib::Pose start) const;
+  Handle enqueue(QueuedMotion motion);
+  void runRoute();
+  float runQueued(QueuedMotion &motion, float speed, float travelled);
+  void dropRoute();
+
+  // the pose the motions control against, the same as getPose's unless
+  // latency compensation is on
+  lemlib::Pose controlPose(bool radians = false, bool standardPos = false);
+  // the robot's speed in its own frame: sideways, forwards, and the rate of
+  // the heading, per second, in radians
+  lemlib::Pose localSpeed() const;
+
+  ProfileSettings profileSettings;
+  Ramsete ramsete;
+  LtvUnicycle ltv;
+  const odom::Scheduler *odometry = nullptr;
+  bool compensate = false;
+  std::optional<Pid> turnPid;
+  std::optional<SettleCondition> lateralSettle;
+  std::optional<SettleCondition> angularSettle;
+  std::optional<DriveMixer> mixer;
+
+  // the motions of the route not yet finished, the first of them running
+  QueuedMotion queue[kQueueLength];
+  std::size_t queueHead = 0;
+  std::size_t queued = 0;
+  bool routeRunning = false;
+  pros::Mutex queueMutex;
+  // the speed the running move is to hand on at, which the move after it
+  // sets when it is queued
+  std::atomic<float> handoff{0};
+  // the motion running, which only its own task touches
+  std::shared_ptr<MotionState> current;
+  std::uint32_t currentStart = 0;
+};
+}  // namespace motion
+
+#endif
@@ -0,0 +1,102 @@
+#include "lemlib/pose.hpp"  // IWYU pragma: keep
+#include "pros/rtos.hpp"    // IWYU pragma: keep
+
+#ifndef MOTION_HANDLE_H
+#define MOTION_HANDLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace motion {
+// where a motion had got to at one of its control steps
+struct Progress {
+  float distance;     // inches driven since it started, or degrees turned
+  std::uint32_t time; // ms since it started
+  lemlib::Pose pose;  // LemLib's pose, theta in degrees
+};
+
+using Action = std::function<void()>;
+using Condition = std::function<bool(const Progress &)>;
+
+// What a motion shares with its handles: the progress its control steps
+// report, and the actions waiting on it. Only the chassis reports to it
+class MotionState {
+ public:
+  // runs, on the motion's task, the actions whose condition the step meets
+  void report(const Progress &progress);
+  // The motion has ended, whether it finished or was cancelled. Runs the
+  // actions waiting for that, and drops the rest
+  void finish();
+
+  // Calls `action` at the first step that meets `condition`, or when the
+  // motion ends if `orDone` and no step has. Straight away, on the calling
+  // task, if the motion has already ended and `orDone`
+  void add(Condition condition, Action action, bool orDone);
+
+  void cancel() { cancelled = true; }
+  bool isCancelled() const { return cancelled; }
+  bool isDone() const { return done; }
+  Progress progress();
+
+ private:
+  struct Trigger {
+    Condition condition;
+    Action action;
+    bool orDone;
+  };
+
+  pros::Mutex mutex;
+  std::vector<Trigger> triggers;
+  Progress last = {0, 0, {0, 0, 0}};
+  std::atomic<bool> cancelled{false};
+  std::atomic<bool> done{false};
+};
+
+// A motion started by motion::Chassis, to hang actions off and wait on
+// instead of polling waitUntil. Actions run on the motion's task at the first
+// control step that meets their trigger, so they are never more than a step
+// late, and must not block. A trigger the motion has already passed fires at
+// its next step. Waits sleep on a task notification the motion sends when it
+// gets there or ends. Copies refer to the same motion
+//
+//   chassis.profiledMoveToPoint(0, 48, 3000)
+//       .atDistance(30, [] { intake.move(127); })
+//       .onDone([] { clamp.set_value(true); });
+class Handle {
+ public:
+  // a motion that never started, already done
+  Handle();
+  explicit Handle(std::shared_ptr<MotionState> state);
+
+  // once the motion has driven `distance` inches, or turned that many degrees
+  Handle &atDistance(float distance, Action action);
+  // `time` ms after the motion started
+  Handle &atTime(std::uint32_t time, Action action);
+  // at the first step whose progress meets `condition`
+  Handle &when(Condition condition, Action action);
+  // when the motion ends, whether it finished or was cancelled
+  Handle &onDone(Action action);
+
+  // block the calling task until the motion gets that far, or ends
+  void waitUntil(float distance) const;
+  void waitUntilDone() const;
+
+  // Stops the motion at its next step, or keeps a queued one from starting.
+  // Motions queued after it carry on
+  void cancel();
+  bool isDone() const { return state->isDone(); }
+  bool isCancelled() const { return state->isCancelled(); }
+  // the progress the motion's last step reported
+  Progress progress() const { return state->progress(); }
+
+ private:
+  void wait(Condition condition) const;
+
+  std::shared_ptr<MotionState> state;
+};
+}  // namespace motion
+
+#endif
@@ -0,0 +1,72 @@
+#include "motion/profile.h"  // IWYU pragma: keep
+
+#ifndef MOTION_MIXER_H
+#define MOTION_MIXER_H
+
+#include <optional>
+
+namespace motion {
+// How a DriveMixer turns power into voltage
+struct MixerSettings {
+  // mV full power drives a side at. 0, the default, uses all the battery can
+  // give at the time. Set below what the battery still gives under load late
+  // in a match, and the robot drives the same from the start of the match to
+  // the end, but never faster than that on a fresh battery
+  float maxVoltage = 0;
+  // mV the motors need below the battery's voltage to drive at it
+  float headroom = 400;
+  // With a kV on both sides, driver control power is a fraction of topSpeed
+  // in in/s, and each side is driven at what its own feedforward says that
+  // speed takes, so the sticks ask for speeds rather than voltages. kA is not
+  // used. Without, power maps straight onto full voltage
+  Feedforward left = {0, 0, 0};
+  Feedforward right = {0, 0, 0};
+  float topSpeed = 0;
+};
+
+// Turns the power the drive modes and motions ask of each side, out of 127,
+// into voltages for move_voltage. The motors hold a commanded voltage
+// whatever the battery reads, up to the battery's voltage less their
+// headroom, so below that ceiling power drives the same on a flat battery as
+// on a full one. Power over the ceiling, read from the battery every update,
+// is brought under it here, rather than left for each motor to clip on its
+// own: clipping one side and not the other changes how sharply the robot
+// turns, and by more the further the battery has sagged. Every drive mode and
+// motion desaturates the same way, here
+class DriveMixer {
+ public:
+  // mV
+  struct Voltages {
+    float left;
+    float right;
+  };
+
+  explicit DriveMixer(const MixerSettings &settings) : settings(settings) {}
+
+  // For arcade drive. Past full power the throttle and turn are desaturated
+  // by LemLib's arcade's own formula, truncating to whole power the same way,
+  // so full power feels as it does through LemLib. Past the ceiling, `bias`
+  // is then the share of the cut that comes off the throttle, the sides'
+  // mean, and the rest comes off the turn. At 0.5 that takes the same off
+  // each side as the motors clipping the faster one would, so the robot is no
+  // slower on a flat battery than through LemLib
+  Voltages arcade(float throttle, float turn, float bias) const;
+  // For tank and curvature drive, through the feedforward if one is set.
+  // Both sides are scaled down together, keeping the arc the robot drives
+  Voltages driver(float left, float right) const;
+  // For motions whose power has feedforward in already. Both sides are
+  // scaled down together to no more than `limit`, out of 127, or the ceiling
+  Voltages power(float left, float right, float limit = 127) const;
+
+  // mV the sides can be driven at now, from the battery's voltage
+  float ceiling() const;
+
+ private:
+  // power out of 127 to mV, through the feedforward if one is set
+  Voltages voltages(float left, float right) const;
+
+  MixerSettings settings;
+};
+}  // namespace motion
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef MOTION_PID_H
+#define MOTION_PID_H
+
+#include <cstddef>
+#include <initializer_list>
+
+namespace motion {
+// PID gains in LemLib's units: kI per update's worth of error summed, and kD
+// per change in error from one update to the next
+struct Gains {
+  float kP;
+  float kI;
+  float kD;
+};
+
+// the gains for one size of error, at rest and at the schedule's speed
+struct GainPoint {
+  float error;
+  Gains rest;
+  Gains moving;
+};
+
+// Gains that change with how far the loop is from its target and how fast it
+// is moving. Between the points, and between rest and the schedule's speed,
+// the gains are interpolated linearly; past the ends they hold. Holds up to
+// kMaxPoints points, in order of error, without allocating
+//
+//   // gentle far out, stiffer close in, and more damping when moving fast
+//   motion::GainSchedule schedule(400, {{5, {6, 0, 30}, {6, 0, 50}},
+//                                       {45, {3, 0, 20}, {3, 0, 35}}});
+class GainSchedule {
+ public:
+  static constexpr std::size_t kMaxPoints = 8;
+
+  // one set of gains for every error and speed
+  GainSchedule(Gains gains);
+  // `speed` is in units per second of what the loop controls. An empty
+  // schedule gives zero gains
+  GainSchedule(float speed, std::initializer_list<GainPoint> points);
+
+  Gains at(float error, float speed) const;
+
+ private:
+  GainPoint points[kMaxPoints];
+  std::size_t count;
+  float speed;
+};
+
+// A PID for the chassis's motions in place of lemlib::PID, with its gains
+// scheduled on the size of the error and the speed of the loop. The
+// derivative is taken on the measurement rather than the error, so moving
+// the target between updates, as chained motions do, does not kick the
+// output, and it is low-passed so encoder noise is not amplified. The
+// integral only grows while the output is short of its limit, or shrinking
+// it. An update costs a few multiplies more than LemLib's and never
+// allocates
+class Pid {
+ public:
+  // `filter` is the derivative's time constant in ms, 0 for none. The
+  // integral is cleared while the error is outside `windupRange`, unless 0.
+  // `period` is the ms between updates, which the speed is measured over
+  Pid(GainSchedule schedule, float filter = 0, float windupRange = 0,
+      float period = 10);
+
+  // `error` is the target less `measurement`, in whatever way the motion
+  // works it out, such as across the wrap of a heading. The output is
+  // clamped to `limit`
+  float update(float error, float measurement, float limit = 127);
+  void reset();
+
+  // the speed of the measurement at the last update, filtered, per second
+  float getSpeed() const { return speed; }
+
+ private:
+  GainSchedule schedule;
+  float alpha;
+  float windupRange;
+  float period;
+
+  float integral = 0;
+  // filtered change in the measurement per update
+  float derivative = 0;
+  float speed = 0;
+  float prevMeasurement = 0;
+  bool started = false;
+};
+}  // namespace motion
+
+#endif
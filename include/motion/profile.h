@@ -0,0 +1,80 @@
+#ifndef MOTION_PROFILE_H
+#define MOTION_PROFILE_H
+
+#include <cstddef>
+
+namespace motion {
+// limits on the robot's motion along a profile
+struct Constraints {
+  float maxVelocity;     // in/s
+  float maxAcceleration; // in/s^2
+  float maxJerk = 0;     // in/s^3. 0 for a trapezoidal profile
+};
+
+// Motor power, out of 127, to hold a velocity and acceleration: enough to
+// overcome friction, plus the back EMF at that speed, plus what it takes to
+// accelerate the robot. Added to the PID's output, so the PID only corrects
+// what the model misses
+struct Feedforward {
+  float kS; // power to get moving
+  float kV; // power per in/s
+  float kA; // power per in/s^2
+
+  float power(float velocity, float acceleration) const;
+};
+
+// where a profile is at a point in time
+struct ProfileState {
+  float position;     // in
+  float velocity;     // in/s
+  float acceleration; // in/s^2
+};
+
+// A time-optimal profile for moving a distance within the constraints, from
+// one speed to another: up to seven phases of constant jerk, or three of
+// constant acceleration when the jerk is not limited. The phases are worked
+// out when the profile is made, and sampling one only evaluates a polynomial,
+// so a profile costs the same to follow whether it was made when the motion
+// started or long before
+class Profile {
+ public:
+  // `distance` is taken as its magnitude. Starting and ending at rest unless
+  // told otherwise. An end speed that cannot be reached within the distance
+  // is lowered to one that can, and one that cannot be slowed to is raised.
+  // A start faster than maxVelocity that cannot be slowed to it within the
+  // distance ends as slow as it can, still over maxVelocity: check
+  // getEndVelocity
+  Profile(float distance, const Constraints &constraints,
+          float startVelocity = 0, float endVelocity = 0);
+
+  // Clamped to the start of the profile. Past its end, the robot carries on
+  // at the end speed
+  ProfileState sample(float time) const;
+  float getDuration() const { return duration; }
+  float getDistance() const { return distance; }
+  float getEndVelocity() const { return endVelocity; }
+
+ private:
+  struct Phase {
+    float duration;
+    float jerk;
+    ProfileState start;
+  };
+
+  void addPhase(float duration, float jerk, float acceleration);
+  // from one speed to another, as fast as the constraints allow
+  void addRamp(float from, float to, const Constraints &constraints);
+
+  Phase phases[7];
+  std::size_t count = 0;
+  float duration = 0;
+  float distance;
+  float startVelocity;
+  float endVelocity;
+};
+
+// the fastest the robot can be moving and still stop within a distance
+float stoppingVelocity(float distance, const Constraints &constraints);
+}  // namespace motion
+
+#endif
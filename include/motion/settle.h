@@ -0,0 +1,60 @@
+#ifndef MOTION_SETTLE_H
+#define MOTION_SETTLE_H
+
+#include <cstdint>
+
+namespace motion {
+// When a motion counts as settled, in inches for lateral motions and degrees
+// for turns
+struct SettleSettings {
+  // how close to the target counts as on it
+  float range;
+  // speed, per second, below which the robot counts as stopped
+  float speed;
+  // ms the robot has to stay on target and stopped, or be about to
+  std::uint32_t time;
+  // Further out than `range`, a robot that has got going and then stopped
+  // has settled as close as it is going to get, such as on a PID with no kI
+  // short of the target. 0 leaves it to LemLib's large error exit
+  float stallRange;
+  // ms ahead to look for the robot coming to rest within range, 0 for none
+  std::uint32_t horizon;
+};
+
+// An exit condition for the chassis's motions in place of LemLib's small
+// error exit. LemLib's exits only look at the error: they exit while the
+// robot coasts through the small range as readily as once it has stopped in
+// it, and a robot that stops just outside it waits out the large exit's whole
+// timeout. This one only counts the robot as settled while it is also below
+// the stopped speed, so its time can be a couple of updates rather than a
+// hundred ms, and a robot that got going and stopped within the stall range
+// has settled too. It also counts the robot as settled early when it is
+// slowing towards the target hard enough to come to rest within range inside
+// the horizon, from the speed it is given and how fast that is falling
+class SettleCondition {
+ public:
+  explicit SettleCondition(SettleSettings settings) : settings(settings) {}
+
+  // `speed` is how fast the robot is moving in the motion's units per
+  // second, either way. True once it has settled
+  bool update(float error, float speed);
+  bool getExit() const { return done; }
+  void reset();
+
+ private:
+  SettleSettings settings;
+  // how fast the speed is falling, filtered, per second
+  float deceleration = 0;
+  float prevError = 0;
+  float prevSpeed = 0;
+  std::uint32_t prevTime = 0;
+  bool started = false;
+  // the robot has been faster than the stopped speed this motion
+  bool moved = false;
+  std::uint32_t since = 0;
+  bool settling = false;
+  bool done = false;
+};
+}  // namespace motion
+
+#endif
@@ -0,0 +1,80 @@
+#include "lemlib/pose.hpp"    // IWYU pragma: keep
+#include "motion/profile.h"   // IWYU pragma: keep
+#include "path/binaryPath.h"  // IWYU pragma: keep
+
+#ifndef MOTION_TIMED_PATH_H
+#define MOTION_TIMED_PATH_H
+
+#include <cstddef>
+#include <vector>
+
+namespace motion {
+// A path with the speed to drive every point of it worked out ahead of time,
+// for Chassis::follow to track by time instead of steering at whatever point
+// the lookahead circle crosses. Made once, such as in initialize, since making
+// one walks the whole path three times; following it after that only looks at
+// the points near the robot, which it finds from where the robot was the last
+// time, so a follow step costs about the same however long the path is.
+//
+// Each point's speed is the slowest of: the constraints' top speed; the speed
+// the outer wheel can reach on the path's curvature; the speed that keeps the
+// sideways acceleration around the curve under the constraints' acceleration;
+// and the speed it can accelerate to from the start and still stop by the end.
+// Jerk is not limited. The path's own speeds are motor power for LemLib's
+// follow, so they are only used to end the path at its first point with a
+// speed of 0, the same as LemLib's follow does
+//
+//   motion::TimedPath route(path::BinaryPath(example_path), {48, 120},
+//                           drivetrain.trackWidth);
+//   chassis.follow(route, 4000);
+class TimedPath {
+ public:
+  struct Point {
+    float x;
+    float y;
+    float distance;     // inches along the path from the first point
+    float curvature;    // 1/inches, positive turning clockwise
+    float velocity;     // in/s
+    float acceleration; // in/s^2 from this point to the next
+    float time;         // s from the start of the path
+  };
+
+  TimedPath(const path::BinaryPath &path, const Constraints &constraints,
+            float trackWidth);
+  // from LemLib's path text, such as a path from a path::Tarball, with the
+  // curvature at each point from lemlib::getCurvature
+  TimedPath(const asset &text, const Constraints &constraints,
+            float trackWidth);
+
+  bool empty() const { return points.empty(); }
+  std::size_t size() const { return points.size(); }
+  const Point &operator[](std::size_t index) const { return points[index]; }
+  float getDuration() const { return empty() ? 0 : points.back().time; }
+  float getLength() const { return empty() ? 0 : points.back().distance; }
+
+  // Where the profile is at a time, clamped to the ends of the path. `hint`
+  // is the index the last sample was found at, and is moved to this one;
+  // sampling later and later times only steps forwards from it
+  ProfileState sample(float time, std::size_t &hint) const;
+  // The index of the closest point to the robot, looking forwards from
+  // `from` for as long as the points get closer. The robot only moves on
+  // along the path, so the search starts where the last one ended
+  std::size_t closest(const lemlib::Pose &pose, std::size_t from) const;
+  // how far along the path the robot is, past the point at `index`
+  float progress(const lemlib::Pose &pose, std::size_t index) const;
+  // The point at a distance along the path, facing along it in standard
+  // radians. Past the end, the line of the last segment carries on. `hint`
+  // works the same as it does for sample, and is left at the segment the
+  // point is on
+  lemlib::Pose pointAt(float distance, std::size_t &hint) const;
+
+ private:
+  // works out the velocity, acceleration and time of points whose position,
+  // distance and curvature are set, with their speed limits as velocity
+  void parameterize(const Constraints &constraints, float trackWidth);
+
+  std::vector<Point> points;
+};
+}  // namespace motion
+
+#endif
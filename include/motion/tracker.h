@@ -0,0 +1,95 @@
+#include "lemlib/pose.hpp"  // IWYU pragma: keep
+
+#ifndef MOTION_TRACKER_H
+#define MOTION_TRACKER_H
+
+#include <cstddef>
+
+namespace motion {
+// how Chassis::follow steers along a TimedPath
+enum class Tracker {
+  PurePursuit, // at the point a lookahead distance further along the path
+  Ramsete,     // see Ramsete
+  Ltv          // see LtvUnicycle
+};
+
+// Where a trajectory has the robot at one moment. Poses here are in standard
+// radians, counterclockwise from +x, and turning counterclockwise is positive
+struct Reference {
+  lemlib::Pose pose;
+  float velocity;        // in/s
+  float angularVelocity; // rad/s
+};
+
+// what a tracker wants the robot to do next
+struct Command {
+  float velocity;        // in/s
+  float angularVelocity; // rad/s
+};
+
+// The robot's error from a reference, in the robot's frame: ahead, to the
+// left, and counterclockwise
+struct TrackingError {
+  float x;     // in
+  float y;     // in
+  float theta; // rad
+
+  TrackingError(const lemlib::Pose &pose, const Reference &reference);
+};
+
+// The nonlinear unicycle controller from Controls Engineering in FRC. Drives
+// the reference's velocities, plus corrections for the error that grow with
+// the reference's speed, so the robot converges on the trajectory from any
+// error that is not behind it. `b` is how hard it corrects, in 1/in^2, and
+// `zeta` damps the correction, from 0 to 1. The defaults are the usual 2 and
+// 0.7 in meters
+class Ramsete {
+ public:
+  explicit Ramsete(float b = 0.00129, float zeta = 0.7) : b(b), zeta(zeta) {}
+
+  Command calculate(const lemlib::Pose &pose, const Reference &reference) const;
+
+ private:
+  float b;
+  float zeta;
+};
+
+// How much error LtvUnicycle accepts and how hard it may correct it
+struct LtvTolerances {
+  float x = 2.5;             // in
+  float y = 5;               // in
+  float theta = 2;           // rad
+  float velocity = 40;       // in/s
+  float angularVelocity = 2; // rad/s
+};
+
+// Linear time-varying unicycle controller: LQR on the unicycle linearized
+// about the reference, whose gains depend only on the reference's velocity.
+// The gains are worked out when the controller is made, for every
+// `velocityStep` in/s up to `maxVelocity`, and looked up after that. The
+// tolerances weigh the error and the correction against each other with
+// Bryson's rule: the largest error in each direction the robot should accept,
+// and the largest correction it should make. The defaults are WPILib's
+class LtvUnicycle {
+ public:
+  explicit LtvUnicycle(LtvTolerances tolerances = {}, float period = 0.01,
+                       float maxVelocity = 80, float velocityStep = 2);
+
+  Command calculate(const lemlib::Pose &pose, const Reference &reference) const;
+
+ private:
+  // correction per unit of error, from the x, y and theta error to the
+  // velocity and angular velocity
+  struct Gain {
+    float k[2][3];
+  };
+
+  static constexpr std::size_t kGains = 64;
+
+  Gain gains[kGains];
+  std::size_t count = 0;
+  float velocityStep;
+};
+}  // namespace motion
+
+#endif
@@ -0,0 +1,85 @@
+#include "lemlib/pose.hpp"      // IWYU pragma: keep
+#include "odom/estimator.h"    // IWYU pragma: keep
+#include "odom/sensorFrame.h"  // IWYU pragma: keep
+
+#ifndef ODOM_EKF_H
+#define ODOM_EKF_H
+
+#include <cstdint>
+
+namespace odom {
+// How much the EKF trusts each sensor, as one standard deviation
+struct EkfNoise {
+  // fraction of the distance the wheels report that may be slip
+  float wheelSlip = 0.02;
+  // extra slip fraction per g the drive encoders' acceleration disagrees with
+  // the IMU's, which is what a wheel breaking traction looks like
+  float slipPerG = 0.5;
+  // rad of heading random walk per root second of gyro integration
+  float gyroNoise = 0.0005;
+  // rad/s of gyro bias random walk per root second
+  float gyroBiasDrift = 0.0001;
+  // fraction of a turn the drive encoders misjudge through scrub, when there
+  // is no IMU
+  float encoderHeading = 0.05;
+  // degrees of GPS heading error. Position error comes from the GPS itself
+  float gpsHeading = 2;
+};
+
+// Extended Kalman filter over the pose and the IMU's gyro bias. Wheel travel
+// and IMU rotation drive the prediction: the motor encoders and horizontal
+// wheel give the distance, the gyro the heading, less its estimated bias.
+// Whenever the wheels are still the robot cannot be turning, so whatever the
+// gyro reads then is bias. The IMU's acceleration inflates the uncertainty
+// while the wheels slip, and GPS fixes correct the pose directly, weighted by
+// the error the GPS reports. GPS fixes are in field coordinates, so setPose
+// must use them too; fixes more than five standard deviations from the
+// estimate are rejected as the GPS misreading the field. Without an IMU it
+// falls back to the drive encoders for heading, and without a GPS it is dead
+// reckoning with a calibrated gyro
+class Ekf : public Estimator {
+ public:
+  Ekf(float trackWidth, float horizontalOffset, EkfNoise noise = {});
+
+  void reset(const SensorFrame &frame) override;
+  void setPose(lemlib::Pose pose) override;
+  lemlib::Pose update(const SensorFrame &frame) override;
+
+  lemlib::Pose getPose() const override;
+  lemlib::Pose getSpeed() const override { return speed; }
+  lemlib::Pose getLocalSpeed() const override { return localSpeed; }
+
+  // rad/s the gyro is estimated to read when still
+  float getGyroBias() const { return state[kBias]; }
+  // standard deviation of the estimate of each state, in inches and radians
+  lemlib::Pose getUncertainty() const;
+
+ private:
+  enum Index { kX, kY, kTheta, kBias, kStates };
+
+  void predict(const SensorFrame &frame, double dt);
+  // corrects state `index` with a measurement `innovation` away from it and
+  // `variance` uncertain. Returns false if the measurement was rejected
+  bool correct(int index, double innovation, double variance);
+
+  float trackWidth;
+  float horizontalOffset;
+  EkfNoise noise;
+  SensorFrame last;
+  // forward speed the drive encoders measured last update, in/s
+  double lastForward = 0;
+  // us timestamp of the last frame any wheel turned in
+  std::uint64_t movedAt = 0;
+  double state[kStates] = {};
+  double covariance[kStates][kStates] = {};
+  // the last GPS fix taken in, so the repeats between its reports are not
+  // counted again
+  double lastGpsX = 0;
+  double lastGpsY = 0;
+  double lastGpsHeading = 0;
+  lemlib::Pose speed = {0, 0, 0};
+  lemlib::Pose localSpeed = {0, 0, 0};
+};
+}  // namespace odom
+
+#endif
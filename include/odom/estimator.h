@@ -0,0 +1,29 @@
+#include "lemlib/pose.hpp"      // IWYU pragma: keep
+#include "odom/sensorFrame.h"  // IWYU pragma: keep
+
+#ifndef ODOM_ESTIMATOR_H
+#define ODOM_ESTIMATOR_H
+
+namespace odom {
+// Turns sensor frames into a pose. The odometry scheduler owns the only call
+// site, so implementations need not be thread safe. Poses are in LemLib's
+// frame, with theta in radians
+class Estimator {
+ public:
+  virtual ~Estimator() = default;
+
+  // starts measuring from `frame` without moving
+  virtual void reset(const SensorFrame &frame) = 0;
+  // moves the estimate to `pose`, which is taken as known exactly
+  virtual void setPose(lemlib::Pose pose) = 0;
+  // the pose after taking in the next frame
+  virtual lemlib::Pose update(const SensorFrame &frame) = 0;
+
+  virtual lemlib::Pose getPose() const = 0;
+  // in inches and radians per second
+  virtual lemlib::Pose getSpeed() const = 0;
+  virtual lemlib::Pose getLocalSpeed() const = 0;
+};
+}  // namespace odom
+
+#endif
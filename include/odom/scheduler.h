@@ -0,0 +1,109 @@
+#include "lemlib/pose.hpp"        // IWYU pragma: keep
+#include "odom/estimator.h"       // IWYU pragma: keep
+#include "odom/sensorFrame.h"     // IWYU pragma: keep
+#include "odom/tracker.h"         // IWYU pragma: keep
+#include "pros/rtos.hpp"          // IWYU pragma: keep
+#include "telemetry/histogram.h"  // IWYU pragma: keep
+#include "util/seqlock.h"         // IWYU pragma: keep
+
+#ifndef ODOM_SCHEDULER_H
+#define ODOM_SCHEDULER_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace odom {
+// how long odometry updates take and how far apart they start, in us
+struct Timing {
+  telemetry::Summary execution;
+  telemetry::Summary jitter; // distance of each period from the nominal one
+};
+
+// Where the robot was at the end of one odometry update. Lengths are in
+// inches and angles in the unit the sample was asked for
+struct PoseSample {
+  std::uint64_t time = 0; // us when the sensors behind it were read
+  lemlib::Pose pose = {0, 0, 0};
+  lemlib::Pose velocity = {0, 0, 0};      // field frame, per second
+  lemlib::Pose localVelocity = {0, 0, 0}; // robot frame, per second
+};
+
+// Runs odometry on a task of its own at a fixed rate, in place of the task
+// LemLib starts from Chassis::calibrate, and measures how well it keeps that
+// rate. The odometry task is the only writer of the pose: each update reads
+// one sensor frame, hands it to the estimator, mirrors it into LemLib for the
+// chassis motions, and publishes the pose and frame through seqlocks that
+// readers never block on
+class Scheduler {
+ public:
+  // `estimator` is only used from the odometry task once it has started
+  Scheduler(SensorReader &reader, Estimator &estimator,
+            std::uint32_t period = 10);
+
+  // Calibrates the IMU, zeroes the encoders and starts updating. Used in place
+  // of Chassis::calibrate. Updates pause while the sensors calibrate
+  void calibrate();
+
+  // ms between updates. Takes effect from the next update
+  void setPeriod(std::uint32_t period);
+  std::uint32_t getPeriod() const { return period; }
+
+  void start();
+  void stop();
+
+  // the latest pose, from any task, without blocking
+  PoseSample getPose(bool radians = false) const;
+  // Moves the robot to `pose`. LemLib's pose moves straight away; getPose
+  // follows from the next update. Use in place of Chassis::setPose, from one
+  // task at a time
+  void setPose(lemlib::Pose pose, bool radians = false);
+
+  // Where the robot will be `seconds` from now, extrapolated from the latest
+  // pose and however old it already is
+  lemlib::Pose estimatePose(float seconds, bool radians = false) const;
+
+  // The latest pose extrapolated forward by the measured actuation latency:
+  // where the robot will be when a command sent now takes effect, rather than
+  // where it was when the sensors were read. For motions to control against,
+  // see motion::Chassis::setLatencyCompensation. The pose mirrored into
+  // LemLib, and getPose, stay as measured
+  lemlib::Pose getCompensatedPose(bool radians = false) const;
+  // ms a motor takes to act on a command. It waits for the next 5 ms device
+  // packet, so about 3 on average
+  void setCommandLatency(std::uint32_t commandLatency);
+  // The latency compensated for, in seconds: how old the sensor data was, how
+  // long the update took, the mean wait until a motion reads the pose, and
+  // the command latency
+  float getLatency() const { return latency; }
+
+  // the frame the last update used
+  SensorFrame frame() const { return frames.read(); }
+
+  Timing timing() const;
+  void resetTiming();
+  // writes the timing summary to the telemetry log
+  void logTiming() const;
+
+ private:
+  void run();
+
+  SensorReader &reader;
+  Estimator &estimator;
+  util::Seqlock<PoseSample> poses;
+  util::Seqlock<SensorFrame> frames;
+  // pose requested by setPose, picked up by the next update when its version
+  // changes
+  util::Seqlock<lemlib::Pose> requested{lemlib::Pose(0, 0, 0)};
+  std::uint32_t requestHandled;
+
+  std::atomic<std::uint32_t> period;
+  std::atomic<std::uint32_t> commandLatency{3};
+  std::atomic<float> latency{0};
+  std::atomic<bool> running{false};
+  pros::Task *task = nullptr;
+  telemetry::Histogram execution;
+  telemetry::Histogram jitter;
+};
+}  // namespace odom
+
+#endif
@@ -0,0 +1,99 @@
+#include "lemlib/chassis/chassis.hpp"  // IWYU pragma: keep
+#include "pros/gps.hpp"                // IWYU pragma: keep
+#include "pros/imu.hpp"                // IWYU pragma: keep
+#include "pros/motor_group.hpp"        // IWYU pragma: keep
+#include "pros/rotation.hpp"           // IWYU pragma: keep
+
+#ifndef ODOM_SENSOR_FRAME_H
+#define ODOM_SENSOR_FRAME_H
+
+#include <cstdint>
+
+namespace odom {
+constexpr int kMaxSideMotors = 4;
+
+// Every drivetrain sensor, read once in one tick. Odometry, motion, the screen
+// and logging all work from the same frame, so they agree on the robot's
+// state and the devices are only asked once
+struct SensorFrame {
+  std::uint64_t time = 0; // us when the frame was read
+
+  // raw encoder counts of each drive motor, and the ms timestamp of the
+  // motors' last report
+  std::int32_t leftRaw[kMaxSideMotors] = {};
+  std::int32_t rightRaw[kMaxSideMotors] = {};
+  std::uint32_t leftTimestamp = 0;
+  std::uint32_t rightTimestamp = 0;
+  // inches each side has travelled since the encoders were tared, averaged
+  // over its motors
+  double left = 0;
+  double right = 0;
+
+  // inches the horizontal tracking wheel has travelled
+  double horizontal = 0;
+
+  // degrees, clockwise. Only meaningful while imuValid is set
+  bool imuValid = false;
+  double imuRotation = 0;
+  double imuHeading = 0;
+  pros::imu_accel_s_t imuAccel = {};
+
+  // field position in inches from the field center and heading in degrees,
+  // clockwise from +y, with the sensor's own estimate of its position error
+  // in inches. Only meaningful while gpsValid is set
+  bool gpsValid = false;
+  double gpsX = 0;
+  double gpsY = 0;
+  double gpsHeading = 0;
+  double gpsError = 0;
+};
+
+// Reads the sensors odometry uses into a SensorFrame
+class SensorReader {
+ public:
+  // `horizontal`, `imu` and `gps` may be nullptr. The horizontal wheel is
+  // `horizontalOffset` inches behind the tracking center. The GPS must have
+  // its offset set so it reports the tracking center
+  SensorReader(const lemlib::Drivetrain &drivetrain,
+               pros::Rotation *horizontal,
+               float horizontalDiameter,
+               float horizontalOffset,
+               pros::Imu *imu,
+               pros::Gps *gps = nullptr);
+
+  SensorFrame read();
+  // zeroes every encoder
+  void tare();
+
+  pros::Imu *getImu() const { return imu; }
+  float getTrackWidth() const { return trackWidth; }
+  float getHorizontalOffset() const { return horizontalOffset; }
+
+ private:
+  // reads a side's motors one by one, so a tick does not allocate
+  double readSide(pros::MotorGroup *motors,
+                  const std::int32_t *zero,
+                  double inchesPerCount,
+                  std::int32_t *raw,
+                  std::uint32_t *timestamp);
+
+  pros::MotorGroup *leftMotors;
+  pros::MotorGroup *rightMotors;
+  float trackWidth;
+  float wheelDiameter;
+  float rpm;
+  pros::Rotation *horizontal;
+  float horizontalDiameter;
+  float horizontalOffset;
+  pros::Imu *imu;
+  pros::Gps *gps;
+  // raw counts of each motor when the encoders were tared
+  std::int32_t leftZero[kMaxSideMotors] = {};
+  std::int32_t rightZero[kMaxSideMotors] = {};
+  // depends on the cartridges, so it is found when the encoders are tared
+  double leftInchesPerCount = 0;
+  double rightInchesPerCount = 0;
+};
+}  // namespace odom
+
+#endif
@@ -0,0 +1,40 @@
+#include "lemlib/pose.hpp"      // IWYU pragma: keep
+#include "odom/estimator.h"    // IWYU pragma: keep
+#include "odom/sensorFrame.h"  // IWYU pragma: keep
+
+#ifndef ODOM_TRACKER_H
+#define ODOM_TRACKER_H
+
+namespace odom {
+// Dead reckoning from sensor frames, with the same arc model as LemLib. The
+// IMU gives the heading when it can, otherwise the difference between the
+// sides does; the average of the sides and the horizontal wheel give the
+// distance
+class Tracker : public Estimator {
+ public:
+  Tracker(float trackWidth, float horizontalOffset);
+
+  void reset(const SensorFrame &frame) override;
+  void setPose(lemlib::Pose pose) override { this->pose = pose; }
+  lemlib::Pose update(const SensorFrame &frame) override;
+
+  lemlib::Pose getPose() const override { return pose; }
+  lemlib::Pose getSpeed() const override { return speed; }
+  lemlib::Pose getLocalSpeed() const override { return localSpeed; }
+
+ private:
+  float trackWidth;
+  float horizontalOffset;
+  SensorFrame last;
+  lemlib::Pose pose = {0, 0, 0};
+  lemlib::Pose speed = {0, 0, 0};
+  lemlib::Pose localSpeed = {0, 0, 0};
+};
+
+// Where a robot at `pose` moving at `localVelocity` will be after `seconds`,
+// following the arc it is on, the same as lemlib::estimatePose
+lemlib::Pose extrapolate(lemlib::Pose pose, lemlib::Pose localVelocity,
+                         float seconds);
+}  // namespace odom
+
+#endif
@@ -0,0 +1,59 @@
+#include "lemlib/asset.hpp"  // IWYU pragma: keep
+
+#ifndef PATH_BINARY_PATH_H
+#define PATH_BINARY_PATH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace path {
+// "PATH", little endian
+constexpr std::uint32_t kMagic = 0x48544150;
+constexpr std::uint16_t kVersion = 1;
+
+// A path asset starts with a header and is followed by `count` points. Both
+// are packed little endian, the same as the brain
+struct __attribute__((__packed__)) Header {
+  std::uint32_t magic;
+  std::uint16_t version;
+  std::uint16_t pointSize; // bytes per point, so readers can check the layout
+  std::uint32_t count;
+  float length; // inches along the whole path
+};
+
+struct __attribute__((__packed__)) Point {
+  float x;         // inches
+  float y;         // inches
+  float speed;     // out of 127, the same as LemLib's path text
+  float distance;  // inches along the path from the first point
+  float curvature; // 1/inches, positive turning clockwise
+};
+
+// A path converted from LemLib's path text by tools/pathConverter.cpp, read in
+// place from its asset. Nothing is parsed or copied up front, so opening a
+// path takes the same time however long it is. Assets are not aligned, so
+// points are copied out one at a time rather than referenced
+class BinaryPath {
+ public:
+  // an empty path if the asset is not a path this version understands
+  explicit BinaryPath(const asset &file);
+
+  bool empty() const { return count == 0; }
+  std::size_t size() const { return count; }
+  float length() const { return pathLength; }
+
+  Point operator[](std::size_t index) const {
+    Point point;
+    std::memcpy(&point, points + index * sizeof(Point), sizeof(Point));
+    return point;
+  }
+
+ private:
+  const std::uint8_t *points = nullptr;
+  std::size_t count = 0;
+  float pathLength = 0;
+};
+}  // namespace path
+
+#endif
@@ -0,0 +1,64 @@
+#include "lemlib/pose.hpp"    // IWYU pragma: keep
+#include "path/binaryPath.h"  // IWYU pragma: keep
+
+#ifndef PATH_PATH_INDEX_H
+#define PATH_PATH_INDEX_H
+
+#include <cstddef>
+#include <vector>
+
+namespace path {
+// Pure pursuit's searches over a path, kept from one control step to the
+// next. LemLib looks through the whole path for the closest point every step,
+// and through the rest of it for the lookahead circle, so a step costs more
+// the longer the path is. Here both only look at the points up to `window`
+// inches along the path from where the last step found them, which bounds a
+// step however long the path is.
+//
+// A robot further than `window` from every point it looked at has left the
+// path, such as by being pushed, and the closest point is looked for over the
+// whole path instead. That search goes through a tree of boxes around runs of
+// points, made once with the index, so that no step allocates
+class PathIndex {
+ public:
+  explicit PathIndex(BinaryPath path, float window = 24);
+
+  // the index of the point closest to the robot
+  std::size_t closest(const lemlib::Pose &pose);
+  // The point where the path leaves a circle around the robot, at or past
+  // both the closest point and the last lookahead, with the index of the
+  // segment it is on as theta. The last lookahead if the path does not
+  // cross the circle within the window
+  lemlib::Pose lookahead(const lemlib::Pose &pose, float radius);
+
+  const BinaryPath &getPath() const { return path; }
+  // how many times the robot had left the path
+  std::size_t getFallbacks() const { return fallbacks; }
+
+ private:
+  struct Box {
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+
+    float squaredDistance(const lemlib::Pose &pose) const;
+  };
+
+  // the closest point over the whole path
+  std::size_t nearest(const lemlib::Pose &pose);
+  void build();
+
+  BinaryPath path;
+  float window;
+  std::size_t last = 0;
+  lemlib::Pose lastLookahead = {0, 0, 0};
+  // a box around every kLeaf points, and one around every pair of boxes
+  // above them, with node i's children at 2i and 2i + 1
+  std::vector<Box> boxes;
+  std::size_t leaves = 0;
+  std::size_t fallbacks = 0;
+};
+}  // namespace path
+
+#endif
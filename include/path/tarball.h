@@ -0,0 +1,48 @@
+#include "lemlib/asset.hpp"  // IWYU pragma: keep
+
+#ifndef PATH_TARBALL_H
+#define PATH_TARBALL_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace path {
+// An index over a LemLib path tarball, the file path.jerryio exports with
+// several paths in one asset. Used in place of lemlib_tarball::Decoder: the
+// tarball is scanned once, when the index is made, and lookups binary search
+// the names after that. Names and paths point into the tarball itself, so
+// nothing is copied but the index
+//
+//   ASSET(paths_txt);
+//   path::Tarball paths(paths_txt);
+//   chassis.follow(paths["Path 1"], 15, 4000);
+class Tarball {
+ public:
+  explicit Tarball(const asset &tarball);
+
+  bool has(std::string_view name) const { return find(name) != nullptr; }
+  // the named path's text, ready for Chassis::follow, or an empty asset if
+  // there is no such path
+  asset get(std::string_view name) const;
+  asset operator[](std::string_view name) const { return get(name); }
+
+  std::size_t size() const { return entries.size(); }
+  // names in sorted order
+  std::string_view name(std::size_t index) const {
+    return entries[index].name;
+  }
+
+ private:
+  struct Entry {
+    std::string_view name;
+    asset points;
+  };
+
+  const Entry *find(std::string_view name) const;
+
+  std::vector<Entry> entries; // sorted by name
+};
+}  // namespace path
+
+#endif
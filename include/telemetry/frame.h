@@ -0,0 +1,196 @@
+#include "telemetry/schema.h"  // IWYU pragma: keep
+
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Binary telemetry frames. A frame is one channel's sample:
+//
+//   0x00, COBS(header, time, payload, crc), 0x00
+//
+// header  channel id in the low 7 bits. The top bit is set when time is ms
+//         since the program started, and clear when it is ms since the
+//         channel's previous frame
+// time    unsigned LEB128
+// payload the channel's fields in schema order, see telemetry/schema.h
+// crc     CRC-8, polynomial 0x07, of everything before it
+//
+// COBS leaves no zero bytes inside a frame, so zeros only ever delimit frames.
+// Frames share the serial link with text, so each one is delimited on both
+// sides: whatever lies between two zeros is either a whole frame or text
+namespace telemetry {
+constexpr std::uint8_t kAbsoluteTime = 0x80;
+// longest unencoded frame: header, 5 byte time, 64 byte payload and crc
+constexpr std::size_t kMaxFrame = 1 + 5 + 64 + 1;
+// longest frame on the link: COBS adds a byte per 254, plus the delimiters
+constexpr std::size_t kMaxEncodedFrame = kMaxFrame + kMaxFrame / 254 + 1 + 2;
+
+inline std::uint8_t crc8(const std::uint8_t *data, std::size_t size) {
+  std::uint8_t crc = 0;
+  for (std::size_t i = 0; i < size; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = crc & 0x80 ? std::uint8_t((crc << 1) ^ 0x07) : std::uint8_t(crc << 1);
+    }
+  }
+  return crc;
+}
+
+// Stuffs `size` bytes into `out`, which needs room for size + size / 254 + 1,
+// and returns the encoded size. Adds no delimiters
+inline std::size_t cobsEncode(const std::uint8_t *in, std::size_t size,
+                              std::uint8_t *out) {
+  std::size_t code = 0; // where the current block's length byte goes
+  std::size_t written = 1;
+  std::uint8_t length = 1;
+  for (std::size_t i = 0; i < size; i++) {
+    if (in[i] != 0) {
+      out[written++] = in[i];
+      length++;
+    }
+    if (in[i] == 0 || length == 0xff) {
+      out[code] = length;
+      code = written++;
+      length = 1;
+    }
+  }
+  out[code] = length;
+  return written;
+}
+
+// Unstuffs `size` bytes into `out`, which needs room for `size`. Returns the
+// decoded size, or 0 if the bytes are not COBS
+inline std::size_t cobsDecode(const std::uint8_t *in, std::size_t size,
+                              std::uint8_t *out) {
+  std::size_t written = 0;
+  std::size_t i = 0;
+  while (i < size) {
+    std::uint8_t length = in[i++];
+    if (length == 0 || i + length - 1 > size) return 0;
+    for (std::uint8_t j = 1; j < length; j++) out[written++] = in[i++];
+    if (length != 0xff && i < size) out[written++] = 0;
+  }
+  return written;
+}
+
+inline std::size_t putVarint(std::uint32_t value, std::uint8_t *out) {
+  std::size_t size = 0;
+  do {
+    std::uint8_t byte = value & 0x7f;
+    value >>= 7;
+    out[size++] = value != 0 ? byte | 0x80 : byte;
+  } while (value != 0);
+  return size;
+}
+
+// 0 if the varint runs past `size`
+inline std::size_t getVarint(const std::uint8_t *in, std::size_t size,
+                             std::uint32_t &value) {
+  value = 0;
+  for (std::size_t i = 0; i < size && i < 5; i++) {
+    value |= std::uint32_t(in[i] & 0x7f) << (7 * i);
+    if ((in[i] & 0x80) == 0) return i + 1;
+  }
+  return 0;
+}
+
+// Writes one field little endian and returns its size. Integer fields
+// saturate rather than wrap
+inline std::size_t putField(const Field &field, float value, std::uint8_t *out) {
+  float scaled = value * field.scale;
+  switch (field.type) {
+    case FieldType::I16: {
+      std::int16_t stored = std::int16_t(
+          std::lround(std::fmax(-32768.0f, std::fmin(32767.0f, scaled))));
+      std::memcpy(out, &stored, 2);
+      return 2;
+    }
+    case FieldType::I32: {
+      std::int32_t stored = std::int32_t(
+          std::llround(std::fmax(-2147483648.0f, std::fmin(2147483520.0f, scaled))));
+      std::memcpy(out, &stored, 4);
+      return 4;
+    }
+    case FieldType::F32: std::memcpy(out, &scaled, 4); return 4;
+  }
+  return 0;
+}
+
+inline float getField(const Field &field, const std::uint8_t *in) {
+  switch (field.type) {
+    case FieldType::I16: {
+      std::int16_t stored;
+      std::memcpy(&stored, in, 2);
+      return stored / field.scale;
+    }
+    case FieldType::I32: {
+      std::int32_t stored;
+      std::memcpy(&stored, in, 4);
+      return stored / field.scale;
+    }
+    case FieldType::F32: {
+      float stored;
+      std::memcpy(&stored, in, 4);
+      return stored / field.scale;
+    }
+  }
+  return 0;
+}
+
+// Encodes one sample of `schema`, delimiters included, into `out`, which needs
+// room for kMaxEncodedFrame bytes. Returns the frame's size
+inline std::size_t encodeFrame(const Schema &schema, bool absolute,
+                               std::uint32_t time, const float *values,
+                               std::uint8_t *out) {
+  std::uint8_t raw[kMaxFrame];
+  std::size_t size = 0;
+  raw[size++] = absolute ? schema.id | kAbsoluteTime : schema.id;
+  size += putVarint(time, raw + size);
+  for (std::size_t i = 0; i < schema.count; i++) {
+    size += putField(schema.fields[i], values[i], raw + size);
+  }
+  raw[size] = crc8(raw, size);
+  size++;
+
+  out[0] = 0;
+  std::size_t encoded = 1 + cobsEncode(raw, size, out + 1);
+  out[encoded++] = 0;
+  return encoded;
+}
+
+// one decoded frame
+struct Frame {
+  const Schema *schema;
+  bool absolute; // time is since the program started, not the last frame
+  std::uint32_t time;
+  float values[16];
+};
+
+// Decodes the bytes between two delimiters. False for anything that is not a
+// whole frame of a known channel, such as text
+inline bool decodeFrame(const std::uint8_t *in, std::size_t size, Frame &frame) {
+  std::uint8_t raw[kMaxFrame + kMaxFrame / 254 + 1];
+  if (size == 0 || size > kMaxFrame + kMaxFrame / 254 + 1) return false;
+  std::size_t length = cobsDecode(in, size, raw);
+  if (length < 3 || crc8(raw, length - 1) != raw[length - 1]) return false;
+  frame.schema = findSchema(raw[0] & ~kAbsoluteTime);
+  if (frame.schema == nullptr) return false;
+  frame.absolute = raw[0] & kAbsoluteTime;
+  std::size_t read = 1;
+  std::size_t timeSize = getVarint(raw + read, length - 1 - read, frame.time);
+  if (timeSize == 0) return false;
+  read += timeSize;
+  if (length - 1 - read != payloadSize(*frame.schema)) return false;
+  for (std::size_t i = 0; i < frame.schema->count; i++) {
+    frame.values[i] = getField(frame.schema->fields[i], raw + read);
+    read += fieldSize(frame.schema->fields[i].type);
+  }
+  return true;
+}
+}  // namespace telemetry
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef TELEMETRY_HISTOGRAM_H
+#define TELEMETRY_HISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace telemetry {
+// summary of the samples in a histogram, in the units they were recorded in
+struct Summary {
+  std::uint32_t count;
+  std::uint32_t min;
+  std::uint32_t max;
+  std::uint32_t p99;
+  double mean;
+};
+
+// Fixed-width bucket histogram for timing measurements. One task records into
+// it while any other reads it, without either taking a lock. Samples past the
+// last bucket are counted in an overflow bucket
+class Histogram {
+ public:
+  static constexpr std::uint32_t kBucketWidth = 10;
+  static constexpr std::uint32_t kBuckets = 1000;
+
+  // only one task may record at a time
+  void record(std::uint32_t value);
+
+  // readers may see a sample that is still being recorded only partly counted
+  Summary summary() const;
+  void reset();
+
+ private:
+  std::atomic<std::uint32_t> buckets[kBuckets + 1] = {};
+  std::atomic<std::uint32_t> count{0};
+  std::atomic<std::uint32_t> min{UINT32_MAX};
+  std::atomic<std::uint32_t> max{0};
+  std::atomic<std::uint64_t> sum{0};
+};
+}  // namespace telemetry
+
+#endif
@@ -0,0 +1,117 @@
+#include "lemlib/logger/logger.hpp"  // IWYU pragma: keep
+#include "pros/rtos.hpp"              // IWYU pragma: keep
+#include "util/byteRing.h"            // IWYU pragma: keep
+
+#ifndef TELEMETRY_LOG_H
+#define TELEMETRY_LOG_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace telemetry {
+constexpr std::size_t kLogBytes = 4096;
+// longest line, framing included. Longer lines are cut short
+constexpr std::size_t kLogLineSize = 160;
+
+// where the log's lines go
+struct Output {
+  // bytes the channel can take now without blocking the draining task, or
+  // as near as the channel can tell, see kStdout
+  std::size_t (*space)();
+  void (*write)(const char *bytes, std::size_t size);
+};
+
+// A logger that is safe to call from control loops, in place of LemLib's
+// sinks. The format string is checked at compile time and each line is
+// formatted on the caller's stack and copied into a lock-free ring, so logging
+// never allocates or waits on a mutex. Any number of tasks may log; a low
+// priority task, or whoever calls drain, writes the lines out in batches as
+// large as the output can take. What happens to lines logged while the ring
+// is full is up to its overflow policy
+class Log {
+ public:
+  // every line is framed by `prefix` and `suffix`
+  Log(Output output, const char *prefix = "", const char *suffix = "\n",
+      util::Overflow overflow = util::Overflow::DropNewest,
+      lemlib::Level lowestLevel = lemlib::Level::INFO);
+
+  // false if the line was filtered out or dropped
+  template <typename... T>
+  bool log(lemlib::Level level, fmt::format_string<T...> format, T &&...args) {
+    if (level < lowestLevel) return false;
+    char line[kLogLineSize];
+    std::size_t room = kLogLineSize - prefixSize - suffixSize;
+    std::memcpy(line, prefix, prefixSize);
+    auto result = fmt::format_to_n(line + prefixSize, room, format,
+                                   std::forward<T>(args)...);
+    std::size_t size = prefixSize + std::min(result.size, room);
+    std::memcpy(line + size, suffix, suffixSize);
+    return ring.push(line, size + suffixSize);
+  }
+
+  template <typename... T>
+  bool debug(fmt::format_string<T...> format, T &&...args) {
+    return log(lemlib::Level::DEBUG, format, std::forward<T>(args)...);
+  }
+  template <typename... T>
+  bool info(fmt::format_string<T...> format, T &&...args) {
+    return log(lemlib::Level::INFO, format, std::forward<T>(args)...);
+  }
+  template <typename... T>
+  bool warn(fmt::format_string<T...> format, T &&...args) {
+    return log(lemlib::Level::WARN, format, std::forward<T>(args)...);
+  }
+  template <typename... T>
+  bool error(fmt::format_string<T...> format, T &&...args) {
+    return log(lemlib::Level::ERROR, format, std::forward<T>(args)...);
+  }
+  template <typename... T>
+  bool fatal(fmt::format_string<T...> format, T &&...args) {
+    return log(lemlib::Level::FATAL, format, std::forward<T>(args)...);
+  }
+
+  // queues bytes exactly as given, such as a binary frame. False if dropped
+  bool write(const void *data, std::size_t size) {
+    return ring.push(data, size);
+  }
+
+  void setLowestLevel(lemlib::Level level) { lowestLevel = level; }
+  void setOverflow(util::Overflow overflow) { ring.setOverflow(overflow); }
+
+  // Writes as many whole lines as the output has space for, oldest first,
+  // and returns how many bytes. Only one task may drain at a time
+  std::size_t drain();
+  // drains every `period` ms on a low priority task until stop() is called
+  void start(std::uint32_t period = 20);
+  void stop();
+
+  // lines lost because the ring was full
+  std::uint32_t getDropped() const { return ring.getDropped(); }
+
+ private:
+  Output output;
+  const char *prefix;
+  const char *suffix;
+  std::size_t prefixSize;
+  std::size_t suffixSize;
+  std::atomic<lemlib::Level> lowestLevel;
+  util::ByteRing<kLogBytes> ring;
+  std::atomic<bool> running{false};
+  pros::Task *task = nullptr;
+};
+
+// The program's standard output. PROS cannot say how much stdout will take
+// without blocking, so its space is a fixed batch of the serial output
+// buffer's size rather than what is free in it, and a drain can block on it
+// while the buffer is full. Drain from the log's own low priority task
+extern const Output kStdout;
+
+// the telemetry log, in place of lemlib::telemetrySink(). Its lines are
+// framed the way LemLib's telemetry sink frames its messages
+Log &telemetryLog();
+}  // namespace telemetry
+
+#endif
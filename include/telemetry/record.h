@@ -0,0 +1,42 @@
+#ifndef TELEMETRY_RECORD_H
+#define TELEMETRY_RECORD_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Recordings on the SD card, written by telemetry::Recorder and read by
+// tools/telemetryDecoder.cpp.
+//
+// A recording file, <name>NNN.tlm, is a run of fixed size blocks. Each block
+// is a header followed by whole frames of telemetry/frame.h, every one with an
+// absolute time, and zero padding. A block can therefore be decoded on its own,
+// and block n starts at n * kBlockSize.
+//
+// Its index, <name>NNN.idx, holds one entry per block so a reader can seek
+// straight to a time. Each entry is written as soon as its block is, so a
+// recording cut off by the power going keeps its index. Where the index is
+// missing or falls short of the file, the block headers carry the same times,
+// and a block cut off part way through is ignored
+namespace telemetry {
+// "TBLK", little endian
+constexpr std::uint32_t kBlockMagic = 0x4b4c4254;
+// a multiple of the card's 512 byte sectors
+constexpr std::size_t kBlockSize = 4096;
+
+struct __attribute__((__packed__)) BlockHeader {
+  std::uint32_t magic;
+  std::uint32_t sequence;  // blocks before this one, counting earlier files
+  std::uint32_t firstTime; // ms of the block's first and last frames
+  std::uint32_t lastTime;
+  std::uint16_t used;   // bytes of frames after the header
+  std::uint16_t frames;
+};
+
+struct __attribute__((__packed__)) IndexEntry {
+  std::uint32_t firstTime;
+  std::uint32_t lastTime;
+  std::uint32_t block; // within its file
+};
+}  // namespace telemetry
+
+#endif
@@ -0,0 +1,74 @@
+#include "pros/rtos.hpp"          // IWYU pragma: keep
+#include "telemetry/frame.h"      // IWYU pragma: keep
+#include "telemetry/record.h"     // IWYU pragma: keep
+#include "util/byteRing.h"        // IWYU pragma: keep
+
+#ifndef TELEMETRY_RECORDER_H
+#define TELEMETRY_RECORDER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+
+namespace telemetry {
+// room for a second or so of full rate samples while the card is busy
+constexpr std::size_t kRecorderBytes = 16384;
+
+// A flight recorder for full rate telemetry, in the format of
+// telemetry/record.h. Any task may send samples: a sample is encoded on the
+// caller's stack and queued in a lock-free ring, which takes the same short
+// time whatever the card is doing. A low priority task packs the queue into
+// blocks and writes them out a block at a time, starting a new file every
+// `fileSize` bytes. Every buffer is allocated when the recorder is made.
+//
+// Samples sent while the queue is full are dropped and counted
+class Recorder {
+ public:
+  // files go in `directory`, which is the SD card on the brain
+  explicit Recorder(const char *directory = "/usd",
+                    std::size_t fileSize = 4 << 20);
+
+  // Starts recording to <directory>/<name>NNN.tlm with the first NNN not in
+  // use, and each later file on the next NNN not in use. Keep names to five
+  // characters so files fit 8.3 names. False if there is no card, or the file
+  // cannot be opened. Recording ends by itself if a later file cannot be
+  bool start(const char *name);
+  // writes out everything queued, then closes the file and its index
+  void stop();
+  bool isRecording() const { return running; }
+
+  // `values` are in the channel's schema order. False if not recording, the
+  // channel is unknown, the count is wrong or the queue is full
+  bool send(std::uint8_t channel, std::initializer_list<float> values);
+
+  // samples lost because the queue was full
+  std::uint32_t getDropped() const { return queue.getDropped(); }
+  // blocks written since the recorder was made
+  std::uint32_t getBlocks() const { return sequence; }
+
+ private:
+  void write();
+  void append(std::uint32_t time, const std::uint8_t *frame, std::size_t size);
+  bool flushBlock();
+  bool openFile(int from);
+  void closeFile();
+
+  const char *directory;
+  std::size_t maxBlocks; // per file
+  char name[8] = {};
+  int number = 0;
+  std::FILE *file = nullptr;
+  util::ByteRing<kRecorderBytes> queue;
+  std::uint8_t block[kBlockSize];
+  BlockHeader header = {};
+  std::FILE *index = nullptr;
+  std::size_t blocks = 0; // written to the current file
+  std::uint32_t sequence = 0;
+  std::atomic<bool> running{false};
+  pros::Task *task = nullptr;
+};
+}  // namespace telemetry
+
+#endif
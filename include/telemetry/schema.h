@@ -0,0 +1,91 @@
+#ifndef TELEMETRY_SCHEMA_H
+#define TELEMETRY_SCHEMA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+namespace telemetry {
+// how a field is stored in a frame, little endian
+enum class FieldType : std::uint8_t { I16, I32, F32 };
+
+// sent as value * scale, rounded for the integer types
+struct Field {
+  const char *name;
+  FieldType type;
+  float scale;
+};
+
+// A typed telemetry channel. Shared by the robot and tools/telemetryDecoder.cpp,
+// so changing a channel's fields means capturing again with the new schema
+struct Schema {
+  std::uint8_t id;
+  const char *name;
+  const Field *fields;
+  std::size_t count;
+};
+
+constexpr std::uint8_t kPoseChannel = 1;
+constexpr std::uint8_t kMotorChannel = 2;
+constexpr std::uint8_t kPidChannel = 3;
+constexpr std::uint8_t kVelocityChannel = 4;
+constexpr std::uint8_t kTemperatureChannel = 5;
+// channel ids are below this
+constexpr std::uint8_t kChannels = 6;
+
+// inches and degrees, to a hundredth
+inline constexpr Field kPoseFields[] = {{"x", FieldType::I16, 100},
+                                        {"y", FieldType::I16, 100},
+                                        {"theta", FieldType::I32, 100}};
+// drive motor current draw in mA, front to back
+inline constexpr Field kMotorFields[] = {
+    {"left1", FieldType::I16, 1},  {"left2", FieldType::I16, 1},
+    {"left3", FieldType::I16, 1},  {"right1", FieldType::I16, 1},
+    {"right2", FieldType::I16, 1}, {"right3", FieldType::I16, 1}};
+// drive motor velocity in rpm, front to back
+inline constexpr Field kVelocityFields[] = {
+    {"left1", FieldType::I16, 1},  {"left2", FieldType::I16, 1},
+    {"left3", FieldType::I16, 1},  {"right1", FieldType::I16, 1},
+    {"right2", FieldType::I16, 1}, {"right3", FieldType::I16, 1}};
+// drive motor temperature in degrees C, to a tenth
+inline constexpr Field kTemperatureFields[] = {
+    {"left1", FieldType::I16, 10},  {"left2", FieldType::I16, 10},
+    {"left3", FieldType::I16, 10},  {"right1", FieldType::I16, 10},
+    {"right2", FieldType::I16, 10}, {"right3", FieldType::I16, 10}};
+// one PID update: its error, each term and their sum
+inline constexpr Field kPidFields[] = {{"error", FieldType::F32, 1},
+                                       {"p", FieldType::F32, 1},
+                                       {"i", FieldType::F32, 1},
+                                       {"d", FieldType::F32, 1},
+                                       {"output", FieldType::F32, 1}};
+
+inline constexpr Schema kSchemas[] = {
+    {kPoseChannel, "pose", kPoseFields, std::size(kPoseFields)},
+    {kMotorChannel, "motors", kMotorFields, std::size(kMotorFields)},
+    {kPidChannel, "pid", kPidFields, std::size(kPidFields)},
+    {kVelocityChannel, "velocity", kVelocityFields, std::size(kVelocityFields)},
+    {kTemperatureChannel, "temperature", kTemperatureFields,
+     std::size(kTemperatureFields)}};
+
+// nullptr for an unknown channel
+constexpr const Schema *findSchema(std::uint8_t id) {
+  for (const Schema &schema : kSchemas) {
+    if (schema.id == id) return &schema;
+  }
+  return nullptr;
+}
+
+constexpr std::size_t fieldSize(FieldType type) {
+  return type == FieldType::I16 ? 2 : 4;
+}
+
+constexpr std::size_t payloadSize(const Schema &schema) {
+  std::size_t size = 0;
+  for (std::size_t i = 0; i < schema.count; i++) {
+    size += fieldSize(schema.fields[i].type);
+  }
+  return size;
+}
+}  // namespace telemetry
+
+#endif
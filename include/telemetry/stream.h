@@ -0,0 +1,40 @@
+#include "telemetry/frame.h"  // IWYU pragma: keep
+#include "telemetry/log.h"    // IWYU pragma: keep
+
+#ifndef TELEMETRY_STREAM_H
+#define TELEMETRY_STREAM_H
+
+#include <cstdint>
+#include <initializer_list>
+
+namespace telemetry {
+// Sends typed samples as binary frames, see telemetry/frame.h, through a log
+// so they go out with its text. A sample of three floats takes a dozen bytes
+// and no formatting, where the same text line takes several times the bytes
+// and a float to text conversion for each value. tools/telemetryDecoder.cpp
+// turns a capture back into CSV.
+//
+// A frame's time is the ms since its channel's previous frame, with the
+// absolute time every second so a dropped frame only skews a channel's times
+// until then
+class Stream {
+ public:
+  explicit Stream(Log &log);
+
+  // `values` are in the channel's schema order. False if the channel is
+  // unknown, the count is wrong or the log dropped the frame. Each channel
+  // must only be sent from one task
+  bool send(std::uint8_t channel, std::initializer_list<float> values);
+
+ private:
+  Log &log;
+  std::uint32_t previous[kChannels] = {}; // ms of the last frame sent
+  std::uint32_t absolute[kChannels] = {}; // ms of the last absolute time
+  bool started[kChannels] = {};
+};
+
+// the telemetry stream, through telemetryLog()
+Stream &telemetryStream();
+}  // namespace telemetry
+
+#endif
@@ -0,0 +1,96 @@
+#include "lemlib/chassis/chassis.hpp"  // IWYU pragma: keep
+#include "motion/chassis.h"            // IWYU pragma: keep
+
+#ifndef TUNE_AUTOTUNER_H
+#define TUNE_AUTOTUNER_H
+
+#include <cstdint>
+
+namespace tune {
+// which of LemLib's controllers to tune: lateral on the distance to a point,
+// angular on the heading
+enum class Loop { Lateral, Angular };
+
+// How a step test went, in inches for the lateral loop and degrees for the
+// angular one
+struct StepResponse {
+  float rise;      // ms from 10% to 90% of the step, or the window if never
+  float overshoot; // furthest past the target
+  float settle;    // ms until it stays within the tolerance, or the window
+  float error;     // how far from the target it ended
+};
+
+// How the robot oscillated under relay feedback
+struct RelayResponse {
+  float amplitude;    // inches or degrees either side of the target
+  float period;       // ms, 0 if it never settled into an oscillation
+  float ultimateGain; // proportional gain, power per inch or degree, that
+                      // would hold it oscillating
+};
+
+struct TuneSettings {
+  // how far each step test moves
+  float step;
+  // how close to the target a step counts as settled
+  float tolerance;
+  // ms each step test runs for
+  int window;
+  // power, out of 127, the relay test drives either way with
+  float relayPower;
+  // how far past the target the relay waits before switching
+  float hysteresis;
+  // pairs of step tests the refinement may run
+  int evaluations = 24;
+  // ms of settling time that each inch or degree of overshoot past the
+  // tolerance costs a candidate
+  float overshootCost = 100;
+};
+
+// 24 inch steps, settled within an inch
+constexpr TuneSettings kLateralTuning = {24, 1, 2000, 40, 0.25};
+// 90 degree turns, settled within a degree
+constexpr TuneSettings kAngularTuning = {90, 1, 1500, 40, 0.5};
+
+// Tunes the kP and kD of LemLib's lateral and angular PIDs on the robot, by
+// the same step tests it can run against the simulator. A relay test first
+// finds the gain and period the loop oscillates at, for Ziegler-Nichols PD
+// gains to start from. A Nelder-Mead search over kP and kD then refines them
+// with step tests there and back through LemLib's own turnToHeading and
+// moveToPoint, for the shortest settling time with little overshoot. kI, the
+// exit conditions and slew are left as they were. Needs the field space for
+// a step either way, and nothing else moving the chassis
+//
+//   tune::Autotuner tuner(chassis);
+//   tuner.tune(tune::Loop::Angular, tune::kAngularTuning);
+//   tuner.tune(tune::Loop::Lateral, tune::kLateralTuning);
+class Autotuner {
+ public:
+  explicit Autotuner(motion::Chassis &chassis) : chassis(chassis) {}
+
+  // Oscillates the loop about where the robot is by driving at relayPower
+  // towards it, switching each time it passes by the hysteresis
+  RelayResponse relay(Loop loop, const TuneSettings &settings);
+  // Ziegler-Nichols PD gains from the relay test, or the chassis's own if the
+  // loop never oscillated
+  lemlib::ControllerSettings relayGains(Loop loop,
+                                        const TuneSettings &settings);
+  // A step of settings.step away and one back, with `gains`, averaged. The
+  // chassis keeps `gains` after
+  StepResponse step(Loop loop, const lemlib::ControllerSettings &gains,
+                    const TuneSettings &settings);
+  // The relay gains, then the refinement. Leaves the chassis with the tuned
+  // gains, logs them to the telemetry log and returns them. Tune the angular
+  // loop first, since moveToPoint steers with it
+  lemlib::ControllerSettings tune(Loop loop, const TuneSettings &settings);
+
+ private:
+  // one step test of `distance`, which is negative for backwards
+  StepResponse stepOnce(Loop loop, float distance,
+                        const TuneSettings &settings);
+  float cost(const StepResponse &response, const TuneSettings &settings) const;
+
+  motion::Chassis &chassis;
+};
+}  // namespace tune
+
+#endif
@@ -0,0 +1,173 @@
+#include "pros/rtos.hpp"  // IWYU pragma: keep
+
+#ifndef UTIL_BYTE_RING_H
+#define UTIL_BYTE_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace util {
+// what a full ring does with a new message
+enum class Overflow {
+  DropNewest, // refuse the new message
+  DropOldest, // discard messages not yet read until the new one fits
+  Block       // wait for the reader to make room. Never from a control loop
+};
+
+// Bounded multi-producer, single-consumer queue of variable length messages,
+// stored in place in `Capacity` bytes. Writers reserve space with a single
+// compare and swap and never take a lock, so a writer is only ever held up by
+// another writer that is mid-reservation. Messages are read whole and in the
+// order they were reserved; one still being written holds back the ones
+// behind it.
+//
+// Each message takes a two word header and its bytes rounded up to a whole
+// number of header sizes. The first header word is the message's position
+// plus one once it is written, and zero otherwise: space is zeroed as it is
+// read, so a reader can never mistake old bytes for a message
+template <std::size_t Capacity> class ByteRing {
+  static_assert(Capacity >= 16 && (Capacity & (Capacity - 1)) == 0,
+                "positions wrap, so the capacity must be a power of two");
+
+ public:
+  explicit ByteRing(Overflow overflow = Overflow::DropNewest)
+      : overflow(overflow) {}
+
+  // false if the message was dropped, or is larger than the ring
+  bool push(const void *data, std::size_t size) {
+    std::uint32_t need = footprint(size);
+    if (need > kWords) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    std::uint32_t position = head.load(std::memory_order_relaxed);
+    while (true) {
+      std::uint32_t start = tail.load(std::memory_order_acquire);
+      if (std::int32_t(position - start) < 0) {
+        // the reader passed a stale head
+        position = head.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (position + need - start > kWords) {
+        if (overflow == Overflow::Block) {
+          pros::delay(1);
+        } else if (overflow == Overflow::DropNewest || !discardOldest()) {
+          // the oldest message is still being written or read, and waiting
+          // for it could mean waiting on a lower priority task
+          dropped.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        }
+        position = head.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (head.compare_exchange_weak(position, position + need,
+                                     std::memory_order_relaxed)) {
+        break;
+      }
+    }
+
+    const auto *bytes = static_cast<const std::uint8_t *>(data);
+    for (std::uint32_t i = 0; i < (size + 3) / 4; i++) {
+      std::uint32_t word = 0;
+      std::memcpy(&word, bytes + i * 4, std::min<std::size_t>(4, size - i * 4));
+      at(position + 2 + i).store(word, std::memory_order_relaxed);
+    }
+    at(position + 1).store(size, std::memory_order_relaxed);
+    at(position).store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Copies whole messages, oldest first, into `out` until the next one would
+  // not fit in `space` bytes, and returns how many bytes it copied. Only one
+  // task may pop
+  std::size_t pop(void *out, std::size_t space) {
+    auto *bytes = static_cast<std::uint8_t *>(out);
+    std::size_t copied = 0;
+    std::size_t size;
+    while (take(bytes + copied, space - copied, size)) copied += size;
+    return copied;
+  }
+
+  // Copies just the oldest message, for readers that need to know where
+  // messages end. Its size, or 0 if there is none or it would not fit
+  std::size_t popOne(void *out, std::size_t space) {
+    std::size_t size;
+    return take(out, space, size) ? size : 0;
+  }
+
+  void setOverflow(Overflow policy) { overflow = policy; }
+
+  // messages lost to overflow, from either end
+  std::uint32_t getDropped() const {
+    return dropped.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr std::uint32_t kWords = Capacity / 4;
+
+  // header words plus the message, in whole pairs of words so that positions
+  // stay even and a header tag of position plus one is never zero
+  static constexpr std::uint32_t footprint(std::size_t size) {
+    return 2 + ((std::uint32_t(size) + 7) / 8) * 2;
+  }
+
+  std::atomic<std::uint32_t> &at(std::uint32_t position) {
+    return words[position % kWords];
+  }
+
+  // copies out and releases the oldest message, if it fits in `space`
+  bool take(void *out, std::size_t space, std::size_t &size) {
+    std::uint32_t position = tail.load(std::memory_order_acquire);
+    std::uint32_t tag = position + 1;
+    if (at(position).load(std::memory_order_acquire) != tag) return false;
+    size = at(position + 1).load(std::memory_order_relaxed);
+    if (size > space) return false;
+    // a writer discarding the oldest message may have just taken it
+    if (!at(position).compare_exchange_strong(tag, 0,
+                                              std::memory_order_acquire)) {
+      return false;
+    }
+    auto *bytes = static_cast<std::uint8_t *>(out);
+    for (std::uint32_t i = 0; i < (size + 3) / 4; i++) {
+      std::uint32_t word = at(position + 2 + i).load(std::memory_order_relaxed);
+      std::memcpy(bytes + i * 4, &word, std::min<std::size_t>(4, size - i * 4));
+    }
+    release(position, size);
+    return true;
+  }
+
+  // Takes the oldest message away from the reader. Fails rather than waits if
+  // it is not there to take
+  bool discardOldest() {
+    std::uint32_t position = tail.load(std::memory_order_acquire);
+    std::uint32_t tag = position + 1;
+    if (!at(position).compare_exchange_strong(tag, 0,
+                                              std::memory_order_acquire)) {
+      return false;
+    }
+    release(position, at(position + 1).load(std::memory_order_relaxed));
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // zeroes a taken message and hands its space back to the writers
+  void release(std::uint32_t position, std::uint32_t size) {
+    std::uint32_t need = footprint(size);
+    for (std::uint32_t i = 1; i < need; i++) {
+      at(position + i).store(0, std::memory_order_relaxed);
+    }
+    tail.store(position + need, std::memory_order_release);
+  }
+
+  std::atomic<std::uint32_t> words[kWords] = {};
+  std::atomic<std::uint32_t> head{0}; // next position to reserve
+  std::atomic<std::uint32_t> tail{0}; // oldest position not yet released
+  std::atomic<std::uint32_t> dropped{0};
+  std::atomic<Overflow> overflow;
+};
+}  // namespace util
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef UTIL_CONST_MATH_H
+#define UTIL_CONST_MATH_H
+
+namespace util {
+// <cmath>'s exp, log and pow are not constexpr before C++26, so tables made
+// at compile time use these. They are as close as double allows over the
+// ranges the tables need, and far too slow to call every tick instead
+constexpr double kLn2 = 0.69314718055994530942;
+
+constexpr double exp(double x) {
+  // e^x = 2^k e^r, with |r| at most half ln 2 so the series converges fast
+  const long k = static_cast<long>(x / kLn2 + (x < 0 ? -0.5 : 0.5));
+  const double r = x - k * kLn2;
+  double term = 1;
+  double sum = 1;
+  for (int n = 1; n < 20; n++) {
+    term *= r / n;
+    sum += term;
+  }
+  for (long i = 0; i < k; i++) sum *= 2;
+  for (long i = 0; i > k; i--) sum /= 2;
+  return sum;
+}
+
+// only for x > 0
+constexpr double log(double x) {
+  // x = m 2^k with m in [1, 2), and ln m = 2 atanh((m - 1) / (m + 1))
+  long k = 0;
+  while (x >= 2) {
+    x /= 2;
+    k++;
+  }
+  while (x < 1) {
+    x *= 2;
+    k--;
+  }
+  const double z = (x - 1) / (x + 1);
+  double term = z;
+  double sum = 0;
+  for (int n = 1; n < 40; n += 2) {
+    sum += term / n;
+    term *= z * z;
+  }
+  return 2 * sum + k * kLn2;
+}
+
+// only for base > 0
+constexpr double pow(double base, double exponent) {
+  return exp(exponent * log(base));
+}
+}  // namespace util
+
+#endif
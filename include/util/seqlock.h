@@ -0,0 +1,76 @@
+#ifndef UTIL_SEQLOCK_H
+#define UTIL_SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+namespace util {
+// Single-writer, multi-reader channel for a small value. Neither side ever
+// blocks: the writer fills whichever of two slots readers are not using and
+// then flips to it, and a reader only retries if the writer managed to publish
+// twice while it was copying. A reader of higher priority than the writer can
+// therefore never spin on a half-written value
+template <typename T> class Seqlock {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Seqlock values are copied word by word");
+
+ public:
+  explicit Seqlock(const T &initial = T()) { write(initial); }
+
+  // only one task may write
+  void write(const T &value) {
+    std::uint32_t next = version.load(std::memory_order_relaxed) + 1;
+    Slot &slot = slots[next & 1];
+    std::uint32_t words[kWords] = {};
+    std::memcpy(words, &value, sizeof(T));
+
+    std::uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int i = 0; i < kWords; i++) {
+      slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    version.store(next, std::memory_order_release);
+  }
+
+  T read() const {
+    std::uint32_t words[kWords];
+    for (;;) {
+      const Slot &slot = slots[version.load(std::memory_order_acquire) & 1];
+      std::uint32_t before = slot.sequence.load(std::memory_order_acquire);
+      if (before & 1) continue;
+      for (int i = 0; i < kWords; i++) {
+        words[i] = slot.words[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) == before) break;
+    }
+    // T need not be default constructible, so it is copied out of raw storage
+    alignas(T) unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, words, sizeof(T));
+    return *std::launder(reinterpret_cast<T *>(bytes));
+  }
+
+  // counts writes, so a reader can tell whether anything new was published
+  std::uint32_t getVersion() const {
+    return version.load(std::memory_order_acquire);
+  }
+
+ private:
+  static constexpr int kWords = (sizeof(T) + 3) / 4;
+
+  struct Slot {
+    std::atomic<std::uint32_t> sequence{0};
+    std::atomic<std::uint32_t> words[kWords] = {};
+  };
+
+  Slot slots[2];
+  std::atomic<std::uint32_t> version{0};
+};
+}  // namespace util
+
+#endif
@@ -0,0 +1,88 @@
+// Drive curve benchmark. Calls LemLib's ExpoDriveCurve and an
+// input::TableCurve baked from the same expo shape over every joystick value,
+// the way arcade and curvature control call the throttle and steer curves
+// every tick, and reports the host time per call. Then checks the table
+// against LemLib's curve: the largest difference in power, and how many
+// joystick values arcade would turn into different motor power, as it
+// truncates the curve's output to an int. Also bakes the piecewise, cubic,
+// spline and composed shapes, to time their lookups alongside
+//
+//   usage: curve [--calls n]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "main.h"
+
+namespace {
+lemlib::ExpoDriveCurve expo(3, 10, 1.019);
+constinit input::TableCurve table(input::Expo{3, 10, 1.019});
+
+constinit input::TableCurve cubic(input::Cubic{3, 10, 0.6});
+constinit input::TableCurve piecewise(
+    input::Piecewise({{5, 0}, {80, 40}, {127, 127}}));
+constinit input::TableCurve spline(
+    input::Spline({{5, 0}, {40, 15}, {90, 60}, {127, 127}}));
+// a gentle expo, with the top quarter of the stick boosted to full power
+constinit input::TableCurve composed(input::compose(
+    input::Expo{3, 10, 1.01},
+    input::Piecewise({{0, 0}, {90, 90}, {110, 127}, {127, 127}})));
+
+volatile float sink = 0;
+
+// mean ns per call, over every joystick value in turn
+double measure(lemlib::DriveCurve &curve, int calls) {
+  float total = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < calls; i++) total += curve.curve(i % 255 - 127);
+  double ns = std::chrono::duration<double, std::nano>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+  sink = total;
+  return ns / calls;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  int calls = 10000000;
+  for (int i = 1; i + 1 < argc; i++) {
+    if (std::strcmp(argv[i], "--calls") == 0) calls = std::atoi(argv[++i]);
+  }
+
+  struct Row {
+    const char *name;
+    lemlib::DriveCurve &curve;
+  };
+  const Row rows[] = {{"lemlib expo", expo},     {"table expo", table},
+                      {"table cubic", cubic},    {"table piecewise", piecewise},
+                      {"table spline", spline},  {"table composed", composed}};
+  std::printf("%-16s %10s\n", "curve", "ns/call");
+  for (const Row &row : rows) {
+    std::printf("%-16s %10.2f\n", row.name, measure(row.curve, calls));
+  }
+
+  // against LemLib's curve, on joystick values and between them
+  double joystick = 0;
+  double between = 0;
+  int truncated = 0;
+  for (int i = -127; i <= 127; i++) {
+    joystick = std::max(
+        joystick, double(std::fabs(table.curve(i) - expo.curve(i))));
+    if (int(table.curve(i)) != int(expo.curve(i))) truncated++;
+    // skipping the step at the deadband, which the table ramps across
+    if (std::abs(i) > 3 && std::abs(i) < 127) {
+      const float input = i + 0.5f * (i < 0 ? -1 : 1);
+      between = std::max(
+          between, double(std::fabs(table.curve(input) - expo.curve(input))));
+    }
+  }
+  std::printf("largest difference: %.6f on joystick values, %.6f between\n",
+              joystick, between);
+  std::printf("%d of 255 joystick values give different motor power\n",
+              truncated);
+  return 0;
+}
@@ -0,0 +1,131 @@
+// State estimator benchmark. Drives the robot through a fixed course of
+// straights, turns and arcs with pauses between them, feeds every sensor frame
+// to each estimator, and compares their poses with the simulator's ground
+// truth. Also times each update on the host; the brain's Cortex-A9 is an
+// order of magnitude slower, so compare the estimators with each other and
+// with the 10 ms odometry period, not with the host's clock.
+//
+//   usage: estimator [--laps n]
+//
+// The simulated IMU has the bias, scale error and noise in sim/src/robot.cpp,
+// and the GPS the noise
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "main.h"
+#include "sim/robot.h"
+#include "sim/world.h"
+
+extern lemlib::Drivetrain drivetrain;
+extern pros::Rotation horizontalEnc;
+extern pros::Imu imu;
+
+namespace {
+constexpr std::uint8_t kGpsPort = 11;
+constexpr std::uint32_t kPeriod = 10; // ms
+
+// one stretch of the course: side voltages held for a time
+struct Segment {
+  std::uint32_t duration; // ms
+  std::int32_t left;      // mV
+  std::int32_t right;
+};
+
+// a lap ends where it started, facing the same way, give or take the model
+const Segment kLap[] = {
+    {1000, 0, 0},         {1200, 8000, 8000},   {600, 6000, -6000},
+    {1000, 0, 0},         {1500, 9000, 5000},   {800, -5000, 5000},
+    {1200, -8000, -8000}, {500, 0, 0},          {1500, 5000, 9000},
+    {700, 12000, -12000}, {1000, 0, 0},         {1000, -6000, -10000},
+};
+
+struct Result {
+  const char *name;
+  double nanoseconds = 0; // total spent updating
+  double maxNanoseconds = 0;
+  int updates = 0;
+  double maxError = 0; // inches
+  double finalError = 0;
+  double finalHeading = 0; // degrees
+};
+
+// feeds `frame` to `estimator` and scores it against `truth`
+void step(odom::Estimator &estimator, Result &result,
+          const odom::SensorFrame &frame, const sim::BodyState &truth) {
+  auto start = std::chrono::steady_clock::now();
+  lemlib::Pose pose = estimator.update(frame);
+  double elapsed = std::chrono::duration<double, std::nano>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  result.nanoseconds += elapsed;
+  result.maxNanoseconds = std::max(result.maxNanoseconds, elapsed);
+  result.updates++;
+
+  double error = std::hypot(pose.x - truth.x, pose.y - truth.y);
+  result.maxError = std::max(result.maxError, error);
+  result.finalError = error;
+  result.finalHeading = lemlib::radToDeg(pose.theta) - truth.theta;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  int laps = 5;
+  if (argc == 3 && !std::strcmp(argv[1], "--laps")) laps = std::atoi(argv[2]);
+
+  sim::attachRobot();
+  pros::Gps gps(kGpsPort);
+  odom::SensorReader reader(drivetrain, &horizontalEnc,
+                            lemlib::Omniwheel::NEW_2, 2.5, &imu, &gps);
+  imu.reset(true);
+  reader.tare();
+
+  float trackWidth = reader.getTrackWidth();
+  float horizontalOffset = reader.getHorizontalOffset();
+  odom::Tracker tracker(trackWidth, horizontalOffset);
+  odom::Ekf ekf(trackWidth, horizontalOffset);
+  odom::Ekf ekfGps(trackWidth, horizontalOffset);
+  odom::Estimator *estimators[] = {&tracker, &ekf, &ekfGps};
+  Result results[] = {{"tracker"}, {"ekf"}, {"ekf + gps"}};
+
+  odom::SensorFrame first = reader.read();
+  for (odom::Estimator *estimator : estimators) {
+    estimator->reset(first);
+    estimator->setPose({0, 0, 0});
+  }
+
+  std::uint32_t wake = pros::millis();
+  for (int lap = 0; lap < laps; lap++) {
+    for (const Segment &segment : kLap) {
+      drivetrain.leftMotors->move_voltage(segment.left);
+      drivetrain.rightMotors->move_voltage(segment.right);
+      for (std::uint32_t t = 0; t < segment.duration; t += kPeriod) {
+        pros::Task::delay_until(&wake, kPeriod);
+        odom::SensorFrame frame = reader.read();
+        sim::BodyState truth = sim::world().truth();
+        odom::SensorFrame withoutGps = frame;
+        withoutGps.gpsValid = false;
+        step(tracker, results[0], withoutGps, truth);
+        step(ekf, results[1], withoutGps, truth);
+        step(ekfGps, results[2], frame, truth);
+      }
+    }
+  }
+
+  std::printf("%d laps, %u ms, gyro bias estimate %.4f deg/s\n", laps,
+              pros::millis(), lemlib::radToDeg(ekf.getGyroBias()));
+  std::printf("%-10s %10s %10s %12s %12s %12s\n", "estimator", "mean ns",
+              "max ns", "max err in", "final err in", "heading deg");
+  for (const Result &result : results) {
+    std::printf("%-10s %10.0f %10.0f %12.3f %12.3f %12.3f\n", result.name,
+                result.nanoseconds / result.updates, result.maxNanoseconds,
+                result.maxError, result.finalError, result.finalHeading);
+  }
+  std::fflush(stdout);
+  // the simulator's tasks never return, so leave without unwinding them
+  std::_Exit(0);
+}
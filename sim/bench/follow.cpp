@@ -0,0 +1,278 @@
+// Path following benchmark. Times one control step of LemLib's pure pursuit,
+// which searches the whole path for the closest point and then the rest of it
+// for the lookahead circle every step, against one step of following a
+// motion::TimedPath, which carries on from where the last step found things.
+// The steps are taken at poses along each path in the tarball and the example
+// path. Then follows the example path in the simulator with the binary path
+// follower, standing in for LemLib's, and with each of the timed path's
+// trackers at a range of top speeds, and reports how long each took, how far
+// from the path the robot strayed, and how close to its end it stopped.
+//
+//   usage: follow [--trial binary|pursuit|ramsete|ltv speed]
+//
+// Every trial runs in a fresh process, so each one starts from the same world
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "main.h"
+#include "sim/robot.h"
+#include "sim/world.h"
+
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::OdomSensors sensors;
+extern odom::Scheduler odometry;
+
+ASSET(example_txt);
+ASSET(example_path);
+ASSET(my_lemlib_tarball_file_txt);
+
+namespace {
+// the same settings and feedforward as the profile benchmark, with the
+// constraints that pure pursuit followed the example path fastest with while
+// still stopping within half an inch of its end
+lemlib::ControllerSettings lateral(10, 0, 3, 3, 1, 100, 3, 500, 20);
+lemlib::ControllerSettings angular(2, 0, 10, 3, 1, 100, 3, 500, 0);
+motion::ProfileSettings profiled({45, 150}, {12.7, 2.12, 0.3}, 6);
+// tighter than their defaults, which leave a small robot too much slack
+motion::Ramsete ramsete(0.01, 0.7);
+motion::LtvUnicycle ltv({1, 1, 0.3, 40, 4});
+
+constexpr float kLookahead = 15;
+constexpr int kRepeats = 200;
+
+// LemLib's path text, as its follow reads it: x, y and speed as theta
+std::vector<lemlib::Pose> parseText(const asset &file) {
+  std::vector<lemlib::Pose> points;
+  std::string text(reinterpret_cast<char *>(file.buf), file.size);
+  std::size_t start = 0;
+  while (start < text.size()) {
+    std::size_t end = text.find('\n', start);
+    if (end == std::string::npos) end = text.size();
+    std::string line = text.substr(start, end - start);
+    start = end + 1;
+    if (line.rfind("endData", 0) == 0) break;
+    float x, y, speed;
+    if (std::sscanf(line.c_str(), "%f , %f , %f", &x, &y, &speed) == 3) {
+      points.emplace_back(x, y, speed);
+    }
+  }
+  return points;
+}
+
+// of the arc from the robot to the point it steers at
+float curvature(const lemlib::Pose &pose, const lemlib::Pose &aim) {
+  return lemlib::getCurvature({pose.x, pose.y, float(M_PI / 2) - pose.theta},
+                              aim);
+}
+
+// One step of LemLib's pure pursuit: the closest point over the whole path,
+// then the lookahead circle from the last lookahead on
+struct LemLibStep {
+  const std::vector<lemlib::Pose> &path;
+  lemlib::Pose lastLookahead;
+
+  float operator()(const lemlib::Pose &pose) {
+    std::size_t closest = 0;
+    float closestDistance = INFINITY;
+    for (std::size_t i = 0; i < path.size(); i++) {
+      float d = pose.distance(path[i]);
+      if (d < closestDistance) {
+        closest = i;
+        closestDistance = d;
+      }
+    }
+    for (std::size_t i = std::max(closest, std::size_t(lastLookahead.theta));
+         i + 1 < path.size(); i++) {
+      const lemlib::Pose &p1 = path[i];
+      const lemlib::Pose &p2 = path[i + 1];
+      lemlib::Pose d = p2 - p1;
+      lemlib::Pose f = p1 - pose;
+      float a = d * d;
+      float b = 2 * (f * d);
+      float c = (f * f) - kLookahead * kLookahead;
+      float discriminant = b * b - 4 * a * c;
+      if (discriminant < 0 || a == 0) continue;
+      discriminant = std::sqrt(discriminant);
+      float t = (-b + discriminant) / (2 * a);
+      if (t < 0 || t > 1) t = (-b - discriminant) / (2 * a);
+      if (t < 0 || t > 1) continue;
+      lastLookahead = p1.lerp(p2, t);
+      lastLookahead.theta = i;
+      break;
+    }
+    return path[closest].theta * curvature(pose, lastLookahead);
+  }
+};
+
+// one step of Chassis::follow over a timed path
+struct TimedStep {
+  const motion::TimedPath &path;
+  std::size_t closest = 0;
+  std::size_t sampled = 0;
+  std::size_t aimed = 0;
+  float time = 0;
+
+  float operator()(const lemlib::Pose &pose) {
+    closest = path.closest(pose, closest);
+    float progress = path.progress(pose, closest);
+    motion::ProfileState state = path.sample(time += 0.01f, sampled);
+    lemlib::Pose aim = path.pointAt(progress + kLookahead, aimed);
+    return (state.position - progress) * curvature(pose, aim);
+  }
+};
+
+// poses a step apart along the path, an inch to its left and facing along it
+std::vector<lemlib::Pose> drive(const motion::TimedPath &path) {
+  std::vector<lemlib::Pose> poses;
+  std::size_t hint = 0;
+  for (float s = 0; s < path.getLength(); s += 0.4f) {
+    lemlib::Pose a = path.pointAt(s, hint);
+    lemlib::Pose b = path.pointAt(s + 0.1f, hint);
+    float heading = std::atan2(b.y - a.y, b.x - a.x);
+    poses.emplace_back(a.x - std::sin(heading), a.y + std::cos(heading),
+                       M_PI / 2 - heading);
+  }
+  return poses;
+}
+
+template <typename Step>
+double nanosecondsPerStep(const std::vector<lemlib::Pose> &poses,
+                          Step start) {
+  volatile float sink = 0;
+  auto begin = std::chrono::steady_clock::now();
+  for (int r = 0; r < kRepeats; r++) {
+    Step step = start;
+    for (const lemlib::Pose &pose : poses) sink = sink + step(pose);
+  }
+  return std::chrono::duration<double, std::nano>(
+             std::chrono::steady_clock::now() - begin)
+             .count() /
+         (double(kRepeats) * poses.size());
+}
+
+void compare(const char *name, const asset &text) {
+  std::vector<lemlib::Pose> points = parseText(text);
+  motion::TimedPath timed(text, profiled.constraints, drivetrain.trackWidth);
+  std::vector<lemlib::Pose> poses = drive(timed);
+  if (poses.empty()) return;
+  double lemlib = nanosecondsPerStep(poses, LemLibStep{points, points[0]});
+  double fast = nanosecondsPerStep(poses, TimedStep{timed});
+  std::printf("%-10s %8zu %8.1f %12.0f %12.0f\n", name, points.size(),
+              timed.getDuration(), lemlib, fast);
+}
+
+const char *const kFollowers[] = {"binary", "pursuit", "ramsete", "ltv"};
+const float kSpeeds[] = {45, 50, 53};
+
+struct Result {
+  std::uint32_t time; // ms
+  double error;       // inches from the path's end
+  double meanOff;     // inches from the path, on average while following it
+  double maxOff;      // inches
+};
+
+Result trial(const char *follower, float speed) {
+  motion::ProfileSettings settings = profiled;
+  settings.constraints.maxVelocity = speed;
+  static motion::Chassis chassis(drivetrain, lateral, angular, sensors,
+                                 settings);
+  chassis.setOdometry(odometry);
+  chassis.setProfileSettings(settings);
+  chassis.setRamsete(ramsete);
+  chassis.setLtv(ltv);
+  motion::TimedPath route(path::BinaryPath(example_path),
+                          settings.constraints, drivetrain.trackWidth);
+  sim::attachRobot();
+  odometry.calibrate();
+  odometry.setPose({0, 0, 0});
+  pros::delay(100);
+
+  std::uint32_t start = pros::millis();
+  if (!std::strcmp(follower, "binary")) {
+    chassis.follow(path::BinaryPath(example_path), kLookahead, 10000);
+  } else {
+    motion::Tracker tracker = !std::strcmp(follower, "ramsete")
+                                  ? motion::Tracker::Ramsete
+                              : !std::strcmp(follower, "ltv")
+                                  ? motion::Tracker::Ltv
+                                  : motion::Tracker::PurePursuit;
+    chassis.follow(route, 10000,
+                   {.tracker = tracker, .lookahead = kLookahead});
+  }
+  // how far the robot really is from the path, every control step
+  double totalOff = 0;
+  double maxOff = 0;
+  int steps = 0;
+  std::size_t closest = 0;
+  std::size_t hint = 0;
+  while (chassis.isInMotion()) {
+    sim::BodyState truth = sim::world().truth();
+    lemlib::Pose pose(truth.x, truth.y, 0);
+    closest = route.closest(pose, closest);
+    lemlib::Pose nearest = route.pointAt(route.progress(pose, closest), hint);
+    double off = pose.distance(nearest);
+    totalOff += off;
+    maxOff = std::max(maxOff, off);
+    steps++;
+    pros::delay(10);
+  }
+  std::uint32_t time = pros::millis() - start;
+  pros::delay(500);
+  sim::BodyState truth = sim::world().truth();
+  const motion::TimedPath::Point &end = route[route.size() - 1];
+  return {time, std::hypot(truth.x - end.x, truth.y - end.y),
+          totalOff / std::max(steps, 1), maxOff};
+}
+
+Result spawn(const char *self, const char *follower, float speed) {
+  std::string command = std::string(self) + " --trial " + follower + " " +
+                        std::to_string(speed);
+  FILE *pipe = popen(command.c_str(), "r");
+  Result result{0, NAN, NAN, NAN};
+  if (pipe == nullptr ||
+      std::fscanf(pipe, "%u %lf %lf %lf", &result.time, &result.error,
+                  &result.meanOff, &result.maxOff) != 4) {
+    std::fprintf(stderr, "trial %s failed\n", command.c_str());
+  }
+  if (pipe != nullptr) pclose(pipe);
+  return result;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc == 4 && !std::strcmp(argv[1], "--trial")) {
+    Result result = trial(argv[2], std::atof(argv[3]));
+    std::printf("%u %f %f %f\n", result.time, result.error, result.meanOff,
+                result.maxOff);
+    std::fflush(stdout);
+    std::_Exit(0);
+  }
+
+  std::printf("%-10s %8s %8s %12s %12s\n", "path", "points", "profile s",
+              "lemlib ns", "timed ns");
+  path::Tarball tarball(my_lemlib_tarball_file_txt);
+  for (std::size_t i = 0; i < tarball.size(); i++) {
+    std::string name(tarball.name(i));
+    compare(name.c_str(), tarball.get(name));
+  }
+  compare("example", example_txt);
+
+  std::printf("\n%-9s %6s %8s %8s %9s %8s\n", "follower", "in/s", "ms",
+              "end off", "mean off", "max off");
+  for (const char *follower : kFollowers) {
+    for (float speed : kSpeeds) {
+      Result result = spawn(argv[0], follower, speed);
+      std::printf("%-9s %6.0f %8u %8.3f %9.3f %8.3f\n", follower, speed,
+                  result.time, result.error, result.meanOff, result.maxOff);
+      // the binary path drives at its own speeds
+      if (!std::strcmp(follower, "binary")) break;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,116 @@
+// Latency compensation benchmark. Runs the same motion::Chassis motions
+// controlling against the pose as measured and as extrapolated by the
+// actuation latency, and compares how long they take to settle and where
+// they end up.
+//
+//   usage: latency [--trial motion compensated]
+//
+// Every trial runs in a fresh process, so each one starts from the same world
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "main.h"
+#include "sim/robot.h"
+#include "sim/world.h"
+
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::OdomSensors sensors;
+extern odom::Scheduler odometry;
+
+ASSET(example_path);
+
+namespace {
+// tuned well enough to settle, with exits that end the motions once they have
+lemlib::ControllerSettings lateral(10, 0, 3, 3, 1, 100, 3, 500, 20);
+lemlib::ControllerSettings angular(2, 0, 10, 3, 1, 100, 3, 500, 0);
+// the follow benchmark's constraints and feedforward
+motion::ProfileSettings profiled({45, 150}, {12.7, 2.12, 0.3}, 6);
+
+constexpr int kTimeout = 5000;
+const char *const kMotions[] = {"moveToPoint", "moveToPose", "turnToHeading",
+                                "follow"};
+
+struct Result {
+  std::uint32_t settle; // ms
+  double error;         // inches, or degrees for turns
+};
+
+Result trial(const char *motion, bool compensated) {
+  static motion::Chassis chassis(drivetrain, lateral, angular, sensors,
+                                 profiled);
+  sim::attachRobot();
+  odometry.calibrate();
+  odometry.setPose({0, 0, 0});
+  pros::delay(100);
+  chassis.setOdometry(odometry);
+  chassis.setLatencyCompensation(compensated);
+
+  const motion::TimedPath route(path::BinaryPath(example_path),
+                                profiled.constraints, drivetrain.trackWidth);
+  const motion::TimedPath::Point &end = route[route.size() - 1];
+  std::uint32_t start = pros::millis();
+  if (!std::strcmp(motion, "moveToPoint")) {
+    chassis.profiledMoveToPoint(0, 48, kTimeout);
+  } else if (!std::strcmp(motion, "moveToPose")) {
+    chassis.profiledMoveToPose(24, 36, 90, kTimeout);
+  } else if (!std::strcmp(motion, "turnToHeading")) {
+    chassis.turnToHeading(90, kTimeout);
+  } else {
+    chassis.follow(route, kTimeout, {.lookahead = 15});
+  }
+  chassis.waitUntilDone();
+  std::uint32_t settle = pros::millis() - start;
+  // let the robot come to rest before measuring where it ended up
+  pros::delay(500);
+  sim::BodyState truth = sim::world().truth();
+  double error;
+  if (!std::strcmp(motion, "moveToPoint")) {
+    error = std::hypot(truth.x, truth.y - 48);
+  } else if (!std::strcmp(motion, "moveToPose")) {
+    error = std::hypot(truth.x - 24, truth.y - 36);
+  } else if (!std::strcmp(motion, "turnToHeading")) {
+    error = std::fabs(truth.theta - 90);
+  } else {
+    error = std::hypot(truth.x - end.x, truth.y - end.y);
+  }
+  return {settle, error};
+}
+
+Result spawn(const char *self, const char *motion, bool compensated) {
+  std::string command = std::string(self) + " --trial " + motion +
+                        (compensated ? " 1" : " 0");
+  FILE *pipe = popen(command.c_str(), "r");
+  Result result{0, NAN};
+  if (pipe == nullptr ||
+      std::fscanf(pipe, "%u %lf", &result.settle, &result.error) != 2) {
+    std::fprintf(stderr, "trial %s failed\n", command.c_str());
+  }
+  if (pipe != nullptr) pclose(pipe);
+  return result;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc == 4 && !std::strcmp(argv[1], "--trial")) {
+    Result result = trial(argv[2], std::atoi(argv[3]));
+    std::printf("%u %f\n", result.settle, result.error);
+    std::fflush(stdout);
+    std::_Exit(0);
+  }
+
+  std::printf("%-14s %14s %14s %14s %14s\n", "motion", "settle ms",
+              "settle ms", "error", "error");
+  std::printf("%-14s %14s %14s %14s %14s\n", "", "measured", "compensated",
+              "measured", "compensated");
+  for (const char *motion : kMotions) {
+    Result measured = spawn(argv[0], motion, false);
+    Result compensated = spawn(argv[0], motion, true);
+    std::printf("%-14s %14u %14u %14.3f %14.3f\n", motion, measured.settle,
+                compensated.settle, measured.error, compensated.error);
+  }
+  return 0;
+}
@@ -0,0 +1,126 @@
+// Logging benchmark. Logs the same line of odometry telemetry through a LemLib
+// sink and through telemetry::Log, and reports the heap allocations and host
+// time each call takes. Both write to nowhere, so this measures what the
+// logging task pays, not the serial port. Then logs bursts faster than a slow
+// output drains under each overflow policy, and reports which lines got out.
+//
+//   usage: logging [--calls n]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+
+#include "main.h"
+
+namespace {
+std::size_t allocations = 0;
+
+// LemLib's sink formats with its own args, but sends nowhere
+class DiscardSink : public lemlib::BaseSink {
+ protected:
+  void sendMessage(const lemlib::Message &) override {}
+};
+
+const telemetry::Output kDiscard = {
+    []() -> std::size_t { return 2048; }, [](const char *, std::size_t) {}};
+
+// a slow channel that keeps what it is sent
+std::string received;
+const telemetry::Output kSlow = {
+    []() -> std::size_t { return 256; },
+    [](const char *bytes, std::size_t size) { received.append(bytes, size); }};
+
+struct Result {
+  double allocations; // per call
+  double mean;        // ns
+  double max;         // ns
+};
+
+template <typename F> Result measure(int calls, F &&f) {
+  std::size_t before = allocations;
+  double total = 0;
+  double max = 0;
+  for (int i = 0; i < calls; i++) {
+    auto start = std::chrono::steady_clock::now();
+    f(i);
+    double ns = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+    total += ns;
+    max = std::max(max, ns);
+  }
+  return {double(allocations - before) / calls, total / calls, max};
+}
+}  // namespace
+
+// Counts every allocation. The replacements allocate with malloc and free
+// with free, which is a matched pair, but GCC sees operator new's pointer
+// reach free once these are inlined and warns that they are mismatched
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void *operator new(std::size_t size) {
+  allocations++;
+  if (void *p = std::malloc(size == 0 ? 1 : size)) return p;
+  throw std::bad_alloc();
+}
+void *operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+#pragma GCC diagnostic pop
+
+int main(int argc, char **argv) {
+  int calls = 100000;
+  for (int i = 1; i + 1 < argc; i++) {
+    if (std::strcmp(argv[i], "--calls") == 0) calls = std::atoi(argv[++i]);
+  }
+
+  DiscardSink sink;
+  sink.setLowestLevel(lemlib::Level::INFO);
+  Result lemlib = measure(calls, [&](int i) {
+    sink.info("Chassis pose: x {:.3f}, y {:.3f}, theta {:.3f}", i * 0.1,
+              i * 0.2, i * 0.3);
+  });
+
+  telemetry::Log log(kDiscard);
+  Result fast = measure(calls, [&](int i) {
+    log.info("Chassis pose: x {:.3f}, y {:.3f}, theta {:.3f}", i * 0.1,
+             i * 0.2, i * 0.3);
+    // the drain task would write them out between control loop periods
+    if (i % 32 == 31) log.drain();
+  });
+
+  std::printf("%-14s %12s %10s %10s\n", "logger", "allocs/call", "mean ns",
+              "max ns");
+  std::printf("%-14s %12.2f %10.0f %10.0f\n", "lemlib sink",
+              lemlib.allocations, lemlib.mean, lemlib.max);
+  std::printf("%-14s %12.2f %10.0f %10.0f\n", "telemetry log",
+              fast.allocations, fast.mean, fast.max);
+  std::printf("%d calls, %u lines dropped\n", calls, log.getDropped());
+
+  // bursts faster than the output drains: which lines make it out
+  for (util::Overflow overflow :
+       {util::Overflow::DropNewest, util::Overflow::DropOldest}) {
+    telemetry::Log burst(kSlow, "", "\n", overflow);
+    received.clear();
+    for (int i = 0; i < 2000; i++) {
+      burst.info("line {}", i);
+      if (i % 100 == 99) burst.drain();
+    }
+    while (burst.drain() != 0) {}
+    std::size_t lines = std::count(received.begin(), received.end(), '\n');
+    std::string last = received.substr(
+        received.rfind('\n', received.size() - 2) + 1);
+    last.pop_back();
+    std::printf("%-12s %zu lines out, %u dropped, last \"%s\"\n",
+                overflow == util::Overflow::DropNewest ? "drop newest"
+                                                       : "drop oldest",
+                lines, burst.getDropped(), last.c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,187 @@
+// Drive mixer benchmark. Holds the sticks of arcade drive, at full throttle
+// and part turn and then partway on both, on a full battery and on a flat
+// one, and drives the motors through LemLib's arcade, through a
+// motion::DriveMixer that uses all the battery gives, one held to a voltage a
+// flat battery still gives under load, and one driving each side through the
+// feedforward. Reports, once the robot is up to speed, how fast it goes and
+// how sharply it turns, and how much each changes from the full battery to
+// the flat one. Then checks that the mixer's arcade desaturates full power
+// the same as LemLib's, over every stick position on a grid and a range of
+// biases
+//
+//   usage: mixer [--trial lemlib|mixer|held|feedforward full|part full|flat]
+//
+// Every trial runs in a fresh process, so each one starts from the same world
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "main.h"
+#include "sim/robot.h"
+#include "sim/world.h"
+
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::OdomSensors sensors;
+extern odom::Scheduler odometry;
+
+namespace {
+// the same gains as the profile benchmark, unused by driver control
+lemlib::ControllerSettings lateral(10, 0, 3, 3, 1, 100, 3, 500, 20);
+lemlib::ControllerSettings angular(2, 0, 10, 3, 1, 100, 3, 500, 0);
+// the feedforward the profile benchmark drives by, on both sides
+const motion::Feedforward kFeedforward = {12.7, 2.12, 0};
+
+// sticks, out of 127: throttle and turn
+struct Sticks {
+  const char *name;
+  int throttle;
+  int turn;
+};
+const Sticks kSticks[] = {{"full", 127, 60}, {"part", 80, 30}};
+// ms the sticks are held for, and the last ms of that measured over
+constexpr int kDrive = 3000;
+constexpr int kMeasure = 1000;
+
+const char *const kWays[] = {"lemlib", "mixer", "held", "feedforward"};
+const char *const kBatteries[] = {"full", "flat"};
+
+struct Result {
+  double speed;   // in/s
+  double turn;    // deg/s
+  double battery; // mV, while driving
+};
+
+motion::Chassis &chassis() {
+  static motion::Chassis chassis(drivetrain, lateral, angular, sensors);
+  return chassis;
+}
+
+Result trial(const std::string &way, const Sticks &sticks,
+             const std::string &battery) {
+  motion::Chassis &chassis = ::chassis();
+  sim::attachRobot();
+  odometry.calibrate();
+  odometry.setPose({0, 0, 0});
+  pros::delay(100);
+  if (battery == "flat") sim::world().battery().capacity = 0;
+  if (way == "mixer") chassis.setMixer({});
+  if (way == "held") chassis.setMixer({.maxVoltage = 10500});
+  if (way == "feedforward") {
+    chassis.setMixer(
+        {.left = kFeedforward, .right = kFeedforward, .topSpeed = 48});
+  }
+
+  Result result = {0, 0, 0};
+  int samples = 0;
+  for (int elapsed = 0; elapsed < kDrive; elapsed += 10) {
+    if (way == "lemlib") {
+      chassis.lemlib::Chassis::arcade(sticks.throttle, sticks.turn, true);
+    } else {
+      chassis.arcade(sticks.throttle, sticks.turn, true);
+    }
+    pros::delay(10);
+    if (elapsed >= kDrive - kMeasure) {
+      const sim::BodyState truth = sim::world().truth();
+      result.speed += std::fabs(truth.v);
+      result.turn += std::fabs(truth.omega);
+      result.battery += sim::world().battery().voltage;
+      samples++;
+    }
+  }
+  return {result.speed / samples, result.turn / samples,
+          result.battery / samples};
+}
+
+Result spawn(const char *self, const char *way, const char *sticks,
+             const char *battery) {
+  std::string command = std::string(self) + " --trial " + way + " " +
+                        sticks + " " + battery;
+  FILE *pipe = popen(command.c_str(), "r");
+  Result result{NAN, NAN, NAN};
+  if (pipe == nullptr ||
+      std::fscanf(pipe, "%lf %lf %lf", &result.speed, &result.turn,
+                  &result.battery) != 3) {
+    std::fprintf(stderr, "trial %s failed\n", command.c_str());
+  }
+  if (pipe != nullptr) pclose(pipe);
+  return result;
+}
+// The commanded mV of the first motor on each side
+std::pair<double, double> commanded() {
+  return {sim::world().motor(std::abs(drivetrain.leftMotors->get_port(0)))
+              .target,
+          sim::world().motor(std::abs(drivetrain.rightMotors->get_port(0)))
+              .target};
+}
+
+// How many stick positions and biases the mixer's arcade commands other than
+// LemLib's arcade does. The stalled motors sag even a full battery, so the
+// mixer is given a headroom that leaves its ceiling at full power whatever
+// the battery reads, and only full power desaturates
+int checkBias() {
+  motion::Chassis &chassis = ::chassis();
+  sim::attachRobot();
+  chassis.setMixer({.headroom = -12000});
+  int mismatches = 0;
+  for (float bias : {0.0f, 0.25f, 0.5f, 0.75f, 1.0f}) {
+    for (int throttle = -127; throttle <= 127; throttle += 7) {
+      for (int turn = -127; turn <= 127; turn += 7) {
+        chassis.lemlib::Chassis::arcade(throttle, turn, true, bias);
+        const std::pair<double, double> lemlib = commanded();
+        chassis.arcade(throttle, turn, true, bias);
+        const std::pair<double, double> mixer = commanded();
+        if (std::fabs(lemlib.first - mixer.first) > 1 ||
+            std::fabs(lemlib.second - mixer.second) > 1) {
+          mismatches++;
+        }
+      }
+    }
+  }
+  return mismatches;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc == 5 && !std::strcmp(argv[1], "--trial")) {
+    const Sticks *sticks = &kSticks[0];
+    for (const Sticks &each : kSticks) {
+      if (!std::strcmp(argv[3], each.name)) sticks = &each;
+    }
+    Result result = trial(argv[2], *sticks, argv[4]);
+    std::printf("%f %f %f\n", result.speed, result.turn, result.battery);
+    std::fflush(stdout);
+    std::_Exit(0);
+  }
+
+  std::printf("%-12s %-6s %-7s %10s %10s %10s %10s\n", "drive", "sticks",
+              "battery", "battery mV", "in/s", "deg/s", "deg/in");
+  for (const Sticks &sticks : kSticks) {
+    for (const char *way : kWays) {
+      Result results[std::size(kBatteries)];
+      for (std::size_t i = 0; i < std::size(kBatteries); i++) {
+        results[i] = spawn(argv[0], way, sticks.name, kBatteries[i]);
+        std::printf("%-12s %-6s %-7s %10.0f %10.2f %10.2f %10.3f\n", way,
+                    sticks.name, kBatteries[i], results[i].battery,
+                    results[i].speed, results[i].turn,
+                    results[i].turn / results[i].speed);
+      }
+      // how much slower, and how much less or more sharply, the flat battery
+      // drives than the full one
+      std::printf("%-12s %-6s %-7s %10s %9.1f%% %9.1f%% %9.1f%%\n", way,
+                  sticks.name, "change", "",
+                  100 * (results[1].speed / results[0].speed - 1),
+                  100 * (results[1].turn / results[0].turn - 1),
+                  100 * (results[1].turn / results[1].speed /
+                             (results[0].turn / results[0].speed) -
+                         1));
+    }
+  }
+  std::printf("%d stick positions desaturate differently from LemLib's "
+              "arcade\n",
+              checkBias());
+  return 0;
+}
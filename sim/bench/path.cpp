@@ -0,0 +1,108 @@
+// Path startup benchmark. Times what a motion has to do before it can follow
+// a path: parsing LemLib's path text, the way its follow does, against opening
+// the same path in the binary format, and indexing a path tarball against
+// looking a path up in the index. Then follows the binary path in the
+// simulator and reports how close to its end the robot stopped.
+//
+//   usage: path
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "main.h"
+#include "sim/robot.h"
+#include "sim/world.h"
+
+extern motion::Chassis chassis;
+extern odom::Scheduler odometry;
+
+ASSET(example_txt);
+ASSET(example_path);
+ASSET(my_lemlib_tarball_file_txt);
+
+namespace {
+constexpr int kRepeats = 1000;
+
+// LemLib's path text parser: split into lines, then each line on ", "
+std::vector<lemlib::Pose> parseText(const asset &file) {
+  std::vector<lemlib::Pose> points;
+  std::string text(reinterpret_cast<char *>(file.buf), file.size);
+  std::size_t start = 0;
+  while (start < text.size()) {
+    std::size_t end = text.find('\n', start);
+    if (end == std::string::npos) end = text.size();
+    std::string line = text.substr(start, end - start);
+    start = end + 1;
+    if (line.rfind("endData", 0) == 0) break;
+    std::vector<std::string> fields;
+    std::size_t from = 0;
+    for (std::size_t comma; (comma = line.find(", ", from)) != std::string::npos;
+         from = comma + 2) {
+      fields.push_back(line.substr(from, comma - from));
+    }
+    fields.push_back(line.substr(from));
+    if (fields.size() != 3) continue;
+    points.emplace_back(std::stof(fields[0]), std::stof(fields[1]),
+                        std::stof(fields[2]));
+  }
+  return points;
+}
+
+template <typename F> double nanoseconds(F &&f) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRepeats; i++) f();
+  return std::chrono::duration<double, std::nano>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         kRepeats;
+}
+}  // namespace
+
+int main() {
+  std::size_t textPoints = 0;
+  std::size_t binaryPoints = 0;
+  double text = nanoseconds([&] { textPoints = parseText(example_txt).size(); });
+  double binary = nanoseconds([&] {
+    binaryPoints = path::BinaryPath(example_path).size();
+  });
+  std::printf("%-8s %8s %14s %10s\n", "format", "points", "startup ns",
+              "bytes");
+  std::printf("%-8s %8zu %14.0f %10zu\n", "text", textPoints, text,
+              example_txt.size);
+  std::printf("%-8s %8zu %14.0f %10zu\n", "binary", binaryPoints, binary,
+              example_path.size);
+
+  path::Tarball tarball(my_lemlib_tarball_file_txt);
+  double index = nanoseconds(
+      [&] { tarball = path::Tarball(my_lemlib_tarball_file_txt); });
+  std::size_t found = 0;
+  double lookup = nanoseconds([&] { found += tarball.get("Path 2").size; });
+  std::printf("tarball of %zu paths: index %.0f ns, lookup %.0f ns\n",
+              tarball.size(), index, lookup);
+
+  sim::attachRobot();
+  odometry.calibrate();
+  odometry.setPose({0, 0, 0});
+  path::BinaryPath route(example_path);
+  std::uint32_t start = pros::millis();
+  chassis.follow(route, 15, 10000);
+  chassis.waitUntilDone();
+  std::uint32_t elapsed = pros::millis() - start;
+  pros::delay(500);
+  sim::BodyState truth = sim::world().truth();
+  // paths end at their first stop; the points after it only extend the last
+  // segment for the lookahead
+  std::size_t stop = 0;
+  while (stop + 1 < route.size() && route[stop].speed != 0) stop++;
+  path::Point end = route[stop];
+  std::printf("followed %.1f in in %u ms, ending %.2f in from the path's end\n",
+              end.distance, elapsed,
+              std::hypot(truth.x - end.x, truth.y - end.y));
+  std::fflush(stdout);
+  // the robot program's tasks never return, so leave without unwinding them
+  std::_Exit(0);
+}
@@ -0,0 +1,178 @@
+// Motion profile benchmark. Drives the same routine of moves with LemLib's
+// moveToPoint and moveToPose, and with their profiled versions in
+// motion::Chassis, and compares how long the routine takes, where it ends, and
+// the hardest the robot accelerates along the way. Both use the same PID gains
+// and exit conditions. The routine is only points: the LemLib the host build
+// is linked against may not turn to a pose's heading, which would flatter it
+//
+//   usage: profile [--trial lemlib|profiled | --characterize]
+//
+// --characterize drives the simulated robot at a range of fixed powers and
+// fits the feedforward gains the profiled moves use. Every trial runs in a
+// fresh process, so each one starts from the same world
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "main.h"
+#include "sim/robot.h"
+#include "sim/world.h"
+
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::OdomSensors sensors;
+extern odom::Scheduler odometry;
+
+namespace {
+// tuned well enough to settle, with exits that end the motions once they have
+lemlib::ControllerSettings lateral(10, 0, 3, 3, 1, 100, 3, 500, 20);
+lemlib::ControllerSettings angular(2, 0, 10, 3, 1, 100, 3, 500, 0);
+// The feedforward from --characterize. The constraints are the ones the
+// routine ran fastest with. The robot still accelerates up to a fifth harder
+// than the limit: near top speed the motors cannot give the limit, the robot
+// falls behind the profile, and the PID brakes harder than the profile slows
+// to catch it up. Acceleration is also held 10 ms at a time
+motion::ProfileSettings profiled({48, 200, 6000}, {12.7, 2.12, 0.27});
+
+constexpr int kTimeout = 5000;
+// power --characterize fits kA at, under what the sagging battery can give
+constexpr int kAccelPower = 80;
+
+// one move of the routine: to a point, or to a pose when heading is set
+struct Move {
+  float x;
+  float y;
+  float heading; // degrees, NAN for a point
+  bool forwards;
+};
+
+const Move kRoutine[] = {{0, 36, NAN, true},
+                         {0, 6, NAN, false},
+                         {24, 48, NAN, true},
+                         {24, 12, NAN, false},
+                         {0, 0, NAN, true}};
+
+struct Result {
+  std::uint32_t time; // ms
+  double error;       // inches from the last move's target
+  double peak;        // largest forward acceleration, in/s^2
+};
+
+void setup() {
+  sim::attachRobot();
+  odometry.calibrate();
+  odometry.setPose({0, 0, 0});
+  pros::delay(100);
+}
+
+Result trial(bool profile) {
+  static motion::Chassis chassis(drivetrain, lateral, angular, sensors,
+                                 profiled);
+  setup();
+  double peak = 0;
+  std::uint32_t start = pros::millis();
+  for (const Move &move : kRoutine) {
+    if (std::isnan(move.heading)) {
+      if (profile) {
+        chassis.profiledMoveToPoint(move.x, move.y, kTimeout,
+                                    {.forwards = move.forwards});
+      } else {
+        chassis.moveToPoint(move.x, move.y, kTimeout,
+                            {.forwards = move.forwards});
+      }
+    } else if (profile) {
+      chassis.profiledMoveToPose(move.x, move.y, move.heading, kTimeout,
+                                 {.forwards = move.forwards});
+    } else {
+      chassis.moveToPose(move.x, move.y, move.heading, kTimeout,
+                         {.forwards = move.forwards});
+    }
+    while (chassis.isInMotion()) {
+      peak = std::max(peak, std::fabs(double(sim::world().truth().accel)));
+      pros::delay(5);
+    }
+  }
+  std::uint32_t time = pros::millis() - start;
+  // let the robot come to rest before measuring where it ended up
+  pros::delay(500);
+  sim::BodyState truth = sim::world().truth();
+  const Move &last = kRoutine[std::size(kRoutine) - 1];
+  return {time, std::hypot(truth.x - last.x, truth.y - last.y), peak};
+}
+
+// Fits power = kS + kV * velocity to the speeds the robot settles at, then kA
+// to the acceleration at the start of a run. The run is not at full power:
+// the battery sags under six stalled motors, the motors then get less than
+// they are asked for, and kA would come out too large
+void characterize() {
+  setup();
+  double sumV = 0, sumP = 0, sumVV = 0, sumVP = 0;
+  int n = 0;
+  for (int power = 20; power <= 120; power += 20) {
+    drivetrain.leftMotors->move(power);
+    drivetrain.rightMotors->move(power);
+    pros::delay(1500);
+    double v = sim::world().truth().v;
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    pros::delay(1500);
+    sumV += v;
+    sumP += power;
+    sumVV += v * v;
+    sumVP += v * power;
+    n++;
+  }
+  double kV = (n * sumVP - sumV * sumP) / (n * sumVV - sumV * sumV);
+  double kS = (sumP - kV * sumV) / n;
+
+  drivetrain.leftMotors->move(kAccelPower);
+  drivetrain.rightMotors->move(kAccelPower);
+  pros::delay(100);
+  sim::BodyState state = sim::world().truth();
+  double kA = (kAccelPower - kS - kV * state.v) / state.accel;
+  drivetrain.leftMotors->move(0);
+  drivetrain.rightMotors->move(0);
+  std::printf("kS %.2f, kV %.3f per in/s, kA %.4f per in/s^2\n", kS, kV, kA);
+  std::printf("top speed %.1f in/s, acceleration from rest %.0f in/s^2\n",
+              (127 - kS) / kV, (127 - kS) / kA);
+}
+
+Result spawn(const char *self, bool profile) {
+  std::string command =
+      std::string(self) + " --trial " + (profile ? "profiled" : "lemlib");
+  FILE *pipe = popen(command.c_str(), "r");
+  Result result{0, NAN, NAN};
+  if (pipe == nullptr || std::fscanf(pipe, "%u %lf %lf", &result.time,
+                                     &result.error, &result.peak) != 3) {
+    std::fprintf(stderr, "trial %s failed\n", command.c_str());
+  }
+  if (pipe != nullptr) pclose(pipe);
+  return result;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc == 3 && !std::strcmp(argv[1], "--trial")) {
+    Result result = trial(!std::strcmp(argv[2], "profiled"));
+    std::printf("%u %f %f\n", result.time, result.error, result.peak);
+    std::fflush(stdout);
+    std::_Exit(0);
+  }
+  if (argc == 2 && !std::strcmp(argv[1], "--characterize")) {
+    characterize();
+    std::fflush(stdout);
+    std::_Exit(0);
+  }
+
+  std::printf("%-10s %10s %10s %12s\n", "moves", "routine ms", "error",
+              "peak accel");
+  for (bool profile : {false, true}) {
+    Result result = spawn(argv[0], profile);
+    std::printf("%-10s %10u %10.3f %12.0f\n", profile ? "profiled" : "lemlib",
+                result.time, result.error, result.peak);
+  }
+  return 0;
+}
@@ -0,0 +1,197 @@
+// Pure pursuit search benchmark. Times the closest point and lookahead
+// searches of one control step, done LemLib's way over the whole path and
+// through path::PathIndex, at poses an inch beside the example path and beside
+// synthetic paths of up to 10000 points, and making the index. Then times
+// finding the closest point for a robot that has left the path, by looking at
+// every point and through the index's tree, and checks that each way finds the
+// same points.
+//
+//   usage: pursuit
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "main.h"
+
+ASSET(example_path);
+
+namespace {
+constexpr float kLookahead = 15;
+constexpr int kRepeats = 20;
+
+// A gentle wave along x, a point every half inch, converted the same way
+// tools/pathConverter.cpp would. Keeps the bytes the path reads in place
+std::vector<std::uint8_t> wave(std::size_t count) {
+  std::vector<path::Point> points;
+  float distance = 0;
+  for (std::size_t i = 0; i < count; i++) {
+    float x = i * 0.5f;
+    float y = 12 * std::sin(x / 20);
+    if (i > 0) {
+      distance += std::hypot(x - points.back().x, y - points.back().y);
+    }
+    points.push_back({x, y, i + 1 < count ? 100.0f : 0.0f, distance, 0});
+  }
+  path::Header header = {path::kMagic, path::kVersion, sizeof(path::Point),
+                         std::uint32_t(count), distance};
+  std::vector<std::uint8_t> bytes(sizeof(header) +
+                                  count * sizeof(path::Point));
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  std::memcpy(bytes.data() + sizeof(header), points.data(),
+              count * sizeof(path::Point));
+  return bytes;
+}
+
+std::size_t linearClosest(const path::BinaryPath &path,
+                          const lemlib::Pose &pose) {
+  std::size_t closest = 0;
+  float closestDistance = INFINITY;
+  for (std::size_t i = 0; i < path.size(); i++) {
+    path::Point point = path[i];
+    float d = std::hypot(point.x - pose.x, point.y - pose.y);
+    if (d < closestDistance) {
+      closest = i;
+      closestDistance = d;
+    }
+  }
+  return closest;
+}
+
+// LemLib's step: the closest point over the whole path, then the lookahead
+// circle from the last lookahead to the end
+struct LemLibStep {
+  const path::BinaryPath &path;
+  std::size_t lastSegment = 0;
+
+  std::size_t operator()(const lemlib::Pose &pose) {
+    std::size_t closest = linearClosest(path, pose);
+    for (std::size_t i = std::max(closest, lastSegment); i + 1 < path.size();
+         i++) {
+      path::Point p1 = path[i];
+      path::Point p2 = path[i + 1];
+      float dx = p2.x - p1.x, dy = p2.y - p1.y;
+      float fx = p1.x - pose.x, fy = p1.y - pose.y;
+      float a = dx * dx + dy * dy;
+      float b = 2 * (fx * dx + fy * dy);
+      float c = fx * fx + fy * fy - kLookahead * kLookahead;
+      float discriminant = b * b - 4 * a * c;
+      if (discriminant < 0 || a == 0) continue;
+      discriminant = std::sqrt(discriminant);
+      float t = (-b + discriminant) / (2 * a);
+      if (t < 0 || t > 1) t = (-b - discriminant) / (2 * a);
+      if (t < 0 || t > 1) continue;
+      lastSegment = i;
+      break;
+    }
+    return closest + lastSegment;
+  }
+};
+
+struct IndexStep {
+  path::PathIndex index;
+
+  std::size_t operator()(const lemlib::Pose &pose) {
+    std::size_t closest = index.closest(pose);
+    return closest + std::size_t(index.lookahead(pose, kLookahead).theta);
+  }
+};
+
+// poses along the path, an inch to its left, a control step apart at about
+// 50 in/s
+std::vector<lemlib::Pose> drive(const path::BinaryPath &path) {
+  std::vector<lemlib::Pose> poses;
+  float next = 0;
+  for (std::size_t i = 0; i + 1 < path.size(); i++) {
+    path::Point a = path[i];
+    path::Point b = path[i + 1];
+    if (a.distance < next) continue;
+    float heading = std::atan2(b.y - a.y, b.x - a.x);
+    poses.emplace_back(a.x - std::sin(heading), a.y + std::cos(heading),
+                       M_PI / 2 - heading);
+    next = a.distance + 0.5f;
+  }
+  return poses;
+}
+
+template <typename F> double nanoseconds(std::size_t calls, F &&f) {
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < kRepeats; r++) f();
+  return std::chrono::duration<double, std::nano>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         (double(kRepeats) * calls);
+}
+
+void compare(const char *name, const asset &file) {
+  path::BinaryPath path(file);
+  std::vector<lemlib::Pose> poses = drive(path);
+  volatile std::size_t sink = 0;
+
+  double lemlib = nanoseconds(poses.size(), [&] {
+    LemLibStep step{path};
+    for (const lemlib::Pose &pose : poses) sink = sink + step(pose);
+  });
+  double indexed = nanoseconds(poses.size(), [&] {
+    IndexStep step{path::PathIndex(path)};
+    for (const lemlib::Pose &pose : poses) sink = sink + step(pose);
+  });
+
+  // the same closest points, step by step
+  std::size_t mismatches = 0;
+  path::PathIndex index(path);
+  for (const lemlib::Pose &pose : poses) {
+    if (index.closest(pose) != linearClosest(path, pose)) mismatches++;
+  }
+
+  // making the index builds its tree, once at the start of a motion
+  double build = nanoseconds(1, [&] {
+    path::PathIndex fresh(path);
+    sink = sink + fresh.getFallbacks();
+  });
+
+  // poses well off the path, so every search falls back
+  std::vector<lemlib::Pose> lost;
+  for (std::size_t i = 0; i < poses.size(); i += 7) {
+    lost.emplace_back(poses[i].x, poses[i].y + (i % 2 ? 40 : -40), 0);
+  }
+  path::PathIndex far(path);
+  double linear = nanoseconds(lost.size(), [&] {
+    for (const lemlib::Pose &pose : lost) {
+      sink = sink + linearClosest(path, pose);
+    }
+  });
+  double tree = nanoseconds(lost.size(), [&] {
+    for (const lemlib::Pose &pose : lost) sink = sink + far.closest(pose);
+  });
+  for (const lemlib::Pose &pose : lost) {
+    path::PathIndex fresh(path);
+    if (fresh.closest(pose) != linearClosest(path, pose)) mismatches++;
+  }
+
+  std::printf("%-9s %7zu %10.0f %10.0f %10.0f %12.0f %12.0f %5zu\n", name,
+              path.size(), lemlib, indexed, build, linear, tree, mismatches);
+}
+}  // namespace
+
+int main() {
+  std::printf("%-9s %7s %10s %10s %10s %12s %12s %5s\n", "path", "points",
+              "lemlib ns", "index ns", "build ns", "lost all ns",
+              "lost tree ns", "diff");
+  compare("example", example_path);
+  for (std::size_t count : {100, 1000, 10000}) {
+    std::vector<std::uint8_t> bytes = wave(count);
+    asset file = {bytes.data(), bytes.size()};
+    char name[16];
+    std::snprintf(name, sizeof(name), "wave%zu", count);
+    compare(name, file);
+  }
+  std::fflush(stdout);
+  // the robot program's tasks never return, so leave without unwinding them
+  std::_Exit(0);
+}
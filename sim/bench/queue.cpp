@@ -0,0 +1,180 @@
+// Motion queue benchmark. Drives the same route of points four ways: with
+// LemLib's moveToPoint stopping at each, chained with LemLib's minSpeed and
+// earlyExitRange, with the profiled moves stopping at each, and queued as one
+// route in motion::Chassis that blends through the points. Reports how long the
+// route takes, how much of that the robot spends nearly stopped, and where it
+// ends. Then queues more motions than the queue holds behind a LemLib move
+// still running, and reports how long the queueing took and how many were
+// turned away
+//
+//   usage: queue [--trial lemlib|chained|profiled|queued | --enqueue]
+//
+// Every trial runs in a fresh process, so each one starts from the same world
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "main.h"
+#include "sim/robot.h"
+#include "sim/world.h"
+
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::OdomSensors sensors;
+extern odom::Scheduler odometry;
+
+namespace {
+// the same gains, exits and profile settings as the profile benchmark
+lemlib::ControllerSettings lateral(10, 0, 3, 3, 1, 100, 3, 500, 20);
+lemlib::ControllerSettings angular(2, 0, 10, 3, 1, 100, 3, 500, 0);
+motion::ProfileSettings profiled({48, 200, 6000}, {12.7, 2.12, 0.27});
+
+constexpr int kTimeout = 5000;
+// what chained LemLib moves keep driving at through a point, out of 127, and
+// how far before it they hand on
+constexpr float kMinSpeed = 60;
+constexpr float kEarlyExit = 4;
+// what queued moves hand on at, in/s
+constexpr float kExitSpeed = 40;
+// below this, in/s, the robot counts as stopped
+constexpr double kStopped = 5;
+
+struct Point {
+  float x;
+  float y;
+};
+
+// corners of 45 and 90 degrees, all driven forwards
+const Point kRoute[] = {{0, 30}, {24, 54}, {54, 54}, {54, 18}, {30, 0}};
+
+const char *const kWays[] = {"lemlib", "chained", "profiled", "queued"};
+
+struct Result {
+  std::uint32_t time;    // ms
+  std::uint32_t stopped; // ms below kStopped after starting
+  double miss;           // furthest the robot passed from a point on the way
+  double error;          // inches from the last point
+};
+
+Result trial(const std::string &way) {
+  static motion::Chassis chassis(drivetrain, lateral, angular, sensors,
+                                 profiled);
+  sim::attachRobot();
+  odometry.calibrate();
+  odometry.setPose({0, 0, 0});
+  pros::delay(100);
+
+  // Sampled alongside the moves. The robot only counts as stopped between
+  // points once it has got going
+  std::uint32_t stopped = 0;
+  double closest[std::size(kRoute)];
+  std::fill(std::begin(closest), std::end(closest), INFINITY);
+  bool done = false;
+  pros::Task sampler([&]() {
+    bool moving = false;
+    while (!done) {
+      sim::BodyState truth = sim::world().truth();
+      double speed = std::fabs(truth.v);
+      if (speed > kStopped) moving = true;
+      if (moving && speed < kStopped) stopped += 5;
+      for (std::size_t i = 0; i < std::size(kRoute); i++) {
+        closest[i] = std::min(closest[i], std::hypot(truth.x - kRoute[i].x,
+                                                     truth.y - kRoute[i].y));
+      }
+      pros::delay(5);
+    }
+  });
+
+  const std::uint32_t start = pros::millis();
+  const std::size_t last = std::size(kRoute) - 1;
+  for (std::size_t i = 0; i <= last; i++) {
+    const Point &point = kRoute[i];
+    if (way == "lemlib") {
+      chassis.moveToPoint(point.x, point.y, kTimeout, {}, false);
+    } else if (way == "chained") {
+      chassis.moveToPoint(point.x, point.y, kTimeout,
+                          {.minSpeed = i < last ? kMinSpeed : 0,
+                           .earlyExitRange = i < last ? kEarlyExit : 0},
+                          false);
+    } else if (way == "profiled") {
+      chassis.profiledMoveToPoint(point.x, point.y, kTimeout, {}, false);
+    } else {
+      chassis.queueMoveToPoint(point.x, point.y, kTimeout,
+                               {.exitSpeed = kExitSpeed});
+    }
+  }
+  chassis.waitUntilDone();
+  done = true;
+  std::uint32_t time = pros::millis() - start;
+  // let the robot come to rest before measuring where it ended up
+  pros::delay(500);
+  sim::BodyState truth = sim::world().truth();
+  return {time, stopped, *std::max_element(closest, closest + last),
+          std::hypot(truth.x - kRoute[last].x, truth.y - kRoute[last].y)};
+}
+
+// ms the caller spent queueing, and how many motions came back done
+void enqueue() {
+  static motion::Chassis chassis(drivetrain, lateral, angular, sensors,
+                                 profiled);
+  sim::attachRobot();
+  odometry.calibrate();
+  odometry.setPose({0, 0, 0});
+  pros::delay(100);
+  chassis.moveToPoint(0, 24, kTimeout);
+  const std::uint32_t start = pros::millis();
+  int refused = 0;
+  for (int i = 0; i < 20; i++) {
+    if (chassis.queueMoveToPoint(0, 24 + i, kTimeout).isDone()) refused++;
+  }
+  std::printf("queueing 20 motions behind a running move took %u ms, %d "
+              "turned away\n",
+              pros::millis() - start, refused);
+}
+
+Result spawn(const char *self, const char *way) {
+  std::string command = std::string(self) + " --trial " + way;
+  FILE *pipe = popen(command.c_str(), "r");
+  Result result{0, 0, NAN, NAN};
+  if (pipe == nullptr ||
+      std::fscanf(pipe, "%u %u %lf %lf", &result.time, &result.stopped,
+                  &result.miss, &result.error) != 4) {
+    std::fprintf(stderr, "trial %s failed\n", command.c_str());
+  }
+  if (pipe != nullptr) pclose(pipe);
+  return result;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc == 3 && !std::strcmp(argv[1], "--trial")) {
+    Result result = trial(argv[2]);
+    std::printf("%u %u %f %f\n", result.time, result.stopped, result.miss,
+                result.error);
+    std::fflush(stdout);
+    std::_Exit(0);
+  }
+  if (argc == 2 && !std::strcmp(argv[1], "--enqueue")) {
+    enqueue();
+    std::fflush(stdout);
+    std::_Exit(0);
+  }
+
+  std::printf("%-10s %10s %10s %10s %10s\n", "moves", "route ms", "stopped ms",
+              "miss", "error");
+  for (const char *way : kWays) {
+    Result result = spawn(argv[0], way);
+    std::printf("%-10s %10u %10u %10.3f %10.3f\n", way, result.time,
+                result.stopped, result.miss, result.error);
+  }
+  std::fflush(stdout);
+  const std::string command = std::string(argv[0]) + " --enqueue";
+  if (std::system(command.c_str()) != 0) {
+    std::fprintf(stderr, "%s failed\n", command.c_str());
+  }
+  return 0;
+}
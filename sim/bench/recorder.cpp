@@ -0,0 +1,132 @@
+// Flight recorder benchmark. Records full rate drivetrain samples to a
+// simulated SD card in a temporary directory for a stretch of match time,
+// rotating files every 64 KB, and reports what sending a sample costs the
+// sending task, how much was written and dropped, and whether each file's
+// index agrees with its block headers, both halfway through, as the power
+// going would leave it, and once recording stops.
+//
+//   usage: recorder [--seconds n]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "main.h"
+#include "sim/card.h"
+#include "sim/robot.h"
+
+namespace {
+constexpr std::size_t kFileSize = 64 * 1024;
+
+std::vector<char> readFile(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<char>((std::istreambuf_iterator<char>(in)),
+                           std::istreambuf_iterator<char>());
+}
+
+struct IndexCheck {
+  int files;
+  std::size_t entries;
+  std::size_t mismatched;
+};
+
+// every index entry should match the header of the block it points at
+IndexCheck checkIndex(const char *directory) {
+  IndexCheck check = {0, 0, 0};
+  for (;; check.files++) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s/bench%03d", directory, check.files);
+    std::vector<char> file = readFile(std::string(name) + ".tlm");
+    if (file.empty()) break;
+    std::vector<char> index = readFile(std::string(name) + ".idx");
+    for (std::size_t i = 0; i + sizeof(telemetry::IndexEntry) <= index.size();
+         i += sizeof(telemetry::IndexEntry)) {
+      telemetry::IndexEntry entry;
+      std::memcpy(&entry, index.data() + i, sizeof(entry));
+      telemetry::BlockHeader header = {};
+      if (std::size_t(entry.block + 1) * telemetry::kBlockSize <= file.size()) {
+        std::memcpy(&header, file.data() + entry.block * telemetry::kBlockSize,
+                    sizeof(header));
+      }
+      check.entries++;
+      if (header.magic != telemetry::kBlockMagic ||
+          header.firstTime != entry.firstTime ||
+          header.lastTime != entry.lastTime) {
+        check.mismatched++;
+      }
+    }
+  }
+  return check;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  int seconds = 15;
+  for (int i = 1; i + 1 < argc; i++) {
+    if (std::strcmp(argv[i], "--seconds") == 0) seconds = std::atoi(argv[++i]);
+  }
+  char directory[] = "/tmp/recorderXXXXXX";
+  if (mkdtemp(directory) == nullptr) {
+    std::perror("mkdtemp");
+    return 1;
+  }
+  sim::attachRobot();
+  sim::mountCard(directory);
+
+  telemetry::Recorder recorder("/usd", kFileSize);
+  if (!recorder.start("bench")) {
+    std::fprintf(stderr, "cannot start recording in %s\n", directory);
+    return 1;
+  }
+  double total = 0;
+  double max = 0;
+  int sent = 0;
+  std::uint32_t wake = pros::millis();
+  for (int i = 0; i < seconds * 100; i++) {
+    auto start = std::chrono::steady_clock::now();
+    recorder.send(telemetry::kPoseChannel, {i * 0.1f, i * 0.2f, i * 0.3f});
+    for (std::uint8_t channel :
+         {telemetry::kVelocityChannel, telemetry::kMotorChannel}) {
+      recorder.send(channel, {1.0f * i, 2.0f * i, 3.0f * i, 4.0f * i,
+                              5.0f * i, 6.0f * i});
+    }
+    double ns = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+    total += ns;
+    max = std::max(max, ns);
+    sent += 3;
+    pros::Task::delay_until(&wake, 10);
+    if (i == seconds * 50) {
+      const std::uint32_t blocks = recorder.getBlocks();
+      const IndexCheck check = checkIndex(directory);
+      std::printf("halfway, still recording: %u blocks written, %zu index "
+                  "entries, %zu mismatched\n",
+                  blocks, check.entries, check.mismatched);
+    }
+  }
+  auto start = std::chrono::steady_clock::now();
+  recorder.stop();
+  double stop = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+
+  std::printf("sent %d samples: %.0f ns mean per sample, %.0f ns max for a "
+              "tick's three\n",
+              sent, total / sent, max);
+  std::printf("%u blocks written, %u samples dropped, stop took %.2f ms\n",
+              recorder.getBlocks(), recorder.getDropped(), stop);
+
+  const IndexCheck check = checkIndex(directory);
+  std::printf("%d files in %s, %zu index entries, %zu mismatched\n",
+              check.files, directory, check.entries, check.mismatched);
+  std::fflush(stdout);
+  // the robot program's tasks never return, so leave without unwinding them
+  std::_Exit(0);
+}
@@ -0,0 +1,169 @@
+// Settle detection benchmark. Drives a square of profiled moves and turns,
+// ending each motion on LemLib's exit conditions, on motion::SettleCondition,
+// which also watches the robot's speed, and on a SettleCondition that also
+// predicts when the robot will come to rest. It drives the square on the
+// angular gains the other benchmarks share, whose turns settle inside a
+// degree, and on a stiffer kP whose turns overshoot and stop a couple of
+// degrees past. Reports how long the routine takes, how far from each target,
+// and how fast, the robot was as its motion ended, and how far from the last
+// target it came to rest. Then turns by less than the stall range and
+// reports how far the robot turned and where it stopped
+//
+//   usage: settle [--trial lemlib|settle|predict shared|stiff | --short]
+//
+// Every trial runs in a fresh process, so each one starts from the same world
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "main.h"
+#include "sim/robot.h"
+#include "sim/world.h"
+
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::OdomSensors sensors;
+extern odom::Scheduler odometry;
+
+namespace {
+// the same gains, exits and profile settings as the profile benchmark
+lemlib::ControllerSettings lateral(10, 0, 3, 3, 1, 100, 3, 500, 20);
+lemlib::ControllerSettings angular(2, 0, 10, 3, 1, 100, 3, 500, 0);
+lemlib::ControllerSettings stiff(3, 0, 10, 3, 1, 100, 3, 500, 0);
+motion::ProfileSettings profiled({48, 200, 6000}, {12.7, 2.12, 0.27});
+// the same ranges as LemLib's small and large exits, without prediction
+const motion::SettleSettings kLateralSettle = {1, 2, 20, 3, 0};
+const motion::SettleSettings kAngularSettle = {1, 5, 20, 3, 0};
+// ms ahead the predicting exits look. Much further and they end turns while
+// the robot is still coming round fast enough to carry it past the range
+constexpr std::uint32_t kHorizon = 60;
+
+constexpr int kTimeout = 3000;
+constexpr float kSide = 24;
+
+const char *const kWays[] = {"lemlib", "settle", "predict"};
+const char *const kGains[] = {"shared", "stiff"};
+
+struct Result {
+  std::uint32_t time; // ms
+  double error;       // mean inches or degrees from each target at its end
+  double speed;       // mean in/s or deg/s at the end of each motion
+  double rest;        // inches from the last target, at rest
+};
+
+Result trial(const std::string &way, const std::string &gains) {
+  static motion::Chassis chassis(drivetrain, lateral, angular, sensors,
+                                 profiled);
+  sim::attachRobot();
+  odometry.calibrate();
+  odometry.setPose({0, 0, 0});
+  pros::delay(100);
+  chassis.setOdometry(odometry);
+  if (gains == "stiff") chassis.setAngularSettings(stiff);
+  if (way != "lemlib") {
+    motion::SettleSettings lateralSettle = kLateralSettle;
+    motion::SettleSettings angularSettle = kAngularSettle;
+    if (way == "predict") {
+      lateralSettle.horizon = kHorizon;
+      angularSettle.horizon = kHorizon;
+    }
+    chassis.setLateralSettle(lateralSettle);
+    chassis.setAngularSettle(angularSettle);
+  }
+
+  // the corners of the square, turning clockwise at each
+  const float corners[4][2] = {{0, kSide}, {kSide, kSide}, {kSide, 0}, {0, 0}};
+  double error = 0;
+  double speed = 0;
+  const std::uint32_t start = pros::millis();
+  for (int i = 0; i < 4; i++) {
+    chassis.profiledMoveToPoint(corners[i][0], corners[i][1], kTimeout, {},
+                                false);
+    sim::BodyState truth = sim::world().truth();
+    error += std::hypot(truth.x - corners[i][0], truth.y - corners[i][1]);
+    speed += std::fabs(truth.v);
+
+    const float heading = 90 * (i + 1);
+    chassis.turnToHeading(heading, kTimeout, {}, false);
+    truth = sim::world().truth();
+    error += std::fabs(std::remainder(truth.theta - heading, 360));
+    speed += std::fabs(truth.omega);
+  }
+  std::uint32_t time = pros::millis() - start;
+  pros::delay(500);
+  sim::BodyState truth = sim::world().truth();
+  return {time, error / 8, speed / 8, std::hypot(truth.x, truth.y)};
+}
+
+// A turn inside the stall range, which has to turn the robot to settle. The
+// profiled moves only check for settling once their profile has run, but a
+// turn checks from its first step
+void shortTurn() {
+  static motion::Chassis chassis(drivetrain, lateral, angular, sensors,
+                                 profiled);
+  sim::attachRobot();
+  odometry.calibrate();
+  odometry.setPose({0, 0, 0});
+  pros::delay(100);
+  chassis.setOdometry(odometry);
+  chassis.setAngularSettle(kAngularSettle);
+  const float angle = kAngularSettle.stallRange * 2 / 3;
+  const std::uint32_t start = pros::millis();
+  chassis.turnToHeading(angle, kTimeout, {}, false);
+  const std::uint32_t time = pros::millis() - start;
+  pros::delay(500);
+  const sim::BodyState truth = sim::world().truth();
+  std::printf("a %.0f deg turn, inside the %.0f deg stall range, turned %.3f "
+              "deg in %u ms and stopped %.3f deg from its target\n",
+              angle, kAngularSettle.stallRange, truth.theta, time,
+              std::fabs(truth.theta - angle));
+}
+
+Result spawn(const char *self, const char *way, const char *gains) {
+  std::string command =
+      std::string(self) + " --trial " + way + " " + gains;
+  FILE *pipe = popen(command.c_str(), "r");
+  Result result{0, NAN, NAN, NAN};
+  if (pipe == nullptr ||
+      std::fscanf(pipe, "%u %lf %lf %lf", &result.time, &result.error,
+                  &result.speed, &result.rest) != 4) {
+    std::fprintf(stderr, "trial %s failed\n", command.c_str());
+  }
+  if (pipe != nullptr) pclose(pipe);
+  return result;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc == 4 && !std::strcmp(argv[1], "--trial")) {
+    Result result = trial(argv[2], argv[3]);
+    std::printf("%u %f %f %f\n", result.time, result.error, result.speed,
+                result.rest);
+    std::fflush(stdout);
+    std::_Exit(0);
+  }
+  if (argc == 2 && !std::strcmp(argv[1], "--short")) {
+    shortTurn();
+    std::fflush(stdout);
+    std::_Exit(0);
+  }
+
+  std::printf("%-8s %-8s %10s %10s %10s %10s\n", "gains", "exits",
+              "routine ms", "exit error", "exit speed", "rest error");
+  for (const char *gains : kGains) {
+    for (const char *way : kWays) {
+      Result result = spawn(argv[0], way, gains);
+      std::printf("%-8s %-8s %10u %10.3f %10.3f %10.3f\n", gains, way,
+                  result.time, result.error, result.speed, result.rest);
+    }
+  }
+  std::fflush(stdout);
+  const std::string command = std::string(argv[0]) + " --short";
+  if (std::system(command.c_str()) != 0) {
+    std::fprintf(stderr, "%s failed\n", command.c_str());
+  }
+  return 0;
+}
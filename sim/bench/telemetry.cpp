@@ -0,0 +1,99 @@
+// Telemetry benchmark. Sends the same pose samples as LemLib-style text lines
+// and as binary frames, and reports the host time and serial bytes each takes,
+// how many samples a second either fits through the brain's 115200 baud
+// serial link, and the largest error in the binary samples once decoded.
+//
+//   usage: telemetry [--samples n]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "main.h"
+
+namespace {
+// 115200 baud with a start and stop bit per byte
+constexpr double kLinkBytesPerSecond = 115200.0 / 10;
+
+std::string received;
+const telemetry::Output kCapture = {
+    []() -> std::size_t { return 1 << 20; },
+    [](const char *bytes, std::size_t size) { received.append(bytes, size); }};
+
+lemlib::Pose sample(int i) {
+  return {float(std::sin(i * 0.01) * 60), float(std::cos(i * 0.013) * 60),
+          float(i * 0.7)};
+}
+
+struct Result {
+  double mean;  // ns per sample
+  double bytes; // per sample
+};
+
+template <typename F> Result measure(telemetry::Log &log, int samples, F &&f) {
+  received.clear();
+  double total = 0;
+  for (int i = 0; i < samples; i++) {
+    auto start = std::chrono::steady_clock::now();
+    f(i);
+    total += std::chrono::duration<double, std::nano>(
+                 std::chrono::steady_clock::now() - start)
+                 .count();
+    if (i % 32 == 31) log.drain();
+  }
+  log.drain();
+  return {total / samples, double(received.size()) / samples};
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  int samples = 100000;
+  for (int i = 1; i + 1 < argc; i++) {
+    if (std::strcmp(argv[i], "--samples") == 0) samples = std::atoi(argv[++i]);
+  }
+
+  telemetry::Log log(kCapture, "TELE_START", "TELE_END\n");
+  Result text = measure(log, samples, [&](int i) {
+    lemlib::Pose pose = sample(i);
+    log.info("Chassis pose: x {:.3f}, y {:.3f}, theta {:.3f}", pose.x, pose.y,
+             pose.theta);
+  });
+
+  telemetry::Stream stream(log);
+  Result binary = measure(log, samples, [&](int i) {
+    lemlib::Pose pose = sample(i);
+    stream.send(telemetry::kPoseChannel, {pose.x, pose.y, pose.theta});
+  });
+
+  std::printf("%-8s %10s %14s %14s\n", "format", "ns/sample", "bytes/sample",
+              "samples/s");
+  std::printf("%-8s %10.0f %14.1f %14.0f\n", "text", text.mean, text.bytes,
+              kLinkBytesPerSecond / text.bytes);
+  std::printf("%-8s %10.0f %14.1f %14.0f\n", "binary", binary.mean,
+              binary.bytes, kLinkBytesPerSecond / binary.bytes);
+
+  // decode what the stream sent and compare it with what it was given
+  std::size_t decoded = 0;
+  double error = 0;
+  std::size_t start = 0;
+  for (std::size_t i = 0; i < received.size(); i++) {
+    if (received[i] != 0) continue;
+    telemetry::Frame frame;
+    if (telemetry::decodeFrame(
+            reinterpret_cast<const std::uint8_t *>(received.data()) + start,
+            i - start, frame)) {
+      lemlib::Pose pose = sample(int(decoded++));
+      error = std::max({error, double(std::fabs(frame.values[0] - pose.x)),
+                        double(std::fabs(frame.values[1] - pose.y)),
+                        double(std::fabs(frame.values[2] - pose.theta))});
+    }
+    start = i + 1;
+  }
+  std::printf("decoded %zu of %d samples, largest error %.4f\n", decoded,
+              samples, error);
+  return 0;
+}
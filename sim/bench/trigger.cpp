@@ -0,0 +1,115 @@
+// Motion trigger benchmark. Drives one profiled move straight ahead and acts
+// at points along it three ways: waiting with LemLib's waitUntil, which polls
+// the distance travelled, waiting on the move's handle, which sleeps until the
+// move notifies it, and hanging the actions off the handle, which run from
+// the move's own control step. Reports how far past each point, and how long
+// after reaching it, the robot was when the action ran
+//
+//   usage: trigger [--trial poll|wait|action]
+//
+// Every trial runs in a fresh process, so each one starts from the same world
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "main.h"
+#include "sim/robot.h"
+#include "sim/world.h"
+
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::OdomSensors sensors;
+extern odom::Scheduler odometry;
+
+namespace {
+// the same gains, exits and profile settings as the profile benchmark
+lemlib::ControllerSettings lateral(10, 0, 3, 3, 1, 100, 3, 500, 20);
+lemlib::ControllerSettings angular(2, 0, 10, 3, 1, 100, 3, 500, 0);
+motion::ProfileSettings profiled({48, 250, 2500}, {12.7, 2.12, 0.3});
+
+constexpr float kLength = 60;
+const float kPoints[] = {6, 12, 18, 24, 30, 36, 42, 48};
+
+const char *const kWays[] = {"poll", "wait", "action"};
+
+struct Result {
+  double late; // mean inches past each point
+  double worst;
+  double ms; // mean ms past each point, at the speed there
+};
+
+Result trial(const std::string &way) {
+  static motion::Chassis chassis(drivetrain, lateral, angular, sensors,
+                                 profiled);
+  sim::attachRobot();
+  odometry.calibrate();
+  odometry.setPose({0, 0, 0});
+  pros::delay(100);
+
+  // where the robot was when each action ran. The actions run on the move's
+  // task, the waits on this one
+  double past[std::size(kPoints)];
+  double ms[std::size(kPoints)];
+  auto act = [&](std::size_t i) {
+    sim::BodyState truth = sim::world().truth();
+    past[i] = truth.y - kPoints[i];
+    ms[i] = 1000 * past[i] / truth.v;
+  };
+
+  motion::Handle move =
+      chassis.profiledMoveToPoint(0, kLength, 5000, {}, true);
+  for (std::size_t i = 0; i < std::size(kPoints); i++) {
+    if (way == "poll") {
+      chassis.waitUntil(kPoints[i]);
+      act(i);
+    } else if (way == "wait") {
+      move.waitUntil(kPoints[i]);
+      act(i);
+    } else {
+      move.atDistance(kPoints[i], [&act, i] { act(i); });
+    }
+  }
+  move.waitUntilDone();
+
+  Result result = {0, 0, 0};
+  for (std::size_t i = 0; i < std::size(kPoints); i++) {
+    result.late += past[i] / std::size(kPoints);
+    result.worst = std::max(result.worst, past[i]);
+    result.ms += ms[i] / std::size(kPoints);
+  }
+  return result;
+}
+
+Result spawn(const char *self, const char *way) {
+  std::string command = std::string(self) + " --trial " + way;
+  FILE *pipe = popen(command.c_str(), "r");
+  Result result{NAN, NAN, NAN};
+  if (pipe == nullptr || std::fscanf(pipe, "%lf %lf %lf", &result.late,
+                                     &result.worst, &result.ms) != 3) {
+    std::fprintf(stderr, "trial %s failed\n", command.c_str());
+  }
+  if (pipe != nullptr) pclose(pipe);
+  return result;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc == 3 && !std::strcmp(argv[1], "--trial")) {
+    Result result = trial(argv[2]);
+    std::printf("%f %f %f\n", result.late, result.worst, result.ms);
+    std::fflush(stdout);
+    std::_Exit(0);
+  }
+
+  std::printf("%-8s %10s %10s %10s\n", "trigger", "late in", "worst in",
+              "late ms");
+  for (const char *way : kWays) {
+    Result result = spawn(argv[0], way);
+    std::printf("%-8s %10.3f %10.3f %10.1f\n", way, result.late, result.worst,
+                result.ms);
+  }
+  return 0;
+}
@@ -0,0 +1,107 @@
+// PID autotuning benchmark. Runs the step tests of tune::Autotuner on the
+// angular and then the lateral PID three ways: with the hand-picked gains in
+// src/main.cpp, with the Ziegler-Nichols gains from the relay test alone, and
+// with the gains the full tuning settles on. Reports each loop's gains and how
+// its steps went: rise, overshoot and settling time, averaged over a step
+// there and back
+//
+//   usage: tune [--trial hand|relay|tuned]
+//
+// Every trial runs in a fresh process, so each one starts from the same world
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "main.h"
+#include "sim/robot.h"
+
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::OdomSensors sensors;
+extern odom::Scheduler odometry;
+extern lemlib::ControllerSettings linearController;
+extern lemlib::ControllerSettings angularController;
+
+namespace {
+const char *const kWays[] = {"hand", "relay", "tuned"};
+
+struct Result {
+  float kP;
+  float kD;
+  tune::StepResponse response;
+};
+
+// the angular loop first, since the lateral steps steer with it
+const tune::Loop kLoops[] = {tune::Loop::Angular, tune::Loop::Lateral};
+const tune::TuneSettings kSettings[] = {tune::kAngularTuning,
+                                        tune::kLateralTuning};
+
+void trial(const std::string &way, Result results[2]) {
+  static motion::Chassis chassis(drivetrain, linearController,
+                                 angularController, sensors);
+  sim::attachRobot();
+  odometry.calibrate();
+  odometry.setPose({0, 0, 0});
+  pros::delay(100);
+
+  tune::Autotuner tuner(chassis);
+  for (int i = 0; i < 2; i++) {
+    lemlib::ControllerSettings gains = kLoops[i] == tune::Loop::Lateral
+                                           ? chassis.getLateralSettings()
+                                           : chassis.getAngularSettings();
+    if (way == "relay") {
+      gains = tuner.relayGains(kLoops[i], kSettings[i]);
+    } else if (way == "tuned") {
+      gains = tuner.tune(kLoops[i], kSettings[i]);
+    }
+    results[i] = {gains.kP, gains.kD,
+                  tuner.step(kLoops[i], gains, kSettings[i])};
+  }
+}
+
+bool spawn(const char *self, const char *way, Result results[2]) {
+  std::string command = std::string(self) + " --trial " + way;
+  FILE *pipe = popen(command.c_str(), "r");
+  int read = 0;
+  for (int i = 0; pipe != nullptr && i < 2; i++) {
+    tune::StepResponse &response = results[i].response;
+    read += std::fscanf(pipe, "%f %f %f %f %f %f", &results[i].kP,
+                        &results[i].kD, &response.rise, &response.overshoot,
+                        &response.settle, &response.error);
+  }
+  if (pipe != nullptr) pclose(pipe);
+  if (read != 12) std::fprintf(stderr, "trial %s failed\n", command.c_str());
+  return read == 12;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc == 3 && !std::strcmp(argv[1], "--trial")) {
+    Result results[2];
+    trial(argv[2], results);
+    for (const Result &result : results) {
+      std::printf("%f %f %f %f %f %f\n", result.kP, result.kD,
+                  result.response.rise, result.response.overshoot,
+                  result.response.settle, result.response.error);
+    }
+    std::fflush(stdout);
+    std::_Exit(0);
+  }
+
+  std::printf("%-6s %-8s %9s %9s %9s %10s %9s %9s\n", "gains", "loop", "kP",
+              "kD", "rise ms", "overshoot", "settle ms", "error");
+  for (const char *way : kWays) {
+    Result results[2];
+    if (!spawn(argv[0], way, results)) continue;
+    for (int i = 0; i < 2; i++) {
+      const tune::StepResponse &response = results[i].response;
+      std::printf("%-6s %-8s %9.4f %9.4f %9.0f %10.3f %9.0f %9.3f\n", way,
+                  kLoops[i] == tune::Loop::Lateral ? "lateral" : "angular",
+                  results[i].kP, results[i].kD, response.rise,
+                  response.overshoot, response.settle, response.error);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,130 @@
+// Turn settling benchmark. Turns through a sweep of angles three ways: with
+// LemLib's angular PID on the gains the other benchmarks share, with LemLib's
+// PID on the gains sim/bench/tune.cpp finds for the simulated robot, and with
+// the gain-scheduled motion::Pid. Reports, for each angle, how long the turn
+// takes to settle within a degree for good and how far it overshoots
+//
+//   usage: turn [--trial lemlib|tuned|scheduled]
+//
+// Every trial runs in a fresh process, so each one starts from the same world
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "main.h"
+#include "sim/robot.h"
+#include "sim/world.h"
+
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::OdomSensors sensors;
+extern odom::Scheduler odometry;
+
+namespace {
+// the same gains and exits as the profile benchmark
+lemlib::ControllerSettings lateral(10, 0, 3, 3, 1, 100, 3, 500, 20);
+lemlib::ControllerSettings angular(2, 0, 10, 3, 1, 100, 3, 500, 0);
+// from sim/bench/tune.cpp, with the same exits
+lemlib::ControllerSettings tuned(24.2, 0, 122.8, 3, 1, 100, 3, 500, 0);
+// Tuned's gains far out, stiffer close in to push through friction near the
+// heading, and half as damped again turning at full speed
+motion::GainSchedule schedule(400, {{5, {40, 0, 120}, {40, 0, 180}},
+                                    {45, {24, 0, 120}, {24, 0, 180}}});
+// ms
+constexpr float kFilter = 5;
+
+// short of 180, which LemLib could turn either way
+const float kAngles[] = {10, 20, 45, 90, 135, 170};
+// ms each turn is watched for, and how close it has to stay to count as
+// settled
+constexpr std::uint32_t kWindow = 2000;
+constexpr double kTolerance = 1;
+
+const char *const kWays[] = {"lemlib", "tuned", "scheduled"};
+
+struct Result {
+  double settle[std::size(kAngles)]; // ms
+  double overshoot[std::size(kAngles)];
+};
+
+Result trial(const std::string &way) {
+  static motion::Chassis chassis(drivetrain, lateral, angular, sensors);
+  sim::attachRobot();
+  odometry.calibrate();
+  odometry.setPose({0, 0, 0});
+  pros::delay(100);
+  if (way == "tuned") chassis.setAngularSettings(tuned);
+  if (way == "scheduled") chassis.setTurnPid(motion::Pid(schedule, kFilter));
+
+  Result result;
+  double heading = 0;
+  for (std::size_t i = 0; i < std::size(kAngles); i++) {
+    // alternate the way round, so the robot stays about where it started
+    const double angle = i % 2 ? -kAngles[i] : kAngles[i];
+    heading += angle;
+    const std::uint32_t begin = pros::millis();
+    chassis.turnToHeading(heading, kWindow);
+    double settle = 0;
+    double overshoot = 0;
+    for (std::uint32_t elapsed = 0; elapsed < kWindow;
+         elapsed = pros::millis() - begin) {
+      // past the heading, the way the turn goes
+      double past =
+          (sim::world().truth().theta - heading) * (angle < 0 ? -1 : 1);
+      overshoot = std::max(overshoot, past);
+      if (std::fabs(past) > kTolerance) settle = elapsed + 10;
+      pros::delay(10);
+    }
+    chassis.waitUntilDone();
+    result.settle[i] = settle;
+    result.overshoot[i] = overshoot;
+  }
+  return result;
+}
+
+bool spawn(const char *self, const char *way, Result &result) {
+  std::string command = std::string(self) + " --trial " + way;
+  FILE *pipe = popen(command.c_str(), "r");
+  std::size_t read = 0;
+  for (std::size_t i = 0; pipe != nullptr && i < std::size(kAngles); i++) {
+    read += std::fscanf(pipe, "%lf %lf", &result.settle[i],
+                        &result.overshoot[i]);
+  }
+  if (pipe != nullptr) pclose(pipe);
+  if (read != 2 * std::size(kAngles)) {
+    std::fprintf(stderr, "trial %s failed\n", command.c_str());
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc == 3 && !std::strcmp(argv[1], "--trial")) {
+    Result result = trial(argv[2]);
+    for (std::size_t i = 0; i < std::size(kAngles); i++) {
+      std::printf("%f %f\n", result.settle[i], result.overshoot[i]);
+    }
+    std::fflush(stdout);
+    std::_Exit(0);
+  }
+
+  std::printf("%-10s %6s %10s %10s\n", "pid", "turn", "settle ms",
+              "overshoot");
+  for (const char *way : kWays) {
+    Result result;
+    if (!spawn(argv[0], way, result)) continue;
+    double total = 0;
+    for (std::size_t i = 0; i < std::size(kAngles); i++) {
+      std::printf("%-10s %6.0f %10.0f %10.3f\n", way, kAngles[i],
+                  result.settle[i], result.overshoot[i]);
+      total += result.settle[i];
+    }
+    std::printf("%-10s %6s %10.0f\n", way, "mean", total / std::size(kAngles));
+  }
+  return 0;
+}
@@ -0,0 +1,14 @@
+#ifndef SIM_CARD_H
+#define SIM_CARD_H
+
+#include <string>
+
+namespace sim {
+// Mounts a host directory as the brain's SD card. Until then the program sees
+// no card. Once mounted, usd_is_installed reports a card and the program's
+// fopen of a path under /usd/ opens the same path under `directory`, which
+// must exist
+void mountCard(const std::string &directory);
+}  // namespace sim
+
+#endif
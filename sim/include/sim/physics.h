@@ -0,0 +1,76 @@
+#include "pros/abstract_motor.hpp"  // IWYU pragma: keep
+
+#ifndef SIM_PHYSICS_H
+#define SIM_PHYSICS_H
+
+namespace sim {
+// Output shaft characteristics of a V5 smart motor behind a cartridge, at 12 V
+struct MotorModel {
+  double freeSpeed;    // rpm
+  double stallTorque;  // N*m
+  double stallCurrent; // mA
+  double countsPerRev; // raw encoder ticks per output revolution
+};
+
+MotorModel motorModel(pros::MotorGears gearset);
+
+// Torque produced by a motor spinning at `rpm` while `voltage` mV is applied
+double motorTorque(const MotorModel &model, double voltage, double rpm);
+
+// Physical constants of the robot that LemLib does not know about
+struct BodyParams {
+  double mass;            // kg
+  double inertia;         // kg*m^2 about the tracking center
+  double rollingFriction; // N per side, opposing wheel motion
+  double viscousFriction; // N*s/m per side
+};
+
+// Geometry of the drivetrain, taken from lemlib::Drivetrain
+struct DrivetrainGeometry {
+  double trackWidth;    // m
+  double wheelRadius;   // m
+  double wheelPerMotor; // wheel revolutions per motor output revolution
+};
+
+// Rigid body state of the robot. Heading follows LemLib: 0 faces +y and
+// increases clockwise
+struct BodyState {
+  double x = 0;       // m
+  double y = 0;       // m
+  double theta = 0;   // rad
+  double v = 0;       // m/s, forwards
+  double omega = 0;   // rad/s, clockwise
+  double accel = 0;   // m/s^2, forwards
+  double lateral = 0; // m/s^2, centripetal, to the right
+};
+
+// Differential drive model. Each side is driven by a force at the wheel
+// contact patch; wheels do not slip sideways
+class DrivetrainModel {
+ public:
+  DrivetrainModel(BodyParams body, DrivetrainGeometry geometry);
+
+  // advances the body by dt seconds under the given side forces (N)
+  void step(double leftForce, double rightForce, double dt);
+
+  // wheel surface speed of each side, m/s
+  double leftSpeed() const;
+  double rightSpeed() const;
+
+  // converts a motor torque to a force at the wheel, and a side speed to the
+  // matching motor speed
+  double wheelForce(double torque) const;
+  double motorRpm(double sideSpeed) const;
+
+  const BodyState &state() const { return body; }
+  void setState(const BodyState &state) { body = state; }
+  const DrivetrainGeometry &getGeometry() const { return geometry; }
+
+ private:
+  BodyParams params;
+  DrivetrainGeometry geometry;
+  BodyState body;
+};
+}  // namespace sim
+
+#endif
@@ -0,0 +1,53 @@
+#include "sim/physics.h"  // IWYU pragma: keep
+
+#ifndef SIM_ROBOT_H
+#define SIM_ROBOT_H
+
+#include <array>
+
+namespace sim {
+enum class WheelAxis { none, vertical, horizontal };
+
+// A tracking wheel the simulator should feed. Readings follow the model LemLib
+// odometry assumes, so offsets use LemLib's sign convention
+struct TrackingWheelSpec {
+  WheelAxis axis = WheelAxis::none;
+  int port = 0;         // rotation sensor port, 0 when using an ADI encoder
+  char adiTop = 0;      // top ADI port of a quadrature encoder
+  double diameter = 0;  // in
+  double offset = 0;    // in
+  double gearRatio = 1; // same meaning as lemlib::TrackingWheel
+};
+
+// How far the simulated sensors are from ideal. Drive encoders and tracking
+// wheels are exact, since the wheels never slip
+struct SensorErrors {
+  unsigned seed;           // of the noise generator
+  double gyroBias;         // degrees/s the IMU reads when still
+  double gyroScale;        // fraction the IMU over-reads rotation by
+  double gyroNoise;        // degrees/s, standard deviation per sample
+  double accelNoise;       // g, standard deviation per sample
+  double gpsNoise;         // m, standard deviation of each GPS coordinate
+  double gpsHeadingNoise;  // degrees
+};
+
+// Everything about the robot the simulator cannot read from the program's own
+// device objects. Kept an aggregate so it is usable during static
+// initialization of src/main.cpp
+struct RobotDescription {
+  int imuPort;
+  BodyParams body;
+  double mechanismInertia; // kg*m^2 behind every non-drivetrain motor
+  std::array<TrackingWheelSpec, 4> trackingWheels;
+  SensorErrors errors;
+};
+
+// The robot defined in src/main.cpp. See sim/src/robot.cpp
+extern const RobotDescription robot;
+
+// Hands the drivetrain of the robot program to the physics model. Called by
+// the host entry point once static initialization is done
+void attachRobot();
+}  // namespace sim
+
+#endif
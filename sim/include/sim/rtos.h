@@ -0,0 +1,22 @@
+#ifndef SIM_RTOS_H
+#define SIM_RTOS_H
+
+#include <cstdint>
+
+namespace sim {
+// Virtual time a device call costs, in microseconds. Code between RTOS and
+// device calls takes no time at all, so this is what lets a task that polls
+// without delaying still move the clock forwards
+constexpr std::uint64_t kDeviceCallCost = 5;
+
+// Charges `cost` microseconds of virtual time to the running task. This is
+// where the scheduler preempts it: at a tick boundary for another ready task
+// of the same priority, or as soon as a higher priority task is due
+void preemptionPoint(std::uint64_t cost);
+
+// Paces virtual time against the wall clock instead of jumping straight to the
+// next wakeup when every task is blocked
+void setRealtime(bool realtime);
+}  // namespace sim
+
+#endif
@@ -0,0 +1,34 @@
+#include "pros/misc.h"  // IWYU pragma: keep
+
+#ifndef SIM_SCRIPT_H
+#define SIM_SCRIPT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sim {
+// One change to the master controller at a point in time. Scripts are text,
+// one event per line:
+//
+//   <ms> <control> <value>
+//
+// where control is an analog channel (LEFT_X, LEFT_Y, RIGHT_X, RIGHT_Y) with a
+// value in [-127, 127], or a button (L1 ... A) with a value of 0 or 1. Blank
+// lines and lines starting with # are ignored
+struct InputEvent {
+  std::uint32_t time;
+  bool analog;
+  int control; // controller_analog_e_t or controller_digital_e_t
+  int value;
+};
+
+// Reads a script, sorted by time. Throws std::runtime_error on a malformed
+// line
+std::vector<InputEvent> loadScript(const std::string &path);
+
+// applies an event to the master controller
+void applyInput(const InputEvent &event);
+}  // namespace sim
+
+#endif
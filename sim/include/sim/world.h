@@ -0,0 +1,231 @@
+#include "pros/abstract_motor.hpp"  // IWYU pragma: keep
+#include "pros/adi.h"             // IWYU pragma: keep
+#include "pros/device.hpp"        // IWYU pragma: keep
+#include "pros/misc.h"             // IWYU pragma: keep
+#include "sim/physics.h"          // IWYU pragma: keep
+#include "sim/robot.h"            // IWYU pragma: keep
+
+#ifndef SIM_WORLD_H
+#define SIM_WORLD_H
+
+#include <cerrno>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace sim {
+constexpr int kNumPorts = 21;
+constexpr int kAdiSmartPort = 22;
+constexpr int kNumAdiPorts = 8;
+// the world is integrated with a fixed step, in microseconds
+constexpr std::uint64_t kStep = 1000;
+// ms between the packets the brain sends smart devices. A motor command only
+// takes effect with the next one
+constexpr std::uint32_t kCommandPeriod = 5;
+
+// What the brain last received from a device. Devices report at their own
+// data rate, so reads between reports return the same sample
+template <typename T> struct Sampled {
+  T value{};
+  std::uint32_t time = 0;   // ms timestamp of the report
+  std::uint32_t period = 10; // ms between reports
+};
+
+struct MotorReport {
+  double angle = 0;    // degrees of output shaft
+  double velocity = 0; // rpm
+  double voltage = 0;  // mV
+  double current = 0;  // mA
+  double torque = 0;   // N*m
+  double temperature = 25;
+};
+
+struct MotorPort {
+  enum class Mode { voltage, velocity, position, brake };
+  Mode mode = Mode::voltage;
+  pros::MotorGears gearset = pros::MotorGears::green;
+  pros::MotorUnits units = pros::MotorUnits::degrees;
+  pros::MotorBrake brakeMode = pros::MotorBrake::coast;
+  // mV, rpm, or shaft degrees depending on mode. Braking holds `target` as the
+  // shaft angle to keep in hold mode
+  double target = 0;
+  double profileVelocity = 0; // rpm cap while in position mode
+  double zero = 0;            // shaft angle reported as position 0
+  std::int32_t currentLimit = 2500;
+  std::int32_t voltageLimit = 0; // 0 is no limit
+
+  // the command the motor is acting on, from the last packet it received
+  struct Command {
+    Mode mode = Mode::voltage;
+    double target = 0;
+    double profileVelocity = 0;
+  };
+  Command applied;
+
+  // physical state, in the motor's own unreversed direction
+  MotorReport state;
+  Sampled<MotorReport> report;
+};
+
+struct ImuReport {
+  double rotation = 0; // degrees, clockwise
+  double pitch = 0;
+  double roll = 0;
+  double gyro = 0;     // degrees/s about z
+  double accelX = 0;   // g, to the right of the robot
+  double accelY = 0;   // g, forwards
+};
+
+struct ImuPort {
+  // degrees the sensor has integrated, drift and scale error included
+  double rotation = 0;
+  bool calibrating = false;
+  std::uint32_t calibrationDone = 0;
+  double rotationOffset = 0;
+  double headingOffset = 0;
+  double yawOffset = 0;
+  double pitchOffset = 0;
+  double rollOffset = 0;
+  Sampled<ImuReport> report;
+};
+
+struct GpsReport {
+  double x = 0;       // m from the field center
+  double y = 0;       // m
+  double heading = 0; // degrees, clockwise from +y
+  double error = 0;   // m, the sensor's own estimate of its error
+  double gyro = 0;    // degrees/s about z
+  double accelX = 0;  // g
+  double accelY = 0;  // g
+};
+
+struct GpsPort {
+  double offsetX = 0; // m from the sensor to the tracking center
+  double offsetY = 0;
+  // position the sensor assumes before it first sees the field strip
+  double initialX = 0;
+  double initialY = 0;
+  double initialHeading = 0;
+  Sampled<GpsReport> report{{}, 0, 20};
+};
+
+struct RotationPort {
+  bool reversed = false;
+  double angle = 0; // centidegrees travelled by the shaft, unreversed
+  double zero = 0;  // angle reported as position 0
+  double velocity = 0;
+  Sampled<double> report;
+  Sampled<double> velocityReport;
+};
+
+struct AdiPort {
+  pros::adi_port_config_e_t config = pros::E_ADI_TYPE_UNDEFINED;
+  std::int32_t value = 0;
+  double encoder = 0; // ticks travelled, when paired as an encoder top port
+  double encoderZero = 0;
+  bool encoderReversed = false;
+};
+
+struct ControllerState {
+  bool connected = true;
+  std::int32_t analog[4] = {};
+  bool digital[pros::E_CONTROLLER_DIGITAL_A + 1] = {};
+  // last level seen by get_digital_new_press
+  bool reported[pros::E_CONTROLLER_DIGITAL_A + 1] = {};
+  char text[3][20] = {};
+};
+
+struct Battery {
+  double capacity = 100; // percent
+  double voltage = 12800; // mV
+  double current = 0;     // mA
+  double temperature = 25;
+};
+
+class World {
+ public:
+  World();
+
+  // Integrates the world up to the current time. Every device call goes
+  // through here, so the world only ever moves forwards while it is being
+  // observed. It is also where the scheduler charges the call's time and may
+  // preempt the task; only one task runs at a time, so the world needs no lock
+  void sync();
+
+  // device state for a smart port, 1 indexed. Addressing a port as a device
+  // installs that device, the same way plugging it in would
+  MotorPort &motor(int port);
+  ImuPort &imu(int port);
+  RotationPort &rotation(int port);
+  GpsPort &gps(int port);
+  AdiPort &adi(int port);
+  ControllerState &controller(int id);
+  Battery &battery() { return batteryState; }
+  pros::DeviceType type(int port) const;
+  bool valid(int port) const { return port >= 1 && port <= kNumPorts; }
+
+  // competition state reported by pros::competition
+  std::uint8_t competition = 0;
+
+  // couples the given motor ports to the drivetrain model
+  void attachDrivetrain(const std::vector<std::int8_t> &left,
+                        const std::vector<std::int8_t> &right,
+                        DrivetrainGeometry geometry);
+
+  // ground truth with lengths in inches and angles in degrees
+  BodyState truth();
+
+  std::uint32_t now() const { return time / 1000; }
+
+ private:
+  void step();
+  void stepMotor(MotorPort &motor, double dt);
+  double commandedVoltage(MotorPort &motor);
+  void updateSensors(double dt);
+  void report();
+
+  std::uint64_t time = 0; // us of world time integrated so far
+  // sensor noise. Seeded the same every run, so runs stay deterministic
+  std::mt19937 noise{robot.errors.seed};
+
+  pros::DeviceType types[kNumPorts + 1] = {};
+  MotorPort motors[kNumPorts + 1];
+  ImuPort imus[kNumPorts + 1];
+  RotationPort rotations[kNumPorts + 1];
+  GpsPort gpsPorts[kNumPorts + 1];
+  AdiPort adiPorts[kNumAdiPorts + 1];
+  ControllerState controllers[2];
+  Battery batteryState;
+
+  std::unique_ptr<DrivetrainModel> drivetrain;
+  std::vector<std::int8_t> leftPorts;
+  std::vector<std::int8_t> rightPorts;
+};
+
+World &world();
+
+// ADI ports are addressed either as 1-8 or 'A'-'H'
+int adiIndex(int port);
+
+// Runs `f` against a synced world if `port` can be addressed as a device of
+// `type`, otherwise sets errno the way the kernel does and returns `error`
+template <typename T, typename F, typename R = std::invoke_result_t<F>>
+R withDevice(int port, pros::DeviceType type, T error, F &&f) {
+  World &instance = world();
+  if (!instance.valid(port)) {
+    errno = ENXIO;
+    return error;
+  }
+  instance.sync();
+  pros::DeviceType installed = instance.type(port);
+  if (installed != pros::DeviceType::none && installed != type) {
+    errno = ENODEV;
+    return error;
+  }
+  return f();
+}
+}  // namespace sim
+
+#endif
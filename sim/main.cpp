@@ -0,0 +1,115 @@
+// Host entry point. Runs the robot program in src/ against the simulated
+// devices the same way the PROS kernel would: initialize, then autonomous or
+// driver control in the competition task, for a fixed length of match time.
+//
+//   usage: sim [--auton | --driver] [--duration ms] [--input script]
+//              [--card directory] [--realtime]
+//
+// Driver control reads the controller from an input script; see sim/script.h.
+// Match time is virtual and runs as fast as the host can go unless --realtime
+// paces it against the wall clock. --card mounts a directory as the SD card
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "main.h"
+#include "sim/card.h"
+#include "sim/robot.h"
+#include "sim/rtos.h"
+#include "sim/script.h"
+#include "sim/world.h"
+
+namespace {
+struct Options {
+  bool autonomous = false;
+  std::uint32_t duration = 0; // ms, 0 picks the match length of the period
+  std::string input;
+  std::string card;
+  bool realtime = false;
+};
+
+[[noreturn]] void usage(const char *program) {
+  std::fprintf(stderr,
+               "usage: %s [--auton | --driver] [--duration ms] "
+               "[--input script] [--card directory] [--realtime]\n",
+               program);
+  std::exit(2);
+}
+
+Options parse(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    auto value = [&]() -> const char * {
+      if (i + 1 >= argc) usage(argv[0]);
+      return argv[++i];
+    };
+    if (!std::strcmp(argv[i], "--auton")) {
+      options.autonomous = true;
+    } else if (!std::strcmp(argv[i], "--driver")) {
+      options.autonomous = false;
+    } else if (!std::strcmp(argv[i], "--duration")) {
+      options.duration = std::strtoul(value(), nullptr, 10);
+    } else if (!std::strcmp(argv[i], "--input")) {
+      options.input = value();
+    } else if (!std::strcmp(argv[i], "--card")) {
+      options.card = value();
+    } else if (!std::strcmp(argv[i], "--realtime")) {
+      options.realtime = true;
+    } else {
+      usage(argv[0]);
+    }
+  }
+  if (!options.duration) options.duration = options.autonomous ? 15000 : 105000;
+  return options;
+}
+
+// the competition task: initialize, then the period being simulated
+void competition(void *param) {
+  const Options &options = *static_cast<Options *>(param);
+  initialize();
+  if (options.autonomous) {
+    autonomous();
+  } else {
+    opcontrol();
+  }
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  static Options options = parse(argc, argv);
+  std::vector<sim::InputEvent> script;
+  try {
+    if (!options.input.empty()) script = sim::loadScript(options.input);
+  } catch (const std::runtime_error &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+
+  sim::setRealtime(options.realtime);
+  if (!options.card.empty()) sim::mountCard(options.card);
+  sim::attachRobot();
+  sim::world().competition = options.autonomous ? COMPETITION_AUTONOMOUS : 0;
+  pros::Task task(competition, &options, "competition");
+
+  // replay the controller script against match time
+  std::uint32_t start = pros::millis();
+  for (const sim::InputEvent &event : script) {
+    if (event.time >= options.duration) break;
+    std::uint32_t now = pros::millis() - start;
+    if (event.time > now) pros::delay(event.time - now);
+    sim::applyInput(event);
+  }
+  std::uint32_t elapsed = pros::millis() - start;
+  if (elapsed < options.duration) pros::delay(options.duration - elapsed);
+
+  sim::BodyState pose = sim::world().truth();
+  std::printf("final pose: x %.3f in, y %.3f in, theta %.3f deg\n", pose.x,
+              pose.y, pose.theta);
+  std::fflush(stdout);
+  // the robot program's tasks never return, so leave without unwinding them
+  std::_Exit(0);
+}
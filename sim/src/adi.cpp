@@ -0,0 +1,111 @@
+// Simulated three wire ports on the brain. Only the brain's own ports exist:
+// devices on an expander share them
+
+#include "pros/adi.hpp"
+
+#include <cerrno>
+#include <cmath>
+
+#include "pros/error.h"
+#include "sim/world.h"
+
+namespace {
+// runs `f` against an ADI port, with the world synced
+template <typename F> std::int32_t withAdi(std::uint8_t port, F &&f) {
+  if (!sim::adiIndex(port)) {
+    errno = ENXIO;
+    return PROS_ERR;
+  }
+  sim::world().sync();
+  return f(sim::world().adi(port));
+}
+}  // namespace
+
+namespace pros::adi {
+Port::Port(std::uint8_t adi_port, adi_port_config_e_t type)
+    : _smart_port(INTERNAL_ADI_PORT), _adi_port(adi_port) {
+  if (type != E_ADI_TYPE_UNDEFINED) set_config(type);
+}
+
+Port::Port(ext_adi_port_pair_t port_pair, adi_port_config_e_t type)
+    : _smart_port(port_pair.first), _adi_port(port_pair.second) {
+  if (type != E_ADI_TYPE_UNDEFINED) set_config(type);
+}
+
+std::int32_t Port::get_config() const {
+  return withAdi(_adi_port,
+                 [](sim::AdiPort &port) -> std::int32_t { return port.config; });
+}
+
+std::int32_t Port::get_value() const {
+  return withAdi(_adi_port, [](sim::AdiPort &port) { return port.value; });
+}
+
+std::int32_t Port::set_config(adi_port_config_e_t type) const {
+  return withAdi(_adi_port, [&](sim::AdiPort &port) {
+    port.config = type;
+    return PROS_SUCCESS;
+  });
+}
+
+std::int32_t Port::set_value(std::int32_t value) const {
+  return withAdi(_adi_port, [&](sim::AdiPort &port) {
+    port.value = value;
+    return PROS_SUCCESS;
+  });
+}
+
+ext_adi_port_tuple_t Port::get_port() const {
+  return {_smart_port, _adi_port, PROS_ERR_BYTE};
+}
+
+DigitalOut::DigitalOut(std::uint8_t adi_port, bool init_state)
+    : Port(adi_port, E_ADI_DIGITAL_OUT) {
+  set_value(init_state);
+}
+
+DigitalOut::DigitalOut(ext_adi_port_pair_t port_pair, bool init_state)
+    : Port(port_pair, E_ADI_DIGITAL_OUT) {
+  set_value(init_state);
+}
+
+// the encoder lives on its top port, the same way the kernel addresses it
+Encoder::Encoder(std::uint8_t adi_port_top, std::uint8_t adi_port_bottom,
+                 bool reversed)
+    : Port(adi_port_top, E_ADI_LEGACY_ENCODER),
+      _port_pair(adi_port_top, adi_port_bottom) {
+  withAdi(_adi_port, [&](sim::AdiPort &port) {
+    port.encoderReversed = reversed;
+    return PROS_SUCCESS;
+  });
+}
+
+Encoder::Encoder(ext_adi_port_tuple_t port_tuple, bool reversed)
+    : Port(ext_adi_port_pair_t(std::get<0>(port_tuple), std::get<1>(port_tuple)),
+           E_ADI_LEGACY_ENCODER),
+      _port_pair(std::get<1>(port_tuple), std::get<2>(port_tuple)) {
+  withAdi(_adi_port, [&](sim::AdiPort &port) {
+    port.encoderReversed = reversed;
+    return PROS_SUCCESS;
+  });
+}
+
+std::int32_t Encoder::reset() const {
+  return withAdi(_adi_port, [](sim::AdiPort &port) {
+    port.encoderZero = port.encoder;
+    return PROS_SUCCESS;
+  });
+}
+
+std::int32_t Encoder::get_value() const {
+  return withAdi(_adi_port, [](sim::AdiPort &port) {
+    double ticks = port.encoder - port.encoderZero;
+    return static_cast<std::int32_t>(
+        std::lround(port.encoderReversed ? -ticks : ticks));
+  });
+}
+
+ext_adi_port_tuple_t Encoder::get_port() const {
+  return {_smart_port, _port_pair.first, _port_pair.second};
+}
+}  // namespace pros::adi
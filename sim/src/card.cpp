@@ -0,0 +1,34 @@
+// Simulated SD card. PROS opens files on the card through fopen with paths
+// under /usd/, so the host build links the program with --wrap=fopen and
+// redirects those paths into a host directory
+
+#include "sim/card.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "pros/misc.h"
+
+namespace {
+constexpr char kCardRoot[] = "/usd/";
+
+// empty until a card is mounted
+std::string mounted;
+}  // namespace
+
+void sim::mountCard(const std::string &directory) { mounted = directory; }
+
+extern "C" std::FILE *__real_fopen(const char *path, const char *mode);
+
+extern "C" std::FILE *__wrap_fopen(const char *path, const char *mode) {
+  std::size_t root = std::strlen(kCardRoot);
+  if (std::strncmp(path, kCardRoot, root) != 0) {
+    return __real_fopen(path, mode);
+  }
+  if (mounted.empty()) return nullptr;
+  return __real_fopen((mounted + "/" + (path + root)).c_str(), mode);
+}
+
+namespace pros::c {
+int32_t usd_is_installed(void) { return !mounted.empty(); }
+}  // namespace pros::c
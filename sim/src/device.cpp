@@ -0,0 +1,34 @@
+// Ports report whatever device the world has installed on them
+
+#include "pros/device.hpp"
+
+#include "sim/world.h"
+
+namespace pros::v5 {
+Device::Device(const std::uint8_t port)
+    : _port(port), _deviceType(sim::world().type(port)) {}
+
+std::uint8_t Device::get_port(void) const { return _port; }
+
+bool Device::is_installed() {
+  return get_plugged_type() == _deviceType && _deviceType != DeviceType::none;
+}
+
+DeviceType Device::get_plugged_type() const { return get_plugged_type(_port); }
+
+DeviceType Device::get_plugged_type(std::uint8_t port) {
+  return sim::world().type(port);
+}
+
+std::vector<Device> Device::get_all_devices(DeviceType device_type) {
+  std::vector<Device> devices;
+  for (int port = 1; port <= sim::kNumPorts; port++) {
+    DeviceType type = sim::world().type(port);
+    if (type == DeviceType::none) continue;
+    if (device_type == DeviceType::undefined || type == device_type) {
+      devices.emplace_back(port);
+    }
+  }
+  return devices;
+}
+}  // namespace pros::v5
@@ -0,0 +1,242 @@
+// Simulated GPS sensor. It always sees the field strip, so readings are the
+// drivetrain model's ground truth plus the noise in the robot description,
+// with the field origin where the robot started. Offsets are taken as already
+// applied: readings are of the tracking center
+
+#include "pros/gps.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+
+#include "pros/error.h"
+#include "sim/world.h"
+
+namespace {
+using sim::GpsPort;
+
+template <typename T, typename F> auto withGps(std::uint8_t port, T error, F &&f) {
+  using R = std::invoke_result_t<F, GpsPort &, const sim::GpsReport &>;
+  return sim::withDevice(port, pros::DeviceType::gps, error, [&]() -> R {
+    GpsPort &gps = sim::world().gps(port);
+    return f(gps, gps.report.value);
+  });
+}
+
+// wraps an angle into [-180, 180)
+double wrap180(double angle) {
+  angle = std::fmod(angle + 180, 360);
+  return (angle < 0 ? angle + 360 : angle) - 180;
+}
+
+constexpr pros::gps_status_s_t kStatusError = {PROS_ERR_F, PROS_ERR_F,
+                                               PROS_ERR_F, PROS_ERR_F,
+                                               PROS_ERR_F};
+constexpr pros::gps_position_s_t kPositionError = {PROS_ERR_F, PROS_ERR_F};
+constexpr pros::gps_orientation_s_t kOrientationError = {
+    PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+constexpr pros::gps_raw_s kRawError = {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+}  // namespace
+
+namespace pros::c {
+int32_t gps_initialize_full(uint8_t port, double xInitial, double yInitial,
+                            double headingInitial, double xOffset,
+                            double yOffset) {
+  if (gps_set_offset(port, xOffset, yOffset) == PROS_ERR) return PROS_ERR;
+  return gps_set_position(port, xInitial, yInitial, headingInitial);
+}
+
+int32_t gps_set_offset(uint8_t port, double xOffset, double yOffset) {
+  return withGps(port, PROS_ERR, [&](GpsPort &gps, const sim::GpsReport &) {
+    gps.offsetX = xOffset;
+    gps.offsetY = yOffset;
+    return PROS_SUCCESS;
+  });
+}
+
+gps_position_s_t gps_get_offset(uint8_t port) {
+  return withGps(port, kPositionError,
+                 [](GpsPort &gps, const sim::GpsReport &) {
+                   return gps_position_s_t{gps.offsetX, gps.offsetY};
+                 });
+}
+
+int32_t gps_set_position(uint8_t port, double xInitial, double yInitial,
+                         double headingInitial) {
+  return withGps(port, PROS_ERR, [&](GpsPort &gps, const sim::GpsReport &) {
+    gps.initialX = xInitial;
+    gps.initialY = yInitial;
+    gps.initialHeading = headingInitial;
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t gps_set_data_rate(uint8_t port, uint32_t rate) {
+  return withGps(port, PROS_ERR, [&](GpsPort &gps, const sim::GpsReport &) {
+    // the sensor only supports multiples of 5 ms
+    rate = std::max<uint32_t>(5, rate - rate % 5);
+    gps.report.period = rate;
+    return PROS_SUCCESS;
+  });
+}
+
+double gps_get_error(uint8_t port) {
+  return withGps(port, PROS_ERR_F, [](GpsPort &, const sim::GpsReport &r) {
+    return r.error;
+  });
+}
+
+gps_status_s_t gps_get_position_and_orientation(uint8_t port) {
+  return withGps(port, kStatusError, [](GpsPort &, const sim::GpsReport &r) {
+    return gps_status_s_t{r.x, r.y, 0, 0, wrap180(r.heading)};
+  });
+}
+
+gps_position_s_t gps_get_position(uint8_t port) {
+  return withGps(port, kPositionError, [](GpsPort &, const sim::GpsReport &r) {
+    return gps_position_s_t{r.x, r.y};
+  });
+}
+
+double gps_get_position_x(uint8_t port) {
+  return withGps(port, PROS_ERR_F,
+                 [](GpsPort &, const sim::GpsReport &r) { return r.x; });
+}
+
+double gps_get_position_y(uint8_t port) {
+  return withGps(port, PROS_ERR_F,
+                 [](GpsPort &, const sim::GpsReport &r) { return r.y; });
+}
+
+gps_orientation_s_t gps_get_orientation(uint8_t port) {
+  return withGps(port, kOrientationError,
+                 [](GpsPort &, const sim::GpsReport &r) {
+                   return gps_orientation_s_t{0, 0, wrap180(r.heading)};
+                 });
+}
+
+// the drivetrain model is planar
+double gps_get_pitch(uint8_t port) {
+  return withGps(port, PROS_ERR_F,
+                 [](GpsPort &, const sim::GpsReport &) { return 0.0; });
+}
+
+double gps_get_roll(uint8_t port) {
+  return withGps(port, PROS_ERR_F,
+                 [](GpsPort &, const sim::GpsReport &) { return 0.0; });
+}
+
+double gps_get_yaw(uint8_t port) {
+  return withGps(port, PROS_ERR_F, [](GpsPort &, const sim::GpsReport &r) {
+    return wrap180(r.heading);
+  });
+}
+
+double gps_get_heading(uint8_t port) {
+  return withGps(port, PROS_ERR_F,
+                 [](GpsPort &, const sim::GpsReport &r) { return r.heading; });
+}
+
+double gps_get_heading_raw(uint8_t port) { return gps_get_heading(port); }
+
+gps_gyro_s_t gps_get_gyro_rate(uint8_t port) {
+  return withGps(port, kRawError, [](GpsPort &, const sim::GpsReport &r) {
+    return gps_gyro_s_t{0, 0, r.gyro};
+  });
+}
+
+double gps_get_gyro_rate_x(uint8_t port) {
+  return gps_get_gyro_rate(port).x;
+}
+
+double gps_get_gyro_rate_y(uint8_t port) {
+  return gps_get_gyro_rate(port).y;
+}
+
+double gps_get_gyro_rate_z(uint8_t port) {
+  return gps_get_gyro_rate(port).z;
+}
+
+gps_accel_s_t gps_get_accel(uint8_t port) {
+  return withGps(port, kRawError, [](GpsPort &, const sim::GpsReport &r) {
+    return gps_accel_s_t{r.accelX, r.accelY, 1};
+  });
+}
+
+double gps_get_accel_x(uint8_t port) { return gps_get_accel(port).x; }
+double gps_get_accel_y(uint8_t port) { return gps_get_accel(port).y; }
+double gps_get_accel_z(uint8_t port) { return gps_get_accel(port).z; }
+}  // namespace pros::c
+
+namespace pros::v5 {
+std::vector<Gps> Gps::get_all_devices() {
+  std::vector<Gps> devices;
+  for (int port = 1; port <= sim::kNumPorts; port++) {
+    if (sim::world().type(port) == DeviceType::gps) devices.emplace_back(port);
+  }
+  return devices;
+}
+
+Gps Gps::get_gps() {
+  for (int port = 1; port <= sim::kNumPorts; port++) {
+    if (sim::world().type(port) == DeviceType::gps) return Gps(port);
+  }
+  errno = ENODEV;
+  return Gps(PROS_ERR_BYTE);
+}
+
+std::int32_t Gps::initialize_full(double xInitial, double yInitial,
+                                  double headingInitial, double xOffset,
+                                  double yOffset) const {
+  return c::gps_initialize_full(_port, xInitial, yInitial, headingInitial,
+                                xOffset, yOffset);
+}
+
+std::int32_t Gps::set_offset(double xOffset, double yOffset) const {
+  return c::gps_set_offset(_port, xOffset, yOffset);
+}
+
+gps_position_s_t Gps::get_offset() const { return c::gps_get_offset(_port); }
+
+std::int32_t Gps::set_position(double xInitial, double yInitial,
+                               double headingInitial) const {
+  return c::gps_set_position(_port, xInitial, yInitial, headingInitial);
+}
+
+std::int32_t Gps::set_data_rate(std::uint32_t rate) const {
+  return c::gps_set_data_rate(_port, rate);
+}
+
+double Gps::get_error() const { return c::gps_get_error(_port); }
+
+gps_status_s_t Gps::get_position_and_orientation() const {
+  return c::gps_get_position_and_orientation(_port);
+}
+
+gps_position_s_t Gps::get_position() const {
+  return c::gps_get_position(_port);
+}
+
+double Gps::get_position_x() const { return c::gps_get_position_x(_port); }
+double Gps::get_position_y() const { return c::gps_get_position_y(_port); }
+
+gps_orientation_s_t Gps::get_orientation() const {
+  return c::gps_get_orientation(_port);
+}
+
+double Gps::get_pitch() const { return c::gps_get_pitch(_port); }
+double Gps::get_roll() const { return c::gps_get_roll(_port); }
+double Gps::get_yaw() const { return c::gps_get_yaw(_port); }
+double Gps::get_heading() const { return c::gps_get_heading(_port); }
+double Gps::get_heading_raw() const { return c::gps_get_heading_raw(_port); }
+
+gps_gyro_s_t Gps::get_gyro_rate() const { return c::gps_get_gyro_rate(_port); }
+double Gps::get_gyro_rate_x() const { return c::gps_get_gyro_rate_x(_port); }
+double Gps::get_gyro_rate_y() const { return c::gps_get_gyro_rate_y(_port); }
+double Gps::get_gyro_rate_z() const { return c::gps_get_gyro_rate_z(_port); }
+
+gps_accel_s_t Gps::get_accel() const { return c::gps_get_accel(_port); }
+double Gps::get_accel_x() const { return c::gps_get_accel_x(_port); }
+double Gps::get_accel_y() const { return c::gps_get_accel_y(_port); }
+double Gps::get_accel_z() const { return c::gps_get_accel_z(_port); }
+}  // namespace pros::v5
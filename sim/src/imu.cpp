@@ -0,0 +1,296 @@
+// Simulated inertial sensor. Readings come from the drivetrain model's ground
+// truth with the errors in the robot description, sampled at the sensor's data
+// rate
+
+#include "pros/imu.hpp"
+
+#include <cerrno>
+#include <cmath>
+
+#include "pros/error.h"
+#include "pros/rtos.h"
+#include "sim/world.h"
+
+namespace {
+using sim::ImuPort;
+
+// the kernel reports a calibration that takes about two seconds
+constexpr std::uint32_t kCalibrationTime = 2000;
+
+// runs `f` against the imu on `port`. Readings are unavailable while the
+// sensor is calibrating
+template <typename T, typename F> auto withImu(std::uint8_t port, T error, F &&f) {
+  using R = std::invoke_result_t<F, ImuPort &, const sim::ImuReport &>;
+  return sim::withDevice(port, pros::DeviceType::imu, error, [&]() -> R {
+    ImuPort &imu = sim::world().imu(port);
+    if (imu.calibrating) {
+      errno = EAGAIN;
+      return error;
+    }
+    return f(imu, imu.report.value);
+  });
+}
+
+// wraps an angle into [0, 360)
+double wrap360(double angle) {
+  angle = std::fmod(angle, 360);
+  return angle < 0 ? angle + 360 : angle;
+}
+
+// wraps an angle into [-180, 180)
+double wrap180(double angle) { return wrap360(angle + 180) - 180; }
+
+constexpr pros::quaternion_s_t kQuaternionError = {PROS_ERR_F, PROS_ERR_F,
+                                                   PROS_ERR_F, PROS_ERR_F};
+constexpr pros::euler_s_t kEulerError = {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+constexpr pros::imu_raw_s kRawError = {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+}  // namespace
+
+namespace pros::c {
+int32_t imu_reset(uint8_t port) {
+  return sim::withDevice(port, DeviceType::imu, PROS_ERR, [&] {
+    ImuPort &imu = sim::world().imu(port);
+    const sim::ImuReport &raw = imu.report.value;
+    imu.calibrating = true;
+    imu.calibrationDone = sim::world().now() + kCalibrationTime;
+    imu.rotationOffset = raw.rotation;
+    imu.headingOffset = raw.rotation;
+    imu.yawOffset = raw.rotation;
+    imu.pitchOffset = raw.pitch;
+    imu.rollOffset = raw.roll;
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t imu_reset_blocking(uint8_t port) {
+  if (imu_reset(port) == PROS_ERR) return PROS_ERR;
+  while (imu_get_status(port) & E_IMU_STATUS_CALIBRATING) delay(10);
+  return PROS_SUCCESS;
+}
+
+int32_t imu_set_data_rate(uint8_t port, uint32_t rate) {
+  return sim::withDevice(port, DeviceType::imu, PROS_ERR, [&] {
+    // the sensor only supports multiples of 5 ms
+    rate = std::max<uint32_t>(5, rate - rate % 5);
+    sim::world().imu(port).report.period = rate;
+    return PROS_SUCCESS;
+  });
+}
+
+double imu_get_rotation(uint8_t port) {
+  return withImu(port, PROS_ERR_F, [](ImuPort &imu, const sim::ImuReport &r) {
+    return r.rotation - imu.rotationOffset;
+  });
+}
+
+double imu_get_heading(uint8_t port) {
+  return withImu(port, PROS_ERR_F, [](ImuPort &imu, const sim::ImuReport &r) {
+    return wrap360(r.rotation - imu.headingOffset);
+  });
+}
+
+double imu_get_yaw(uint8_t port) {
+  return withImu(port, PROS_ERR_F, [](ImuPort &imu, const sim::ImuReport &r) {
+    return wrap180(r.rotation - imu.yawOffset);
+  });
+}
+
+double imu_get_pitch(uint8_t port) {
+  return withImu(port, PROS_ERR_F, [](ImuPort &imu, const sim::ImuReport &r) {
+    return wrap180(r.pitch - imu.pitchOffset);
+  });
+}
+
+double imu_get_roll(uint8_t port) {
+  return withImu(port, PROS_ERR_F, [](ImuPort &imu, const sim::ImuReport &r) {
+    return wrap180(r.roll - imu.rollOffset);
+  });
+}
+
+euler_s_t imu_get_euler(uint8_t port) {
+  if (withImu(port, false, [](ImuPort &, const sim::ImuReport &) {
+        return true;
+      })) {
+    return {imu_get_pitch(port), imu_get_roll(port), imu_get_yaw(port)};
+  }
+  return kEulerError;
+}
+
+quaternion_s_t imu_get_quaternion(uint8_t port) {
+  // yaw only: the drivetrain model is planar
+  double yaw = imu_get_yaw(port);
+  if (yaw == PROS_ERR_F) return kQuaternionError;
+  double half = -yaw * M_PI / 360;
+  return {0, 0, std::sin(half), std::cos(half)};
+}
+
+imu_gyro_s_t imu_get_gyro_rate(uint8_t port) {
+  return withImu(port, kRawError, [](ImuPort &, const sim::ImuReport &r) {
+    return imu_gyro_s_t{0, 0, r.gyro};
+  });
+}
+
+imu_accel_s_t imu_get_accel(uint8_t port) {
+  return withImu(port, kRawError, [](ImuPort &, const sim::ImuReport &r) {
+    return imu_accel_s_t{r.accelX, r.accelY, 1};
+  });
+}
+
+imu_status_e_t imu_get_status(uint8_t port) {
+  return sim::withDevice(port, DeviceType::imu, E_IMU_STATUS_ERROR, [&] {
+    return sim::world().imu(port).calibrating ? E_IMU_STATUS_CALIBRATING
+                                              : E_IMU_STATUS_READY;
+  });
+}
+
+imu_orientation_e_t imu_get_physical_orientation(uint8_t port) {
+  return withImu(port, E_IMU_ORIENTATION_ERROR,
+                 [](ImuPort &, const sim::ImuReport &) { return E_IMU_Z_UP; });
+}
+
+// setting a reading to `target` moves its offset so the raw value reads as it
+int32_t imu_set_rotation(uint8_t port, double target) {
+  return withImu(port, PROS_ERR, [&](ImuPort &imu, const sim::ImuReport &r) {
+    imu.rotationOffset = r.rotation - target;
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t imu_set_heading(uint8_t port, double target) {
+  return withImu(port, PROS_ERR, [&](ImuPort &imu, const sim::ImuReport &r) {
+    imu.headingOffset = r.rotation - target;
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t imu_set_yaw(uint8_t port, double target) {
+  return withImu(port, PROS_ERR, [&](ImuPort &imu, const sim::ImuReport &r) {
+    imu.yawOffset = r.rotation - target;
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t imu_set_pitch(uint8_t port, double target) {
+  return withImu(port, PROS_ERR, [&](ImuPort &imu, const sim::ImuReport &r) {
+    imu.pitchOffset = r.pitch - target;
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t imu_set_roll(uint8_t port, double target) {
+  return withImu(port, PROS_ERR, [&](ImuPort &imu, const sim::ImuReport &r) {
+    imu.rollOffset = r.roll - target;
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t imu_set_euler(uint8_t port, euler_s_t target) {
+  if (imu_set_pitch(port, target.pitch) == PROS_ERR) return PROS_ERR;
+  imu_set_roll(port, target.roll);
+  return imu_set_yaw(port, target.yaw);
+}
+
+int32_t imu_tare_rotation(uint8_t port) { return imu_set_rotation(port, 0); }
+int32_t imu_tare_heading(uint8_t port) { return imu_set_heading(port, 0); }
+int32_t imu_tare_yaw(uint8_t port) { return imu_set_yaw(port, 0); }
+int32_t imu_tare_pitch(uint8_t port) { return imu_set_pitch(port, 0); }
+int32_t imu_tare_roll(uint8_t port) { return imu_set_roll(port, 0); }
+
+int32_t imu_tare_euler(uint8_t port) {
+  return imu_set_euler(port, {0, 0, 0});
+}
+
+int32_t imu_tare(uint8_t port) {
+  if (imu_tare_euler(port) == PROS_ERR) return PROS_ERR;
+  imu_tare_heading(port);
+  return imu_tare_rotation(port);
+}
+}  // namespace pros::c
+
+namespace pros::v5 {
+Imu Imu::get_imu() {
+  for (int port = 1; port <= sim::kNumPorts; port++) {
+    if (sim::world().type(port) == DeviceType::imu) return Imu(port);
+  }
+  errno = ENODEV;
+  return Imu(PROS_ERR_BYTE);
+}
+
+std::vector<Imu> Imu::get_all_devices() {
+  std::vector<Imu> imus;
+  for (int port = 1; port <= sim::kNumPorts; port++) {
+    if (sim::world().type(port) == DeviceType::imu) imus.emplace_back(port);
+  }
+  return imus;
+}
+
+std::int32_t Imu::reset(bool blocking) const {
+  return blocking ? c::imu_reset_blocking(_port) : c::imu_reset(_port);
+}
+
+std::int32_t Imu::set_data_rate(std::uint32_t rate) const {
+  return c::imu_set_data_rate(_port, rate);
+}
+
+double Imu::get_rotation() const { return c::imu_get_rotation(_port); }
+double Imu::get_heading() const { return c::imu_get_heading(_port); }
+double Imu::get_pitch() const { return c::imu_get_pitch(_port); }
+double Imu::get_roll() const { return c::imu_get_roll(_port); }
+double Imu::get_yaw() const { return c::imu_get_yaw(_port); }
+
+quaternion_s_t Imu::get_quaternion() const {
+  return c::imu_get_quaternion(_port);
+}
+
+euler_s_t Imu::get_euler() const { return c::imu_get_euler(_port); }
+
+imu_gyro_s_t Imu::get_gyro_rate() const {
+  return c::imu_get_gyro_rate(_port);
+}
+
+imu_accel_s_t Imu::get_accel() const { return c::imu_get_accel(_port); }
+
+ImuStatus Imu::get_status() const {
+  return static_cast<ImuStatus>(c::imu_get_status(_port));
+}
+
+bool Imu::is_calibrating() const {
+  return c::imu_get_status(_port) == E_IMU_STATUS_CALIBRATING;
+}
+
+imu_orientation_e_t Imu::get_physical_orientation() const {
+  return c::imu_get_physical_orientation(_port);
+}
+
+std::int32_t Imu::tare_rotation() const { return c::imu_tare_rotation(_port); }
+std::int32_t Imu::tare_heading() const { return c::imu_tare_heading(_port); }
+std::int32_t Imu::tare_pitch() const { return c::imu_tare_pitch(_port); }
+std::int32_t Imu::tare_yaw() const { return c::imu_tare_yaw(_port); }
+std::int32_t Imu::tare_roll() const { return c::imu_tare_roll(_port); }
+std::int32_t Imu::tare() const { return c::imu_tare(_port); }
+std::int32_t Imu::tare_euler() const { return c::imu_tare_euler(_port); }
+
+std::int32_t Imu::set_heading(const double target) const {
+  return c::imu_set_heading(_port, target);
+}
+
+std::int32_t Imu::set_rotation(const double target) const {
+  return c::imu_set_rotation(_port, target);
+}
+
+std::int32_t Imu::set_yaw(const double target) const {
+  return c::imu_set_yaw(_port, target);
+}
+
+std::int32_t Imu::set_pitch(const double target) const {
+  return c::imu_set_pitch(_port, target);
+}
+
+std::int32_t Imu::set_roll(const double target) const {
+  return c::imu_set_roll(_port, target);
+}
+
+std::int32_t Imu::set_euler(const euler_s_t target) const {
+  return c::imu_set_euler(_port, target);
+}
+}  // namespace pros::v5
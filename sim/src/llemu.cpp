@@ -0,0 +1,100 @@
+// The emulated LCD keeps its eight lines in memory; there is no screen to draw
+// them on
+
+#include "liblvgl/llemu.hpp"
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+namespace {
+constexpr int kLines = 8;
+
+std::mutex lcdMutex;
+bool initialized = false;
+std::string lines[kLines];
+
+bool setLine(int16_t line, const char *text) {
+  std::lock_guard<std::mutex> lock(lcdMutex);
+  if (!initialized) {
+    errno = ENXIO;
+    return false;
+  }
+  if (line < 0 || line >= kLines) {
+    errno = EINVAL;
+    return false;
+  }
+  lines[line] = text;
+  return true;
+}
+}  // namespace
+
+namespace pros::c {
+bool lcd_is_initialized(void) {
+  std::lock_guard<std::mutex> lock(lcdMutex);
+  return initialized;
+}
+
+bool lcd_initialize(void) {
+  std::lock_guard<std::mutex> lock(lcdMutex);
+  initialized = true;
+  return true;
+}
+
+bool lcd_shutdown(void) {
+  std::lock_guard<std::mutex> lock(lcdMutex);
+  initialized = false;
+  return true;
+}
+
+bool lcd_print(int16_t line, const char *fmt, ...) {
+  char text[64];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(text, sizeof(text), fmt, args);
+  va_end(args);
+  return setLine(line, text);
+}
+
+bool lcd_set_text(int16_t line, const char *text) { return setLine(line, text); }
+
+bool lcd_clear(void) {
+  for (int16_t line = 0; line < kLines; line++) {
+    if (!setLine(line, "")) return false;
+  }
+  return true;
+}
+
+bool lcd_clear_line(int16_t line) { return setLine(line, ""); }
+
+bool lcd_register_btn0_cb(lcd_btn_cb_fn_t) { return true; }
+
+bool lcd_register_btn1_cb(lcd_btn_cb_fn_t) { return true; }
+
+bool lcd_register_btn2_cb(lcd_btn_cb_fn_t) { return true; }
+
+// nothing presses the buttons on the host
+uint8_t lcd_read_buttons(void) { return 0; }
+
+void lcd_set_text_align(text_align_e_t) {}
+}  // namespace pros::c
+
+namespace pros::lcd {
+bool is_initialized(void) { return c::lcd_is_initialized(); }
+bool initialize(void) { return c::lcd_initialize(); }
+bool shutdown(void) { return c::lcd_shutdown(); }
+
+bool set_text(std::int16_t line, std::string text) {
+  return c::lcd_set_text(line, text.c_str());
+}
+
+bool clear(void) { return c::lcd_clear(); }
+bool clear_line(std::int16_t line) { return c::lcd_clear_line(line); }
+void register_btn0_cb(lcd_btn_cb_fn_t cb) { c::lcd_register_btn0_cb(cb); }
+void register_btn1_cb(lcd_btn_cb_fn_t cb) { c::lcd_register_btn1_cb(cb); }
+void register_btn2_cb(lcd_btn_cb_fn_t cb) { c::lcd_register_btn2_cb(cb); }
+void set_text_align(Text_Align) {}
+std::uint8_t read_buttons(void) { return c::lcd_read_buttons(); }
+}  // namespace pros::lcd
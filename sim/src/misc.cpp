@@ -0,0 +1,252 @@
+// Simulated controller, battery and competition state. Controller input comes
+// from whatever drives sim::World::controller, normally the host entry point.
+// The SD card is in card.cpp
+
+#include "pros/misc.hpp"
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#include "pros/error.h"
+#include "sim/world.h"
+
+namespace {
+template <typename F>
+std::int32_t withController(pros::controller_id_e_t id, F &&f) {
+  if (id != pros::E_CONTROLLER_MASTER && id != pros::E_CONTROLLER_PARTNER) {
+    errno = EINVAL;
+    return PROS_ERR;
+  }
+  sim::world().sync();
+  sim::ControllerState &controller = sim::world().controller(id);
+  if (!controller.connected) {
+    errno = EACCES;
+    return PROS_ERR;
+  }
+  return f(controller);
+}
+
+bool validButton(pros::controller_digital_e_t button) {
+  return button >= pros::E_CONTROLLER_DIGITAL_L1 &&
+         button <= pros::E_CONTROLLER_DIGITAL_A;
+}
+
+std::uint8_t competitionStatus() {
+  sim::world().sync();
+  return sim::world().competition;
+}
+}  // namespace
+
+namespace pros::c {
+uint8_t competition_get_status(void) { return competitionStatus(); }
+
+uint8_t competition_is_disabled(void) {
+  return (competitionStatus() & COMPETITION_DISABLED) != 0;
+}
+
+uint8_t competition_is_connected(void) {
+  return (competitionStatus() & COMPETITION_CONNECTED) != 0;
+}
+
+uint8_t competition_is_autonomous(void) {
+  return (competitionStatus() & COMPETITION_AUTONOMOUS) != 0;
+}
+
+uint8_t competition_is_field(void) {
+  return (competitionStatus() & COMPETITION_SYSTEM) != 0;
+}
+
+uint8_t competition_is_switch(void) {
+  uint8_t status = competitionStatus();
+  return (status & COMPETITION_CONNECTED) && !(status & COMPETITION_SYSTEM);
+}
+
+int32_t controller_is_connected(controller_id_e_t id) {
+  sim::world().sync();
+  return sim::world().controller(id).connected;
+}
+
+int32_t controller_get_analog(controller_id_e_t id,
+                              controller_analog_e_t channel) {
+  if (channel < E_CONTROLLER_ANALOG_LEFT_X ||
+      channel > E_CONTROLLER_ANALOG_RIGHT_Y) {
+    errno = EINVAL;
+    return 0;
+  }
+  return withController(id, [&](sim::ControllerState &controller) {
+    return controller.analog[channel];
+  });
+}
+
+int32_t controller_get_battery_capacity(controller_id_e_t id) {
+  return withController(id, [](sim::ControllerState &) { return 100; });
+}
+
+int32_t controller_get_battery_level(controller_id_e_t id) {
+  return withController(id, [](sim::ControllerState &) { return 100; });
+}
+
+int32_t controller_get_digital(controller_id_e_t id,
+                               controller_digital_e_t button) {
+  if (!validButton(button)) {
+    errno = EINVAL;
+    return 0;
+  }
+  return withController(id, [&](sim::ControllerState &controller) {
+    return int32_t(controller.digital[button]);
+  });
+}
+
+// a press is new if the button was released the last time this was called for
+// it, the same as the kernel
+int32_t controller_get_digital_new_press(controller_id_e_t id,
+                                         controller_digital_e_t button) {
+  if (!validButton(button)) {
+    errno = EINVAL;
+    return 0;
+  }
+  return withController(id, [&](sim::ControllerState &controller) {
+    bool pressed = controller.digital[button] && !controller.reported[button];
+    controller.reported[button] = controller.digital[button];
+    return int32_t(pressed);
+  });
+}
+
+int32_t controller_print(controller_id_e_t id, uint8_t line, uint8_t col,
+                         const char *fmt, ...) {
+  char text[20];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(text, sizeof(text), fmt, args);
+  va_end(args);
+  return controller_set_text(id, line, col, text);
+}
+
+int32_t controller_set_text(controller_id_e_t id, uint8_t line, uint8_t col,
+                            const char *str) {
+  if (line > 2 || col > 18) {
+    errno = EINVAL;
+    return PROS_ERR;
+  }
+  return withController(id, [&](sim::ControllerState &controller) {
+    char *row = controller.text[line];
+    std::size_t length = std::min<std::size_t>(std::strlen(str), 19 - col);
+    std::memcpy(row + col, str, length);
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t controller_clear_line(controller_id_e_t id, uint8_t line) {
+  if (line > 2) {
+    errno = EINVAL;
+    return PROS_ERR;
+  }
+  return withController(id, [&](sim::ControllerState &controller) {
+    std::memset(controller.text[line], 0, sizeof(controller.text[line]));
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t controller_clear(controller_id_e_t id) {
+  return withController(id, [](sim::ControllerState &controller) {
+    std::memset(controller.text, 0, sizeof(controller.text));
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t controller_rumble(controller_id_e_t id, const char *rumble_pattern) {
+  return withController(id, [](sim::ControllerState &) { return PROS_SUCCESS; });
+}
+
+int32_t battery_get_voltage(void) {
+  sim::world().sync();
+  return sim::world().battery().voltage;
+}
+
+int32_t battery_get_current(void) {
+  sim::world().sync();
+  return sim::world().battery().current;
+}
+
+double battery_get_temperature(void) {
+  sim::world().sync();
+  return sim::world().battery().temperature;
+}
+
+double battery_get_capacity(void) {
+  sim::world().sync();
+  return sim::world().battery().capacity;
+}
+}  // namespace pros::c
+
+namespace pros {
+namespace v5 {
+Controller::Controller(controller_id_e_t id) : _id(id) {}
+
+std::int32_t Controller::is_connected(void) {
+  return c::controller_is_connected(_id);
+}
+
+std::int32_t Controller::get_analog(controller_analog_e_t channel) {
+  return c::controller_get_analog(_id, channel);
+}
+
+std::int32_t Controller::get_battery_capacity(void) {
+  return c::controller_get_battery_capacity(_id);
+}
+
+std::int32_t Controller::get_battery_level(void) {
+  return c::controller_get_battery_level(_id);
+}
+
+std::int32_t Controller::get_digital(controller_digital_e_t button) {
+  return c::controller_get_digital(_id, button);
+}
+
+std::int32_t Controller::get_digital_new_press(controller_digital_e_t button) {
+  return c::controller_get_digital_new_press(_id, button);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col,
+                                  const char *str) {
+  return c::controller_set_text(_id, line, col, str);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col,
+                                  const std::string &str) {
+  return c::controller_set_text(_id, line, col, str.c_str());
+}
+
+std::int32_t Controller::clear_line(std::uint8_t line) {
+  return c::controller_clear_line(_id, line);
+}
+
+std::int32_t Controller::rumble(const char *rumble_pattern) {
+  return c::controller_rumble(_id, rumble_pattern);
+}
+
+std::int32_t Controller::clear(void) { return c::controller_clear(_id); }
+}  // namespace v5
+
+namespace battery {
+double get_capacity(void) { return c::battery_get_capacity(); }
+int32_t get_current(void) { return c::battery_get_current(); }
+double get_temperature(void) { return c::battery_get_temperature(); }
+int32_t get_voltage(void) { return c::battery_get_voltage(); }
+}  // namespace battery
+
+namespace competition {
+std::uint8_t get_status(void) { return c::competition_get_status(); }
+std::uint8_t is_autonomous(void) { return c::competition_is_autonomous(); }
+std::uint8_t is_connected(void) { return c::competition_is_connected(); }
+std::uint8_t is_disabled(void) { return c::competition_is_disabled(); }
+std::uint8_t is_field_control(void) { return c::competition_is_field(); }
+std::uint8_t is_competition_switch(void) { return c::competition_is_switch(); }
+}  // namespace competition
+
+namespace usd {
+std::int32_t is_installed(void) { return c::usd_is_installed(); }
+}  // namespace usd
+}  // namespace pros
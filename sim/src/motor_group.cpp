@@ -0,0 +1,446 @@
+#include "pros/motor_group.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+
+#include "pros/error.h"
+
+namespace {
+// PROS_SUCCESS when `f` succeeds on every port, otherwise PROS_ERR. Every port
+// is still commanded, the same as the kernel
+template <typename F>
+std::int32_t forEach(const std::vector<std::int8_t> &ports, F &&f) {
+  std::int32_t result = PROS_SUCCESS;
+  for (std::int8_t port : ports) {
+    if (f(port) == PROS_ERR) result = PROS_ERR;
+  }
+  return result;
+}
+
+bool inRange(const std::vector<std::int8_t> &ports, std::uint8_t index) {
+  if (index < ports.size()) return true;
+  errno = EOVERFLOW;
+  return false;
+}
+}  // namespace
+
+namespace pros::v5 {
+MotorGroup::MotorGroup(const std::initializer_list<std::int8_t> ports,
+                       const MotorGears gearset, const MotorUnits encoder_units)
+    : MotorGroup(std::vector<std::int8_t>(ports), gearset, encoder_units) {}
+
+MotorGroup::MotorGroup(const std::vector<std::int8_t> &ports,
+                       const MotorGears gearset, const MotorUnits encoder_units)
+    : _ports(ports) {
+  set_gearing_all(gearset);
+  set_encoder_units_all(encoder_units);
+}
+
+MotorGroup::MotorGroup(AbstractMotor &motor_group)
+    : _ports(motor_group.get_port_all()) {}
+
+void MotorGroup::operator+=(AbstractMotor &other) { append(other); }
+
+void MotorGroup::append(AbstractMotor &other) {
+  for (std::int8_t port : other.get_port_all()) _ports.push_back(port);
+}
+
+void MotorGroup::erase_port(std::int8_t port) {
+  _ports.erase(std::remove_if(_ports.begin(), _ports.end(),
+                              [port](std::int8_t p) {
+                                return std::abs(p) == std::abs(port);
+                              }),
+               _ports.end());
+}
+
+std::int32_t MotorGroup::move(std::int32_t voltage) const {
+  return forEach(_ports, [&](std::int8_t port) { return c::motor_move(port, voltage); });
+}
+
+std::int32_t MotorGroup::move_absolute(const double position, const std::int32_t velocity) const {
+  return forEach(_ports, [&](std::int8_t port) { return c::motor_move_absolute(port, position, velocity); });
+}
+
+std::int32_t MotorGroup::move_relative(const double position, const std::int32_t velocity) const {
+  return forEach(_ports, [&](std::int8_t port) { return c::motor_move_relative(port, position, velocity); });
+}
+
+std::int32_t MotorGroup::move_velocity(const std::int32_t velocity) const {
+  return forEach(_ports, [&](std::int8_t port) { return c::motor_move_velocity(port, velocity); });
+}
+
+std::int32_t MotorGroup::move_voltage(const std::int32_t voltage) const {
+  return forEach(_ports, [&](std::int8_t port) { return c::motor_move_voltage(port, voltage); });
+}
+
+std::int32_t MotorGroup::brake(void) const {
+  return forEach(_ports, [&](std::int8_t port) { return c::motor_brake(port); });
+}
+
+std::int32_t MotorGroup::modify_profiled_velocity(const std::int32_t velocity) const {
+  return forEach(_ports, [&](std::int8_t port) { return c::motor_modify_profiled_velocity(port, velocity); });
+}
+
+double MotorGroup::get_target_position(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR_F;
+  return c::motor_get_target_position(_ports[index]);
+}
+
+std::vector<double> MotorGroup::get_target_position_all(void) const {
+  std::vector<double> out;
+  for (std::int8_t port : _ports) out.push_back(c::motor_get_target_position(port));
+  return out;
+}
+
+std::int32_t MotorGroup::get_target_velocity(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_get_target_velocity(_ports[index]);
+}
+
+std::vector<std::int32_t> MotorGroup::get_target_velocity_all(void) const {
+  std::vector<std::int32_t> out;
+  for (std::int8_t port : _ports) out.push_back(c::motor_get_target_velocity(port));
+  return out;
+}
+
+double MotorGroup::get_actual_velocity(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR_F;
+  return c::motor_get_actual_velocity(_ports[index]);
+}
+
+std::vector<double> MotorGroup::get_actual_velocity_all(void) const {
+  std::vector<double> out;
+  for (std::int8_t port : _ports) out.push_back(c::motor_get_actual_velocity(port));
+  return out;
+}
+
+std::int32_t MotorGroup::get_current_draw(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_get_current_draw(_ports[index]);
+}
+
+std::vector<std::int32_t> MotorGroup::get_current_draw_all(void) const {
+  std::vector<std::int32_t> out;
+  for (std::int8_t port : _ports) out.push_back(c::motor_get_current_draw(port));
+  return out;
+}
+
+std::int32_t MotorGroup::get_direction(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_get_direction(_ports[index]);
+}
+
+std::vector<std::int32_t> MotorGroup::get_direction_all(void) const {
+  std::vector<std::int32_t> out;
+  for (std::int8_t port : _ports) out.push_back(c::motor_get_direction(port));
+  return out;
+}
+
+double MotorGroup::get_efficiency(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR_F;
+  return c::motor_get_efficiency(_ports[index]);
+}
+
+std::vector<double> MotorGroup::get_efficiency_all(void) const {
+  std::vector<double> out;
+  for (std::int8_t port : _ports) out.push_back(c::motor_get_efficiency(port));
+  return out;
+}
+
+std::uint32_t MotorGroup::get_faults(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_get_faults(_ports[index]);
+}
+
+std::vector<std::uint32_t> MotorGroup::get_faults_all(void) const {
+  std::vector<std::uint32_t> out;
+  for (std::int8_t port : _ports) out.push_back(c::motor_get_faults(port));
+  return out;
+}
+
+std::uint32_t MotorGroup::get_flags(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_get_flags(_ports[index]);
+}
+
+std::vector<std::uint32_t> MotorGroup::get_flags_all(void) const {
+  std::vector<std::uint32_t> out;
+  for (std::int8_t port : _ports) out.push_back(c::motor_get_flags(port));
+  return out;
+}
+
+double MotorGroup::get_position(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR_F;
+  return c::motor_get_position(_ports[index]);
+}
+
+std::vector<double> MotorGroup::get_position_all(void) const {
+  std::vector<double> out;
+  for (std::int8_t port : _ports) out.push_back(c::motor_get_position(port));
+  return out;
+}
+
+double MotorGroup::get_power(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR_F;
+  return c::motor_get_power(_ports[index]);
+}
+
+std::vector<double> MotorGroup::get_power_all(void) const {
+  std::vector<double> out;
+  for (std::int8_t port : _ports) out.push_back(c::motor_get_power(port));
+  return out;
+}
+
+double MotorGroup::get_temperature(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR_F;
+  return c::motor_get_temperature(_ports[index]);
+}
+
+std::vector<double> MotorGroup::get_temperature_all(void) const {
+  std::vector<double> out;
+  for (std::int8_t port : _ports) out.push_back(c::motor_get_temperature(port));
+  return out;
+}
+
+double MotorGroup::get_torque(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR_F;
+  return c::motor_get_torque(_ports[index]);
+}
+
+std::vector<double> MotorGroup::get_torque_all(void) const {
+  std::vector<double> out;
+  for (std::int8_t port : _ports) out.push_back(c::motor_get_torque(port));
+  return out;
+}
+
+std::int32_t MotorGroup::get_voltage(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_get_voltage(_ports[index]);
+}
+
+std::vector<std::int32_t> MotorGroup::get_voltage_all(void) const {
+  std::vector<std::int32_t> out;
+  for (std::int8_t port : _ports) out.push_back(c::motor_get_voltage(port));
+  return out;
+}
+
+std::int32_t MotorGroup::is_over_current(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_is_over_current(_ports[index]);
+}
+
+std::vector<std::int32_t> MotorGroup::is_over_current_all(void) const {
+  std::vector<std::int32_t> out;
+  for (std::int8_t port : _ports) out.push_back(c::motor_is_over_current(port));
+  return out;
+}
+
+std::int32_t MotorGroup::is_over_temp(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_is_over_temp(_ports[index]);
+}
+
+std::vector<std::int32_t> MotorGroup::is_over_temp_all(void) const {
+  std::vector<std::int32_t> out;
+  for (std::int8_t port : _ports) out.push_back(c::motor_is_over_temp(port));
+  return out;
+}
+
+MotorBrake MotorGroup::get_brake_mode(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return MotorBrake::invalid;
+  return static_cast<MotorBrake>(c::motor_get_brake_mode(_ports[index]));
+}
+
+std::vector<MotorBrake> MotorGroup::get_brake_mode_all(void) const {
+  std::vector<MotorBrake> out;
+  for (std::int8_t port : _ports) out.push_back(static_cast<MotorBrake>(c::motor_get_brake_mode(port)));
+  return out;
+}
+
+std::int32_t MotorGroup::get_current_limit(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_get_current_limit(_ports[index]);
+}
+
+std::vector<std::int32_t> MotorGroup::get_current_limit_all(void) const {
+  std::vector<std::int32_t> out;
+  for (std::int8_t port : _ports) out.push_back(c::motor_get_current_limit(port));
+  return out;
+}
+
+MotorUnits MotorGroup::get_encoder_units(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return MotorUnits::invalid;
+  return static_cast<MotorUnits>(c::motor_get_encoder_units(_ports[index]));
+}
+
+std::vector<MotorUnits> MotorGroup::get_encoder_units_all(void) const {
+  std::vector<MotorUnits> out;
+  for (std::int8_t port : _ports) out.push_back(static_cast<MotorUnits>(c::motor_get_encoder_units(port)));
+  return out;
+}
+
+MotorGears MotorGroup::get_gearing(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return MotorGears::invalid;
+  return static_cast<MotorGears>(c::motor_get_gearing(_ports[index]));
+}
+
+std::vector<MotorGears> MotorGroup::get_gearing_all(void) const {
+  std::vector<MotorGears> out;
+  for (std::int8_t port : _ports) out.push_back(static_cast<MotorGears>(c::motor_get_gearing(port)));
+  return out;
+}
+
+std::int32_t MotorGroup::get_voltage_limit(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_get_voltage_limit(_ports[index]);
+}
+
+std::vector<std::int32_t> MotorGroup::get_voltage_limit_all(void) const {
+  std::vector<std::int32_t> out;
+  for (std::int8_t port : _ports) out.push_back(c::motor_get_voltage_limit(port));
+  return out;
+}
+
+std::int32_t MotorGroup::set_brake_mode(const MotorBrake mode, const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_set_brake_mode(_ports[index], static_cast<motor_brake_mode_e_t>(mode));
+}
+
+std::int32_t MotorGroup::set_brake_mode_all(const MotorBrake mode) const {
+  return forEach(_ports, [&](std::int8_t port) { return c::motor_set_brake_mode(port, static_cast<motor_brake_mode_e_t>(mode)); });
+}
+
+std::int32_t MotorGroup::set_brake_mode(const pros::motor_brake_mode_e_t mode, const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_set_brake_mode(_ports[index], mode);
+}
+
+std::int32_t MotorGroup::set_brake_mode_all(const pros::motor_brake_mode_e_t mode) const {
+  return forEach(_ports, [&](std::int8_t port) { return c::motor_set_brake_mode(port, mode); });
+}
+
+std::int32_t MotorGroup::set_current_limit(const std::int32_t limit, const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_set_current_limit(_ports[index], limit);
+}
+
+std::int32_t MotorGroup::set_current_limit_all(const std::int32_t limit) const {
+  return forEach(_ports, [&](std::int8_t port) { return c::motor_set_current_limit(port, limit); });
+}
+
+std::int32_t MotorGroup::set_encoder_units(const MotorUnits units, const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_set_encoder_units(_ports[index], static_cast<motor_encoder_units_e_t>(units));
+}
+
+std::int32_t MotorGroup::set_encoder_units_all(const MotorUnits units) const {
+  return forEach(_ports, [&](std::int8_t port) { return c::motor_set_encoder_units(port, static_cast<motor_encoder_units_e_t>(units)); });
+}
+
+std::int32_t MotorGroup::set_encoder_units(const pros::motor_encoder_units_e_t units, const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_set_encoder_units(_ports[index], units);
+}
+
+std::int32_t MotorGroup::set_encoder_units_all(const pros::motor_encoder_units_e_t units) const {
+  return forEach(_ports, [&](std::int8_t port) { return c::motor_set_encoder_units(port, units); });
+}
+
+std::int32_t MotorGroup::set_gearing(const MotorGears gearset, const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_set_gearing(_ports[index], static_cast<motor_gearset_e_t>(gearset));
+}
+
+std::int32_t MotorGroup::set_gearing_all(const MotorGears gearset) const {
+  return forEach(_ports, [&](std::int8_t port) { return c::motor_set_gearing(port, static_cast<motor_gearset_e_t>(gearset)); });
+}
+
+std::int32_t MotorGroup::set_gearing(const pros::motor_gearset_e_t gearset, const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_set_gearing(_ports[index], gearset);
+}
+
+std::int32_t MotorGroup::set_gearing_all(const pros::motor_gearset_e_t gearset) const {
+  return forEach(_ports, [&](std::int8_t port) { return c::motor_set_gearing(port, gearset); });
+}
+
+std::int32_t MotorGroup::set_voltage_limit(const std::int32_t limit, const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_set_voltage_limit(_ports[index], limit);
+}
+
+std::int32_t MotorGroup::set_voltage_limit_all(const std::int32_t limit) const {
+  return forEach(_ports, [&](std::int8_t port) { return c::motor_set_voltage_limit(port, limit); });
+}
+
+std::int32_t MotorGroup::set_zero_position(const double position, const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_set_zero_position(_ports[index], position);
+}
+
+std::int32_t MotorGroup::set_zero_position_all(const double position) const {
+  return forEach(_ports, [&](std::int8_t port) { return c::motor_set_zero_position(port, position); });
+}
+
+
+std::int32_t MotorGroup::get_raw_position(std::uint32_t *const timestamp,
+                                          const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_get_raw_position(_ports[index], timestamp);
+}
+
+std::vector<std::int32_t> MotorGroup::get_raw_position_all(
+    std::uint32_t *const timestamp) const {
+  std::vector<std::int32_t> out;
+  for (std::int8_t port : _ports) {
+    out.push_back(c::motor_get_raw_position(port, timestamp));
+  }
+  return out;
+}
+
+std::int32_t MotorGroup::is_reversed(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return _ports[index] < 0;
+}
+
+std::vector<std::int32_t> MotorGroup::is_reversed_all(void) const {
+  std::vector<std::int32_t> out;
+  for (std::int8_t port : _ports) out.push_back(port < 0);
+  return out;
+}
+
+std::int32_t MotorGroup::set_reversed(const bool reverse,
+                                      const std::uint8_t index) {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  _ports[index] = reverse ? -std::abs(_ports[index]) : std::abs(_ports[index]);
+  return PROS_SUCCESS;
+}
+
+std::int32_t MotorGroup::set_reversed_all(const bool reverse) {
+  for (std::int8_t &port : _ports) {
+    port = reverse ? -std::abs(port) : std::abs(port);
+  }
+  return PROS_SUCCESS;
+}
+
+std::int32_t MotorGroup::tare_position(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR;
+  return c::motor_tare_position(_ports[index]);
+}
+
+std::int32_t MotorGroup::tare_position_all(void) const {
+  return forEach(_ports,
+                 [](std::int8_t port) { return c::motor_tare_position(port); });
+}
+
+std::int8_t MotorGroup::size(void) const { return _ports.size(); }
+
+std::int8_t MotorGroup::get_port(const std::uint8_t index) const {
+  if (!inRange(_ports, index)) return PROS_ERR_BYTE;
+  return _ports[index];
+}
+
+std::vector<std::int8_t> MotorGroup::get_port_all(void) const { return _ports; }
+}  // namespace pros::v5
@@ -0,0 +1,620 @@
+// Simulated smart motors. The C API owns the behaviour; pros::Motor and
+// pros::MotorGroup forward to it, the same way the kernel is layered
+
+#include "pros/motors.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "pros/error.h"
+#include "sim/world.h"
+
+namespace {
+using sim::MotorPort;
+
+// runs `f` against the motor on a signed port, with the world synced. Reversed
+// ports see every command and reading mirrored
+template <typename T, typename F> auto withMotor(std::int8_t port, T error, F &&f) {
+  int index = std::abs(port);
+  using R = std::invoke_result_t<F, MotorPort &, int>;
+  return sim::withDevice(index, pros::DeviceType::motor, error, [&]() -> R {
+    return f(sim::world().motor(index), port < 0 ? -1 : 1);
+  });
+}
+
+double unitsPerDegree(const MotorPort &motor) {
+  switch (motor.units) {
+    case pros::MotorUnits::rotations:
+      return 1.0 / 360;
+    case pros::MotorUnits::counts:
+      return sim::motorModel(motor.gearset).countsPerRev / 360;
+    default:
+      return 1;
+  }
+}
+
+// position reading of a shaft angle, in the motor's encoder units
+double position(const MotorPort &motor, double angle, int dir) {
+  return dir * (angle - motor.zero) * unitsPerDegree(motor);
+}
+
+// shaft angle of a position in the motor's encoder units
+double angle(const MotorPort &motor, double position, int dir) {
+  return motor.zero + dir * position / unitsPerDegree(motor);
+}
+
+// stops the motor according to its brake mode, holding the current angle
+std::int32_t stop(MotorPort &motor) {
+  motor.mode = MotorPort::Mode::brake;
+  motor.target = motor.state.angle;
+  return PROS_SUCCESS;
+}
+}  // namespace
+
+namespace pros::c {
+int32_t motor_move(int8_t port, int32_t voltage) {
+  voltage = std::clamp<int32_t>(voltage, -127, 127);
+  return motor_move_voltage(port, voltage * 12000 / 127);
+}
+
+int32_t motor_brake(int8_t port) {
+  return withMotor(port, PROS_ERR, [](MotorPort &m, int) { return stop(m); });
+}
+
+int32_t motor_move_absolute(int8_t port, double position,
+                            const int32_t velocity) {
+  return withMotor(port, PROS_ERR, [&](MotorPort &m, int dir) {
+    m.mode = MotorPort::Mode::position;
+    m.target = angle(m, position, dir);
+    m.profileVelocity = std::abs(velocity);
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t motor_move_relative(int8_t port, double position,
+                            const int32_t velocity) {
+  return withMotor(port, PROS_ERR, [&](MotorPort &m, int dir) {
+    double from =
+        m.mode == MotorPort::Mode::position ? m.target : m.state.angle;
+    m.mode = MotorPort::Mode::position;
+    m.target = from + dir * position / unitsPerDegree(m);
+    m.profileVelocity = std::abs(velocity);
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t motor_move_velocity(int8_t port, const int32_t velocity) {
+  return withMotor(port, PROS_ERR, [&](MotorPort &m, int dir) {
+    if (velocity == 0) return stop(m);
+    m.mode = MotorPort::Mode::velocity;
+    m.target = dir * velocity;
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t motor_move_voltage(int8_t port, const int32_t voltage) {
+  return withMotor(port, PROS_ERR, [&](MotorPort &m, int dir) {
+    if (voltage == 0) return stop(m);
+    m.mode = MotorPort::Mode::voltage;
+    m.target = dir * std::clamp<int32_t>(voltage, -12000, 12000);
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t motor_modify_profiled_velocity(int8_t port, const int32_t velocity) {
+  return withMotor(port, PROS_ERR, [&](MotorPort &m, int) {
+    m.profileVelocity = std::abs(velocity);
+    return PROS_SUCCESS;
+  });
+}
+
+double motor_get_target_position(int8_t port) {
+  return withMotor(port, PROS_ERR_F, [](MotorPort &m, int dir) {
+    return m.mode == MotorPort::Mode::position ? position(m, m.target, dir)
+                                               : 0.0;
+  });
+}
+
+int32_t motor_get_target_velocity(int8_t port) {
+  return withMotor(port, PROS_ERR, [](MotorPort &m, int dir) {
+    return m.mode == MotorPort::Mode::velocity
+               ? static_cast<int32_t>(dir * m.target)
+               : 0;
+  });
+}
+
+double motor_get_actual_velocity(int8_t port) {
+  return withMotor(port, PROS_ERR_F, [](MotorPort &m, int dir) {
+    return dir * m.report.value.velocity;
+  });
+}
+
+int32_t motor_get_current_draw(int8_t port) {
+  return withMotor(port, PROS_ERR, [](MotorPort &m, int) {
+    return static_cast<int32_t>(std::abs(m.report.value.current));
+  });
+}
+
+int32_t motor_get_direction(int8_t port) {
+  return withMotor(port, PROS_ERR, [](MotorPort &m, int dir) {
+    return dir * m.report.value.velocity < 0 ? -1 : 1;
+  });
+}
+
+double motor_get_efficiency(int8_t port) {
+  return withMotor(port, PROS_ERR_F, [](MotorPort &m, int) {
+    const sim::MotorReport &r = m.report.value;
+    double input = std::abs(r.voltage * r.current);
+    double output = std::abs(r.torque * r.velocity * 2 * M_PI / 60) * 1e6;
+    return input > 0 ? std::min(100.0, 100 * output / input) : 0.0;
+  });
+}
+
+int32_t motor_is_over_current(int8_t port) {
+  return withMotor(port, PROS_ERR, [](MotorPort &m, int) {
+    return static_cast<int32_t>(std::abs(m.report.value.current) >=
+                                m.currentLimit);
+  });
+}
+
+int32_t motor_is_over_temp(int8_t port) {
+  return withMotor(port, PROS_ERR, [](MotorPort &m, int) {
+    return static_cast<int32_t>(m.report.value.temperature >= 55);
+  });
+}
+
+uint32_t motor_get_faults(int8_t port) {
+  return withMotor(port, static_cast<uint32_t>(PROS_ERR),
+                   [](MotorPort &m, int) {
+                     return static_cast<uint32_t>(
+                         m.report.value.temperature >= 55 ? 0x01 : 0);
+                   });
+}
+
+uint32_t motor_get_flags(int8_t port) {
+  return withMotor(port, static_cast<uint32_t>(PROS_ERR),
+                   [](MotorPort &, int) { return 0u; });
+}
+
+int32_t motor_get_raw_position(int8_t port, uint32_t *const timestamp) {
+  return withMotor(port, PROS_ERR, [&](MotorPort &m, int dir) {
+    if (timestamp) *timestamp = m.report.time;
+    double counts = sim::motorModel(m.gearset).countsPerRev / 360;
+    return static_cast<int32_t>(
+        std::lround(dir * (m.report.value.angle - m.zero) * counts));
+  });
+}
+
+double motor_get_position(int8_t port) {
+  return withMotor(port, PROS_ERR_F, [](MotorPort &m, int dir) {
+    return position(m, m.report.value.angle, dir);
+  });
+}
+
+double motor_get_power(int8_t port) {
+  return withMotor(port, PROS_ERR_F, [](MotorPort &m, int) {
+    return std::abs(m.report.value.voltage * m.report.value.current) / 1e6;
+  });
+}
+
+double motor_get_temperature(int8_t port) {
+  return withMotor(port, PROS_ERR_F, [](MotorPort &m, int) {
+    return m.report.value.temperature;
+  });
+}
+
+double motor_get_torque(int8_t port) {
+  return withMotor(port, PROS_ERR_F, [](MotorPort &m, int) {
+    return std::abs(m.report.value.torque);
+  });
+}
+
+int32_t motor_get_voltage(int8_t port) {
+  return withMotor(port, PROS_ERR, [](MotorPort &m, int dir) {
+    return static_cast<int32_t>(dir * m.report.value.voltage);
+  });
+}
+
+int32_t motor_set_zero_position(int8_t port, const double position) {
+  return withMotor(port, PROS_ERR, [&](MotorPort &m, int dir) {
+    m.zero = m.state.angle - dir * position / unitsPerDegree(m);
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t motor_tare_position(int8_t port) {
+  return motor_set_zero_position(port, 0);
+}
+
+int32_t motor_set_brake_mode(int8_t port, const motor_brake_mode_e_t mode) {
+  return withMotor(port, PROS_ERR, [&](MotorPort &m, int) {
+    m.brakeMode = static_cast<pros::MotorBrake>(mode);
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t motor_set_current_limit(int8_t port, const int32_t limit) {
+  return withMotor(port, PROS_ERR, [&](MotorPort &m, int) {
+    m.currentLimit = limit;
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t motor_set_encoder_units(int8_t port,
+                                const motor_encoder_units_e_t units) {
+  if (units == E_MOTOR_ENCODER_INVALID) return PROS_SUCCESS;
+  return withMotor(port, PROS_ERR, [&](MotorPort &m, int) {
+    m.units = static_cast<pros::MotorUnits>(units);
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t motor_set_gearing(int8_t port, const motor_gearset_e_t gearset) {
+  if (gearset == E_MOTOR_GEARSET_INVALID) return PROS_SUCCESS;
+  return withMotor(port, PROS_ERR, [&](MotorPort &m, int) {
+    m.gearset = static_cast<pros::MotorGears>(gearset);
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t motor_set_voltage_limit(int8_t port, const int32_t limit) {
+  return withMotor(port, PROS_ERR, [&](MotorPort &m, int) {
+    m.voltageLimit = limit;
+    return PROS_SUCCESS;
+  });
+}
+
+motor_brake_mode_e_t motor_get_brake_mode(int8_t port) {
+  return withMotor(port, E_MOTOR_BRAKE_INVALID, [](MotorPort &m, int) {
+    return static_cast<motor_brake_mode_e_t>(m.brakeMode);
+  });
+}
+
+int32_t motor_get_current_limit(int8_t port) {
+  return withMotor(port, PROS_ERR,
+                   [](MotorPort &m, int) { return m.currentLimit; });
+}
+
+motor_encoder_units_e_t motor_get_encoder_units(int8_t port) {
+  return withMotor(port, E_MOTOR_ENCODER_INVALID, [](MotorPort &m, int) {
+    return static_cast<motor_encoder_units_e_t>(m.units);
+  });
+}
+
+motor_gearset_e_t motor_get_gearing(int8_t port) {
+  return withMotor(port, E_MOTOR_GEARSET_INVALID, [](MotorPort &m, int) {
+    return static_cast<motor_gearset_e_t>(m.gearset);
+  });
+}
+
+int32_t motor_get_voltage_limit(int8_t port) {
+  return withMotor(port, PROS_ERR,
+                   [](MotorPort &m, int) { return m.voltageLimit; });
+}
+}  // namespace pros::c
+
+namespace pros::v5 {
+Motor::Motor(const std::int8_t port, const MotorGears gearset,
+             const MotorUnits encoder_units)
+    : Device(std::abs(port), DeviceType::motor), _port(port) {
+  set_gearing(gearset);
+  set_encoder_units(encoder_units);
+}
+
+std::int32_t Motor::move(std::int32_t voltage) const {
+  return c::motor_move(_port, voltage);
+}
+
+std::int32_t Motor::move_absolute(const double position, const std::int32_t velocity) const {
+  return c::motor_move_absolute(_port, position, velocity);
+}
+
+std::int32_t Motor::move_relative(const double position, const std::int32_t velocity) const {
+  return c::motor_move_relative(_port, position, velocity);
+}
+
+std::int32_t Motor::move_velocity(const std::int32_t velocity) const {
+  return c::motor_move_velocity(_port, velocity);
+}
+
+std::int32_t Motor::move_voltage(const std::int32_t voltage) const {
+  return c::motor_move_voltage(_port, voltage);
+}
+
+std::int32_t Motor::brake(void) const {
+  return c::motor_brake(_port);
+}
+
+std::int32_t Motor::modify_profiled_velocity(const std::int32_t velocity) const {
+  return c::motor_modify_profiled_velocity(_port, velocity);
+}
+
+double Motor::get_target_position(const std::uint8_t) const {
+  return c::motor_get_target_position(_port);
+}
+
+std::vector<double> Motor::get_target_position_all(void) const {
+  return {get_target_position()};
+}
+
+std::int32_t Motor::get_target_velocity(const std::uint8_t) const {
+  return c::motor_get_target_velocity(_port);
+}
+
+std::vector<std::int32_t> Motor::get_target_velocity_all(void) const {
+  return {get_target_velocity()};
+}
+
+double Motor::get_actual_velocity(const std::uint8_t) const {
+  return c::motor_get_actual_velocity(_port);
+}
+
+std::vector<double> Motor::get_actual_velocity_all(void) const {
+  return {get_actual_velocity()};
+}
+
+std::int32_t Motor::get_current_draw(const std::uint8_t) const {
+  return c::motor_get_current_draw(_port);
+}
+
+std::vector<std::int32_t> Motor::get_current_draw_all(void) const {
+  return {get_current_draw()};
+}
+
+std::int32_t Motor::get_direction(const std::uint8_t) const {
+  return c::motor_get_direction(_port);
+}
+
+std::vector<std::int32_t> Motor::get_direction_all(void) const {
+  return {get_direction()};
+}
+
+double Motor::get_efficiency(const std::uint8_t) const {
+  return c::motor_get_efficiency(_port);
+}
+
+std::vector<double> Motor::get_efficiency_all(void) const {
+  return {get_efficiency()};
+}
+
+std::uint32_t Motor::get_faults(const std::uint8_t) const {
+  return c::motor_get_faults(_port);
+}
+
+std::vector<std::uint32_t> Motor::get_faults_all(void) const {
+  return {get_faults()};
+}
+
+std::uint32_t Motor::get_flags(const std::uint8_t) const {
+  return c::motor_get_flags(_port);
+}
+
+std::vector<std::uint32_t> Motor::get_flags_all(void) const {
+  return {get_flags()};
+}
+
+double Motor::get_position(const std::uint8_t) const {
+  return c::motor_get_position(_port);
+}
+
+std::vector<double> Motor::get_position_all(void) const {
+  return {get_position()};
+}
+
+double Motor::get_power(const std::uint8_t) const {
+  return c::motor_get_power(_port);
+}
+
+std::vector<double> Motor::get_power_all(void) const {
+  return {get_power()};
+}
+
+double Motor::get_temperature(const std::uint8_t) const {
+  return c::motor_get_temperature(_port);
+}
+
+std::vector<double> Motor::get_temperature_all(void) const {
+  return {get_temperature()};
+}
+
+double Motor::get_torque(const std::uint8_t) const {
+  return c::motor_get_torque(_port);
+}
+
+std::vector<double> Motor::get_torque_all(void) const {
+  return {get_torque()};
+}
+
+std::int32_t Motor::get_voltage(const std::uint8_t) const {
+  return c::motor_get_voltage(_port);
+}
+
+std::vector<std::int32_t> Motor::get_voltage_all(void) const {
+  return {get_voltage()};
+}
+
+std::int32_t Motor::is_over_current(const std::uint8_t) const {
+  return c::motor_is_over_current(_port);
+}
+
+std::vector<std::int32_t> Motor::is_over_current_all(void) const {
+  return {is_over_current()};
+}
+
+std::int32_t Motor::is_over_temp(const std::uint8_t) const {
+  return c::motor_is_over_temp(_port);
+}
+
+std::vector<std::int32_t> Motor::is_over_temp_all(void) const {
+  return {is_over_temp()};
+}
+
+MotorBrake Motor::get_brake_mode(const std::uint8_t) const {
+  return static_cast<MotorBrake>(c::motor_get_brake_mode(_port));
+}
+
+std::vector<MotorBrake> Motor::get_brake_mode_all(void) const {
+  return {get_brake_mode()};
+}
+
+std::int32_t Motor::get_current_limit(const std::uint8_t) const {
+  return c::motor_get_current_limit(_port);
+}
+
+std::vector<std::int32_t> Motor::get_current_limit_all(void) const {
+  return {get_current_limit()};
+}
+
+MotorUnits Motor::get_encoder_units(const std::uint8_t) const {
+  return static_cast<MotorUnits>(c::motor_get_encoder_units(_port));
+}
+
+std::vector<MotorUnits> Motor::get_encoder_units_all(void) const {
+  return {get_encoder_units()};
+}
+
+MotorGears Motor::get_gearing(const std::uint8_t) const {
+  return static_cast<MotorGears>(c::motor_get_gearing(_port));
+}
+
+std::vector<MotorGears> Motor::get_gearing_all(void) const {
+  return {get_gearing()};
+}
+
+std::int32_t Motor::get_voltage_limit(const std::uint8_t) const {
+  return c::motor_get_voltage_limit(_port);
+}
+
+std::vector<std::int32_t> Motor::get_voltage_limit_all(void) const {
+  return {get_voltage_limit()};
+}
+
+std::int32_t Motor::set_brake_mode(const MotorBrake mode, const std::uint8_t) const {
+  return c::motor_set_brake_mode(_port, static_cast<motor_brake_mode_e_t>(mode));
+}
+
+std::int32_t Motor::set_brake_mode_all(const MotorBrake mode) const {
+  return set_brake_mode(mode);
+}
+
+std::int32_t Motor::set_brake_mode(const pros::motor_brake_mode_e_t mode, const std::uint8_t) const {
+  return c::motor_set_brake_mode(_port, mode);
+}
+
+std::int32_t Motor::set_brake_mode_all(const pros::motor_brake_mode_e_t mode) const {
+  return set_brake_mode(mode);
+}
+
+std::int32_t Motor::set_current_limit(const std::int32_t limit, const std::uint8_t) const {
+  return c::motor_set_current_limit(_port, limit);
+}
+
+std::int32_t Motor::set_current_limit_all(const std::int32_t limit) const {
+  return set_current_limit(limit);
+}
+
+std::int32_t Motor::set_encoder_units(const MotorUnits units, const std::uint8_t) const {
+  return c::motor_set_encoder_units(_port, static_cast<motor_encoder_units_e_t>(units));
+}
+
+std::int32_t Motor::set_encoder_units_all(const MotorUnits units) const {
+  return set_encoder_units(units);
+}
+
+std::int32_t Motor::set_encoder_units(const pros::motor_encoder_units_e_t units, const std::uint8_t) const {
+  return c::motor_set_encoder_units(_port, units);
+}
+
+std::int32_t Motor::set_encoder_units_all(const pros::motor_encoder_units_e_t units) const {
+  return set_encoder_units(units);
+}
+
+std::int32_t Motor::set_gearing(const MotorGears gearset, const std::uint8_t) const {
+  return c::motor_set_gearing(_port, static_cast<motor_gearset_e_t>(gearset));
+}
+
+std::int32_t Motor::set_gearing_all(const MotorGears gearset) const {
+  return set_gearing(gearset);
+}
+
+std::int32_t Motor::set_gearing(const pros::motor_gearset_e_t gearset, const std::uint8_t) const {
+  return c::motor_set_gearing(_port, gearset);
+}
+
+std::int32_t Motor::set_gearing_all(const pros::motor_gearset_e_t gearset) const {
+  return set_gearing(gearset);
+}
+
+std::int32_t Motor::set_voltage_limit(const std::int32_t limit, const std::uint8_t) const {
+  return c::motor_set_voltage_limit(_port, limit);
+}
+
+std::int32_t Motor::set_voltage_limit_all(const std::int32_t limit) const {
+  return set_voltage_limit(limit);
+}
+
+std::int32_t Motor::set_zero_position(const double position, const std::uint8_t) const {
+  return c::motor_set_zero_position(_port, position);
+}
+
+std::int32_t Motor::set_zero_position_all(const double position) const {
+  return set_zero_position(position);
+}
+
+
+std::int32_t Motor::get_raw_position(std::uint32_t *const timestamp,
+                                     const std::uint8_t) const {
+  return c::motor_get_raw_position(_port, timestamp);
+}
+
+std::vector<std::int32_t> Motor::get_raw_position_all(
+    std::uint32_t *const timestamp) const {
+  return {get_raw_position(timestamp)};
+}
+
+std::int32_t Motor::is_reversed(const std::uint8_t) const { return _port < 0; }
+
+std::vector<std::int32_t> Motor::is_reversed_all(void) const {
+  return {is_reversed()};
+}
+
+std::int32_t Motor::set_reversed(const bool reverse, const std::uint8_t) {
+  _port = reverse ? -std::abs(_port) : std::abs(_port);
+  return PROS_SUCCESS;
+}
+
+std::int32_t Motor::set_reversed_all(const bool reverse) {
+  return set_reversed(reverse);
+}
+
+std::int32_t Motor::tare_position(const std::uint8_t) const {
+  return c::motor_tare_position(_port);
+}
+
+std::int32_t Motor::tare_position_all(void) const { return tare_position(); }
+
+std::int8_t Motor::size(void) const { return 1; }
+
+std::int8_t Motor::get_port(const std::uint8_t) const { return _port; }
+
+std::vector<std::int8_t> Motor::get_port_all(void) const { return {_port}; }
+
+std::vector<Motor> Motor::get_all_devices() {
+  std::vector<Motor> motors;
+  for (int port = 1; port <= sim::kNumPorts; port++) {
+    if (sim::world().type(port) == DeviceType::motor) motors.emplace_back(port);
+  }
+  return motors;
+}
+
+namespace literals {
+const pros::Motor operator""_mtr(const unsigned long long int m) {
+  return Motor(static_cast<std::int8_t>(m));
+}
+
+const pros::Motor operator""_rmtr(const unsigned long long int m) {
+  return Motor(-static_cast<std::int8_t>(m));
+}
+}  // namespace literals
+}  // namespace pros::v5
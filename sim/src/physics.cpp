@@ -0,0 +1,75 @@
+#include "sim/physics.h"
+
+#include <cmath>
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+
+// Friction force that opposes motion without flipping sign every step when
+// the wheel is close to stationary
+double friction(double speed, double rolling, double viscous) {
+  return -rolling * std::tanh(speed / 0.01) - viscous * speed;
+}
+}  // namespace
+
+sim::MotorModel sim::motorModel(pros::MotorGears gearset) {
+  switch (gearset) {
+    case pros::MotorGears::red:
+      return {100, 2.1, 2500, 1800};
+    case pros::MotorGears::blue:
+      return {600, 0.35, 2500, 300};
+    default:
+      return {200, 1.05, 2500, 900};
+  }
+}
+
+double sim::motorTorque(const MotorModel &model, double voltage, double rpm) {
+  return model.stallTorque * (voltage / 12000.0 - rpm / model.freeSpeed);
+}
+
+sim::DrivetrainModel::DrivetrainModel(BodyParams body,
+                                      DrivetrainGeometry geometry)
+    : params(body), geometry(geometry) {}
+
+double sim::DrivetrainModel::leftSpeed() const {
+  return body.v + body.omega * geometry.trackWidth / 2;
+}
+
+double sim::DrivetrainModel::rightSpeed() const {
+  return body.v - body.omega * geometry.trackWidth / 2;
+}
+
+double sim::DrivetrainModel::wheelForce(double torque) const {
+  return torque / geometry.wheelPerMotor / geometry.wheelRadius;
+}
+
+double sim::DrivetrainModel::motorRpm(double sideSpeed) const {
+  double wheelRpm = sideSpeed / geometry.wheelRadius * 60 / (2 * kPi);
+  return wheelRpm / geometry.wheelPerMotor;
+}
+
+// Semi-implicit Euler: velocities first, then the pose with the new
+// velocities. Stable at the 1 ms step the world runs at
+void sim::DrivetrainModel::step(double leftForce, double rightForce,
+                                double dt) {
+  double halfTrack = geometry.trackWidth / 2;
+  leftForce +=
+      friction(leftSpeed(), params.rollingFriction, params.viscousFriction);
+  rightForce +=
+      friction(rightSpeed(), params.rollingFriction, params.viscousFriction);
+
+  double accel = (leftForce + rightForce) / params.mass;
+  double alpha = (leftForce - rightForce) * halfTrack / params.inertia;
+
+  body.v += accel * dt;
+  body.omega += alpha * dt;
+  body.accel = accel;
+  body.lateral = body.v * body.omega;
+
+  // integrate along the arc so straight lines and pure turns stay exact
+  double dTheta = body.omega * dt;
+  double heading = body.theta + dTheta / 2;
+  body.x += body.v * dt * std::sin(heading);
+  body.y += body.v * dt * std::cos(heading);
+  body.theta += dTheta;
+}
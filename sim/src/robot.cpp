@@ -0,0 +1,53 @@
+// The robot in src/main.cpp, as far as the physics model needs to know it.
+// Keep the sensor ports and tracking wheels in step with main.cpp
+
+#include "sim/robot.h"
+
+#include "lemlib/api.hpp"  // IWYU pragma: keep
+#include "sim/world.h"
+
+extern lemlib::Drivetrain drivetrain;
+
+namespace {
+constexpr double kInch = 0.0254;
+}  // namespace
+
+const sim::RobotDescription sim::robot = {
+    // inertial sensor port. main.cpp finds it with Imu::get_imu(), so it only
+    // has to be a port nothing else uses
+    6,
+    {
+        6.8,  // mass, kg (15 lb)
+        0.19, // moment of inertia, kg*m^2
+        4.0,  // rolling friction, N per side
+        2.0,  // viscous friction, N*s/m per side
+    },
+    0.005, // inertia behind the intake and stake motors, kg*m^2
+    {{
+        // horizontal tracking wheel: rotation sensor on port 4, new 2" omni,
+        // 2.5" offset
+        {WheelAxis::horizontal, 4, 0, 2.125, 2.5, 1},
+    }},
+    {
+        1,      // noise seed
+        0.01,   // gyro bias, degrees/s
+        0.003,  // gyro scale error
+        0.05,   // gyro noise, degrees/s
+        0.005,  // accelerometer noise, g
+        0.01,   // GPS position noise, m
+        0.5,    // GPS heading noise, degrees
+    },
+};
+
+void sim::attachRobot() {
+  auto cartridgeRpm = [](pros::MotorGroup *motors) {
+    return motorModel(motors->get_gearing()).freeSpeed;
+  };
+  DrivetrainGeometry geometry = {
+      drivetrain.trackWidth * kInch,
+      drivetrain.wheelDiameter / 2 * kInch,
+      drivetrain.rpm / cartridgeRpm(drivetrain.leftMotors),
+  };
+  world().attachDrivetrain(drivetrain.leftMotors->get_port_all(),
+                           drivetrain.rightMotors->get_port_all(), geometry);
+}
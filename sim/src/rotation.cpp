@@ -0,0 +1,145 @@
+// Simulated rotation sensor. Tracking wheels listed in the robot description
+// turn with the drivetrain model
+
+#include "pros/rotation.hpp"
+
+#include <cmath>
+#include <cstdlib>
+
+#include "pros/error.h"
+#include "sim/world.h"
+
+namespace {
+using sim::RotationPort;
+
+template <typename T, typename F> auto withRotation(std::uint8_t port, T error, F &&f) {
+  using R = std::invoke_result_t<F, RotationPort &, int>;
+  return sim::withDevice(port, pros::DeviceType::rotation, error, [&]() -> R {
+    RotationPort &rotation = sim::world().rotation(port);
+    return f(rotation, rotation.reversed ? -1 : 1);
+  });
+}
+}  // namespace
+
+namespace pros::c {
+int32_t rotation_reset(uint8_t port) {
+  return rotation_reset_position(port);
+}
+
+int32_t rotation_set_data_rate(uint8_t port, uint32_t rate) {
+  return withRotation(port, PROS_ERR, [&](RotationPort &r, int) {
+    // the sensor only supports multiples of 5 ms
+    rate = std::max<uint32_t>(5, rate - rate % 5);
+    r.report.period = rate;
+    r.velocityReport.period = rate;
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t rotation_set_position(uint8_t port, uint32_t position) {
+  return withRotation(port, PROS_ERR, [&](RotationPort &r, int dir) {
+    r.zero = r.angle - dir * static_cast<int32_t>(position);
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t rotation_reset_position(uint8_t port) {
+  return rotation_set_position(port, 0);
+}
+
+int32_t rotation_get_position(uint8_t port) {
+  return withRotation(port, PROS_ERR, [](RotationPort &r, int dir) {
+    return static_cast<int32_t>(std::lround(dir * (r.report.value - r.zero)));
+  });
+}
+
+int32_t rotation_get_velocity(uint8_t port) {
+  return withRotation(port, PROS_ERR, [](RotationPort &r, int dir) {
+    return static_cast<int32_t>(std::lround(dir * r.velocityReport.value));
+  });
+}
+
+int32_t rotation_get_angle(uint8_t port) {
+  return withRotation(port, PROS_ERR, [](RotationPort &r, int dir) {
+    int32_t angle = std::lround(dir * r.report.value);
+    return (angle % 36000 + 36000) % 36000;
+  });
+}
+
+// reversing keeps the reported position where it was
+int32_t rotation_set_reversed(uint8_t port, bool value) {
+  return withRotation(port, PROS_ERR, [&](RotationPort &r, int dir) {
+    if (r.reversed == value) return PROS_SUCCESS;
+    double position = dir * (r.angle - r.zero);
+    r.reversed = value;
+    r.zero = r.angle + dir * position;
+    return PROS_SUCCESS;
+  });
+}
+
+int32_t rotation_reverse(uint8_t port) {
+  int32_t reversed = rotation_get_reversed(port);
+  if (reversed == PROS_ERR) return PROS_ERR;
+  return rotation_set_reversed(port, !reversed);
+}
+
+int32_t rotation_init_reverse(uint8_t port, bool reverse_flag) {
+  return rotation_set_reversed(port, reverse_flag);
+}
+
+int32_t rotation_get_reversed(uint8_t port) {
+  return withRotation(port, PROS_ERR,
+                      [](RotationPort &r, int) { return int32_t(r.reversed); });
+}
+}  // namespace pros::c
+
+namespace pros::v5 {
+Rotation::Rotation(const std::int8_t port)
+    : Device(std::abs(port), DeviceType::rotation) {
+  if (port < 0) c::rotation_set_reversed(_port, true);
+}
+
+std::int32_t Rotation::reset() { return c::rotation_reset(_port); }
+
+std::int32_t Rotation::set_data_rate(std::uint32_t rate) const {
+  return c::rotation_set_data_rate(_port, rate);
+}
+
+std::int32_t Rotation::set_position(std::uint32_t position) const {
+  return c::rotation_set_position(_port, position);
+}
+
+std::int32_t Rotation::reset_position(void) const {
+  return c::rotation_reset_position(_port);
+}
+
+std::vector<Rotation> Rotation::get_all_devices() {
+  std::vector<Rotation> rotations;
+  for (int port = 1; port <= sim::kNumPorts; port++) {
+    if (sim::world().type(port) == DeviceType::rotation) {
+      rotations.emplace_back(port);
+    }
+  }
+  return rotations;
+}
+
+std::int32_t Rotation::get_position() const {
+  return c::rotation_get_position(_port);
+}
+
+std::int32_t Rotation::get_velocity() const {
+  return c::rotation_get_velocity(_port);
+}
+
+std::int32_t Rotation::get_angle() const { return c::rotation_get_angle(_port); }
+
+std::int32_t Rotation::set_reversed(bool value) const {
+  return c::rotation_set_reversed(_port, value);
+}
+
+std::int32_t Rotation::reverse() const { return c::rotation_reverse(_port); }
+
+std::int32_t Rotation::get_reversed() const {
+  return c::rotation_get_reversed(_port);
+}
+}  // namespace pros::v5
@@ -0,0 +1,534 @@
+// Host RTOS. Every PROS task is a thread, but only one of them runs at a time:
+// the scheduler passes the CPU between them the way FreeRTOS does, to the
+// highest priority ready task, round robin between equal priorities at each
+// 1 ms tick. Time is virtual. It moves when device calls charge for themselves
+// and, once every task is blocked, jumps straight to the next wakeup, so a run
+// takes a fraction of its match time and repeats exactly
+
+#include "pros/rtos.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sim/rtos.h"
+
+namespace {
+using pros::task_state_e_t;
+using Lock = std::unique_lock<std::mutex>;
+
+constexpr std::uint64_t kTick = 1000; // us
+constexpr std::uint64_t kForever = UINT64_MAX;
+// reading the clock is a kernel call too, so busy waits on it make progress
+constexpr std::uint64_t kClockReadCost = 1;
+
+struct HostMutex;
+
+struct Tcb {
+  std::string name;
+  std::uint32_t priority = TASK_PRIORITY_DEFAULT;
+  task_state_e_t state = pros::E_TASK_STATE_READY;
+  std::uint64_t readySince = 0;    // orders ready tasks of equal priority
+  std::uint64_t wakeAt = kForever; // us when a blocked task times out
+  bool waitingNotify = false;
+  HostMutex *waitingMutex = nullptr;
+  Tcb *joining = nullptr;
+  std::uint32_t notifyValue = 0;
+  bool notified = false;
+  // signalled when the task is given the CPU
+  std::condition_variable turn;
+};
+
+struct HostMutex {
+  Tcb *owner = nullptr;
+  std::vector<Tcb *> waiters; // in the order they blocked
+};
+
+std::mutex kernel;
+std::vector<Tcb *> tasks;
+Tcb *running = nullptr;
+std::uint64_t now = 0;      // us of virtual time
+std::uint64_t lastTick = 0; // tick the running task was last preempted at
+std::uint64_t sequence = 0;
+bool realtime = false;
+std::chrono::steady_clock::time_point wallStart;
+thread_local Tcb *self = nullptr;
+
+void makeReady(Tcb *task) {
+  task->state = pros::E_TASK_STATE_READY;
+  task->readySince = ++sequence;
+  task->wakeAt = kForever;
+}
+
+void block(Tcb *task, std::uint64_t wakeAt) {
+  task->state = pros::E_TASK_STATE_BLOCKED;
+  task->wakeAt = wakeAt;
+}
+
+// the wakeup `timeout` ms from now, counted in whole ticks like the kernel
+std::uint64_t after(std::uint32_t timeout) {
+  if (timeout == TIMEOUT_MAX) return kForever;
+  return (now / kTick + timeout) * kTick;
+}
+
+void leaveMutexQueue(Tcb *task) {
+  if (!task->waitingMutex) return;
+  std::vector<Tcb *> &waiters = task->waitingMutex->waiters;
+  waiters.erase(std::remove(waiters.begin(), waiters.end(), task), waiters.end());
+}
+
+// readies every blocked task whose timeout has passed
+void wakeExpired() {
+  for (Tcb *task : tasks) {
+    if (task->state == pros::E_TASK_STATE_BLOCKED && task->wakeAt <= now) {
+      leaveMutexQueue(task);
+      makeReady(task);
+    }
+  }
+}
+
+// the highest priority ready task, the one that has waited longest first
+Tcb *pick() {
+  Tcb *best = nullptr;
+  for (Tcb *task : tasks) {
+    if (task->state != pros::E_TASK_STATE_READY) continue;
+    if (!best || task->priority > best->priority ||
+        (task->priority == best->priority && task->readySince < best->readySince)) {
+      best = task;
+    }
+  }
+  return best;
+}
+
+// holds virtual time back to the wall clock when running in real time
+void pace() {
+  if (realtime) {
+    std::this_thread::sleep_until(wallStart + std::chrono::microseconds(now));
+  }
+}
+
+// Hands the CPU to the next task once the running one has stopped running.
+// With every task blocked, time skips ahead to the earliest wakeup
+void switchAway() {
+  wakeExpired();
+  Tcb *next;
+  while (!(next = pick())) {
+    std::uint64_t wakeAt = kForever;
+    for (Tcb *task : tasks) {
+      if (task->state == pros::E_TASK_STATE_BLOCKED) {
+        wakeAt = std::min(wakeAt, task->wakeAt);
+      }
+    }
+    if (wakeAt == kForever) {
+      std::fprintf(stderr, "sim: every task is blocked forever\n");
+      std::fflush(stdout);
+      std::_Exit(1);
+    }
+    now = std::max(now, wakeAt);
+    pace();
+    wakeExpired();
+  }
+  next->state = pros::E_TASK_STATE_RUNNING;
+  running = next;
+  lastTick = now / kTick;
+  if (next != self) next->turn.notify_one();
+}
+
+void reschedule(Lock &lock) {
+  switchAway();
+  self->turn.wait(lock, [] { return running == self; });
+}
+
+void yield(Lock &lock) {
+  makeReady(self);
+  reschedule(lock);
+}
+
+// yields to a ready task of higher priority than the caller, the way the
+// kernel does as soon as one is woken
+void yieldIfOutranked(Lock &lock) {
+  Tcb *next = pick();
+  if (next && next->priority > self->priority) yield(lock);
+}
+
+// the calling thread's task. Threads the RTOS did not start, like the host
+// entry point, become tasks the first time they need one
+Tcb *current(Lock &lock) {
+  if (!self) {
+    self = new Tcb{"main"};
+    tasks.push_back(self);
+    if (running) {
+      makeReady(self);
+      self->turn.wait(lock, [] { return running == self; });
+    } else {
+      self->state = pros::E_TASK_STATE_RUNNING;
+      running = self;
+    }
+  }
+  return self;
+}
+
+Tcb *resolve(pros::task_t task, Lock &lock) {
+  return task ? static_cast<Tcb *>(task) : current(lock);
+}
+
+// marks a task deleted and releases everything joined on it
+void finish(Tcb *task) {
+  leaveMutexQueue(task);
+  task->state = pros::E_TASK_STATE_DELETED;
+  for (Tcb *other : tasks) {
+    if (other->state == pros::E_TASK_STATE_BLOCKED && other->joining == task) {
+      other->joining = nullptr;
+      makeReady(other);
+    }
+  }
+}
+
+// parks a deleted task's thread for good. Like the kernel, deleting a task
+// does not unwind its stack
+[[noreturn]] void park(Lock &lock) {
+  for (;;) self->turn.wait(lock);
+}
+}  // namespace
+
+void sim::preemptionPoint(std::uint64_t cost) {
+  Lock lock(kernel);
+  current(lock);
+  now += cost;
+  bool ticked = now / kTick != lastTick;
+  if (ticked) {
+    lastTick = now / kTick;
+    pace();
+    wakeExpired();
+  }
+  Tcb *next = pick();
+  if (next && (next->priority > self->priority ||
+               (ticked && next->priority == self->priority))) {
+    yield(lock);
+  }
+}
+
+void sim::setRealtime(bool enabled) {
+  Lock lock(kernel);
+  realtime = enabled;
+  wallStart = std::chrono::steady_clock::now() - std::chrono::microseconds(now);
+}
+
+namespace pros::c {
+uint32_t millis(void) { return micros() / 1000; }
+
+uint64_t micros(void) {
+  sim::preemptionPoint(kClockReadCost);
+  Lock lock(kernel);
+  return now;
+}
+
+task_t task_create(task_fn_t function, void *const parameters, uint32_t prio,
+                   const uint16_t stack_depth, const char *const name) {
+  Lock lock(kernel);
+  current(lock);
+  Tcb *task = new Tcb{name ? name : ""};
+  task->priority = prio;
+  makeReady(task);
+  tasks.push_back(task);
+  std::thread([task, function, parameters] {
+    self = task;
+    {
+      Lock lock(kernel);
+      task->turn.wait(lock, [task] { return running == task; });
+    }
+    function(parameters);
+    Lock lock(kernel);
+    finish(task);
+    switchAway();
+  }).detach();
+  yieldIfOutranked(lock);
+  return task;
+}
+
+void task_delete(task_t task) {
+  Lock lock(kernel);
+  Tcb *target = resolve(task, lock);
+  if (target->state == E_TASK_STATE_DELETED) return;
+  finish(target);
+  if (target == self) {
+    switchAway();
+    park(lock);
+  }
+  yieldIfOutranked(lock);
+}
+
+void task_delay(const uint32_t milliseconds) { delay(milliseconds); }
+
+void delay(const uint32_t milliseconds) {
+  Lock lock(kernel);
+  Tcb *task = current(lock);
+  if (!milliseconds) return yield(lock);
+  block(task, after(milliseconds));
+  reschedule(lock);
+}
+
+void task_delay_until(uint32_t *const prev_time, const uint32_t delta) {
+  Lock lock(kernel);
+  Tcb *task = current(lock);
+  *prev_time += delta;
+  std::uint64_t wakeAt = std::uint64_t(*prev_time) * kTick;
+  // a wakeup that has already passed returns straight away
+  if (wakeAt <= now) return yield(lock);
+  block(task, wakeAt);
+  reschedule(lock);
+}
+
+uint32_t task_get_priority(task_t task) {
+  Lock lock(kernel);
+  return resolve(task, lock)->priority;
+}
+
+void task_set_priority(task_t task, uint32_t prio) {
+  Lock lock(kernel);
+  resolve(task, lock)->priority = prio;
+  yieldIfOutranked(lock);
+}
+
+task_state_e_t task_get_state(task_t task) {
+  Lock lock(kernel);
+  return resolve(task, lock)->state;
+}
+
+void task_suspend(task_t task) {
+  Lock lock(kernel);
+  Tcb *target = resolve(task, lock);
+  if (target->state == E_TASK_STATE_DELETED) return;
+  leaveMutexQueue(target);
+  target->state = E_TASK_STATE_SUSPENDED;
+  if (target == self) reschedule(lock);
+}
+
+void task_resume(task_t task) {
+  Lock lock(kernel);
+  Tcb *target = resolve(task, lock);
+  if (target->state != E_TASK_STATE_SUSPENDED) return;
+  makeReady(target);
+  yieldIfOutranked(lock);
+}
+
+uint32_t task_get_count(void) {
+  Lock lock(kernel);
+  uint32_t count = 0;
+  for (Tcb *task : tasks) count += task->state != E_TASK_STATE_DELETED;
+  return count;
+}
+
+char *task_get_name(task_t task) {
+  Lock lock(kernel);
+  return resolve(task, lock)->name.data();
+}
+
+task_t task_get_by_name(const char *name) {
+  Lock lock(kernel);
+  for (Tcb *task : tasks) {
+    if (task->state != E_TASK_STATE_DELETED && task->name == name) return task;
+  }
+  return nullptr;
+}
+
+task_t task_get_current() {
+  Lock lock(kernel);
+  return current(lock);
+}
+
+uint32_t task_notify(task_t task) {
+  return task_notify_ext(task, 0, E_NOTIFY_ACTION_INCR, nullptr);
+}
+
+void task_join(task_t task) {
+  Lock lock(kernel);
+  Tcb *caller = current(lock);
+  Tcb *target = resolve(task, lock);
+  if (target->state == E_TASK_STATE_DELETED) return;
+  caller->joining = target;
+  block(caller, kForever);
+  reschedule(lock);
+}
+
+uint32_t task_notify_ext(task_t task, uint32_t value, notify_action_e_t action,
+                         uint32_t *prev_value) {
+  Lock lock(kernel);
+  current(lock);
+  Tcb *target = resolve(task, lock);
+  if (prev_value) *prev_value = target->notifyValue;
+  switch (action) {
+    case E_NOTIFY_ACTION_NONE:
+      break;
+    case E_NOTIFY_ACTION_BITS:
+      target->notifyValue |= value;
+      break;
+    case E_NOTIFY_ACTION_INCR:
+      target->notifyValue++;
+      break;
+    case E_NOTIFY_ACTION_OWRITE:
+      target->notifyValue = value;
+      break;
+    case E_NOTIFY_ACTION_NO_OWRITE:
+      if (target->notified) return 0;
+      target->notifyValue = value;
+      break;
+  }
+  target->notified = true;
+  if (target->state == E_TASK_STATE_BLOCKED && target->waitingNotify &&
+      target->notifyValue > 0) {
+    makeReady(target);
+    yieldIfOutranked(lock);
+  }
+  return 1;
+}
+
+uint32_t task_notify_take(bool clear_on_exit, uint32_t timeout) {
+  Lock lock(kernel);
+  Tcb *task = current(lock);
+  if (task->notifyValue == 0 && timeout > 0) {
+    task->waitingNotify = true;
+    block(task, after(timeout));
+    reschedule(lock);
+    task->waitingNotify = false;
+  }
+  uint32_t value = task->notifyValue;
+  if (value > 0) task->notifyValue = clear_on_exit ? 0 : value - 1;
+  task->notified = false;
+  return value;
+}
+
+bool task_notify_clear(task_t task) {
+  Lock lock(kernel);
+  Tcb *target = resolve(task, lock);
+  bool pending = target->notified;
+  target->notified = false;
+  return pending;
+}
+
+mutex_t mutex_create(void) { return new HostMutex(); }
+
+bool mutex_take(mutex_t mutex, uint32_t timeout) {
+  Lock lock(kernel);
+  Tcb *task = current(lock);
+  HostMutex *m = static_cast<HostMutex *>(mutex);
+  if (!m->owner) {
+    m->owner = task;
+    return true;
+  }
+  if (timeout == 0) return false;
+  m->waiters.push_back(task);
+  task->waitingMutex = m;
+  block(task, after(timeout));
+  reschedule(lock);
+  task->waitingMutex = nullptr;
+  return m->owner == task;
+}
+
+// hands the mutex straight to its highest priority waiter
+bool mutex_give(mutex_t mutex) {
+  Lock lock(kernel);
+  Tcb *task = current(lock);
+  HostMutex *m = static_cast<HostMutex *>(mutex);
+  if (m->owner != task) return false;
+  m->owner = nullptr;
+  auto next = std::max_element(m->waiters.begin(), m->waiters.end(),
+                               [](const Tcb *a, const Tcb *b) {
+                                 return a->priority < b->priority;
+                               });
+  if (next != m->waiters.end()) {
+    Tcb *waiter = *next;
+    m->waiters.erase(next);
+    m->owner = waiter;
+    makeReady(waiter);
+    yieldIfOutranked(lock);
+  }
+  return true;
+}
+
+void mutex_delete(mutex_t mutex) {
+  Lock lock(kernel);
+  delete static_cast<HostMutex *>(mutex);
+}
+}  // namespace pros::c
+
+namespace pros::rtos {
+Task::Task(task_fn_t function, void *parameters, std::uint32_t prio,
+           std::uint16_t stack_depth, const char *name)
+    : task(c::task_create(function, parameters, prio, stack_depth, name)) {}
+
+Task::Task(task_fn_t function, void *parameters, const char *name)
+    : Task(function, parameters, TASK_PRIORITY_DEFAULT,
+           TASK_STACK_DEPTH_DEFAULT, name) {}
+
+Task::Task(task_t task) : task(task) {}
+
+Task Task::current() { return Task(c::task_get_current()); }
+
+Task &Task::operator=(task_t in) {
+  task = in;
+  return *this;
+}
+
+void Task::remove() { c::task_delete(task); }
+
+std::uint32_t Task::get_priority() { return c::task_get_priority(task); }
+
+void Task::set_priority(std::uint32_t prio) { c::task_set_priority(task, prio); }
+
+std::uint32_t Task::get_state() { return c::task_get_state(task); }
+
+void Task::suspend() { c::task_suspend(task); }
+
+void Task::resume() { c::task_resume(task); }
+
+const char *Task::get_name() { return c::task_get_name(task); }
+
+std::uint32_t Task::notify() { return c::task_notify(task); }
+
+void Task::join() { c::task_join(task); }
+
+std::uint32_t Task::notify_ext(std::uint32_t value, notify_action_e_t action,
+                               std::uint32_t *prev_value) {
+  return c::task_notify_ext(task, value, action, prev_value);
+}
+
+std::uint32_t Task::notify_take(bool clear_on_exit, std::uint32_t timeout) {
+  return c::task_notify_take(clear_on_exit, timeout);
+}
+
+bool Task::notify_clear() { return c::task_notify_clear(task); }
+
+void Task::delay(const std::uint32_t milliseconds) { c::delay(milliseconds); }
+
+void Task::delay_until(std::uint32_t *const prev_time,
+                       const std::uint32_t delta) {
+  c::task_delay_until(prev_time, delta);
+}
+
+std::uint32_t Task::get_count() { return c::task_get_count(); }
+
+Clock::time_point Clock::now() { return time_point(duration(c::millis())); }
+
+Mutex::Mutex() : mutex(c::mutex_create(), c::mutex_delete) {}
+
+bool Mutex::take() { return c::mutex_take(mutex.get(), TIMEOUT_MAX); }
+
+bool Mutex::take(std::uint32_t timeout) {
+  return c::mutex_take(mutex.get(), timeout);
+}
+
+bool Mutex::give() { return c::mutex_give(mutex.get()); }
+
+void Mutex::lock() { take(); }
+
+void Mutex::unlock() { give(); }
+
+bool Mutex::try_lock() { return take(0); }
+}  // namespace pros::rtos
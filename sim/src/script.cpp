@@ -0,0 +1,81 @@
+#include "sim/script.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "sim/world.h"
+
+namespace {
+const std::pair<const char *, pros::controller_analog_e_t> kAnalog[] = {
+    {"LEFT_X", pros::E_CONTROLLER_ANALOG_LEFT_X},
+    {"LEFT_Y", pros::E_CONTROLLER_ANALOG_LEFT_Y},
+    {"RIGHT_X", pros::E_CONTROLLER_ANALOG_RIGHT_X},
+    {"RIGHT_Y", pros::E_CONTROLLER_ANALOG_RIGHT_Y},
+};
+
+const std::pair<const char *, pros::controller_digital_e_t> kDigital[] = {
+    {"L1", pros::E_CONTROLLER_DIGITAL_L1},
+    {"L2", pros::E_CONTROLLER_DIGITAL_L2},
+    {"R1", pros::E_CONTROLLER_DIGITAL_R1},
+    {"R2", pros::E_CONTROLLER_DIGITAL_R2},
+    {"UP", pros::E_CONTROLLER_DIGITAL_UP},
+    {"DOWN", pros::E_CONTROLLER_DIGITAL_DOWN},
+    {"LEFT", pros::E_CONTROLLER_DIGITAL_LEFT},
+    {"RIGHT", pros::E_CONTROLLER_DIGITAL_RIGHT},
+    {"X", pros::E_CONTROLLER_DIGITAL_X},
+    {"B", pros::E_CONTROLLER_DIGITAL_B},
+    {"Y", pros::E_CONTROLLER_DIGITAL_Y},
+    {"A", pros::E_CONTROLLER_DIGITAL_A},
+};
+}  // namespace
+
+std::vector<sim::InputEvent> sim::loadScript(const std::string &path) {
+  std::ifstream file(path);
+  if (!file) throw std::runtime_error("cannot open input script " + path);
+
+  std::vector<InputEvent> events;
+  std::string line;
+  int number = 0;
+  while (std::getline(file, line)) {
+    number++;
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream fields(line);
+    std::uint32_t time;
+    std::string name;
+    int value;
+    if (!(fields >> time >> name >> value)) {
+      throw std::runtime_error(path + ":" + std::to_string(number) +
+                               ": expected <ms> <control> <value>");
+    }
+    InputEvent event{time, false, -1, value};
+    for (auto [key, channel] : kAnalog) {
+      if (name == key) event = {time, true, channel, std::clamp(value, -127, 127)};
+    }
+    for (auto [key, button] : kDigital) {
+      if (name == key) event = {time, false, button, value != 0};
+    }
+    if (event.control < 0) {
+      throw std::runtime_error(path + ":" + std::to_string(number) +
+                               ": unknown control " + name);
+    }
+    events.push_back(event);
+  }
+  std::stable_sort(events.begin(), events.end(),
+                   [](const InputEvent &a, const InputEvent &b) {
+                     return a.time < b.time;
+                   });
+  return events;
+}
+
+void sim::applyInput(const InputEvent &event) {
+  world().sync();
+  ControllerState &controller = world().controller(pros::E_CONTROLLER_MASTER);
+  if (event.analog) {
+    controller.analog[event.control] = event.value;
+  } else {
+    controller.digital[event.control] = event.value;
+  }
+}
@@ -0,0 +1,339 @@
+#include "sim/world.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "pros/rtos.h"
+#include "sim/rtos.h"
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kInch = 0.0254;
+constexpr double kGravity = 9.80665;
+
+// internal velocity loop of the motor firmware, in mV per rpm of error
+// relative to the feedforward scale
+constexpr double kVelocityGain = 2.0;
+// position loop of the motor firmware, rpm of command per degree of error
+constexpr double kPositionGain = 1.0;
+
+// battery: open circuit voltage across the charge, and internal resistance
+constexpr double kBatteryEmpty = 11400;   // mV
+constexpr double kBatteryFull = 12800;    // mV
+constexpr double kBatteryResistance = 0.1; // ohm
+constexpr double kBatteryCapacity = 1100;  // mAh
+constexpr double kBrainCurrent = 300;      // mA
+// headroom the motor H-bridge needs below the battery voltage
+constexpr double kDriverDrop = 400; // mV
+
+// rpm to degrees per second
+constexpr double kRpmToDps = 6;
+}  // namespace
+
+sim::World &sim::world() {
+  static World instance;
+  return instance;
+}
+
+int sim::adiIndex(int port) {
+  if (port >= 'a' && port <= 'h') return port - 'a' + 1;
+  if (port >= 'A' && port <= 'H') return port - 'A' + 1;
+  if (port >= 1 && port <= kNumAdiPorts) return port;
+  return 0;
+}
+
+sim::World::World() {
+  if (valid(robot.imuPort)) types[robot.imuPort] = pros::DeviceType::imu;
+  for (const TrackingWheelSpec &wheel : robot.trackingWheels) {
+    if (wheel.axis != WheelAxis::none && valid(wheel.port)) {
+      types[wheel.port] = pros::DeviceType::rotation;
+    }
+  }
+}
+
+void sim::World::sync() {
+  preemptionPoint(kDeviceCallCost);
+  std::uint64_t target = pros::c::micros();
+  while (time + kStep <= target) step();
+}
+
+sim::MotorPort &sim::World::motor(int port) {
+  types[port] = pros::DeviceType::motor;
+  return motors[port];
+}
+
+sim::ImuPort &sim::World::imu(int port) {
+  types[port] = pros::DeviceType::imu;
+  return imus[port];
+}
+
+sim::RotationPort &sim::World::rotation(int port) {
+  types[port] = pros::DeviceType::rotation;
+  return rotations[port];
+}
+
+sim::GpsPort &sim::World::gps(int port) {
+  types[port] = pros::DeviceType::gps;
+  return gpsPorts[port];
+}
+
+sim::AdiPort &sim::World::adi(int port) { return adiPorts[adiIndex(port)]; }
+
+sim::ControllerState &sim::World::controller(int id) {
+  return controllers[id == pros::E_CONTROLLER_PARTNER ? 1 : 0];
+}
+
+pros::DeviceType sim::World::type(int port) const {
+  return valid(port) ? types[port] : pros::DeviceType::none;
+}
+
+void sim::World::attachDrivetrain(const std::vector<std::int8_t> &left,
+                                  const std::vector<std::int8_t> &right,
+                                  DrivetrainGeometry geometry) {
+  leftPorts = left;
+  rightPorts = right;
+  drivetrain = std::make_unique<DrivetrainModel>(robot.body, geometry);
+}
+
+sim::BodyState sim::World::truth() {
+  sync();
+  BodyState body = drivetrain ? drivetrain->state() : BodyState();
+  body.x /= kInch;
+  body.y /= kInch;
+  body.v /= kInch;
+  body.accel /= kInch;
+  body.lateral /= kInch;
+  body.theta *= 180 / kPi;
+  body.omega *= 180 / kPi;
+  return body;
+}
+
+// Voltage the motor firmware applies this step, or NaN when the motor is left
+// to coast
+double sim::World::commandedVoltage(MotorPort &motor) {
+  MotorModel model = motorModel(motor.gearset);
+  auto velocityLoop = [&](double rpm) {
+    double scale = 12000 / model.freeSpeed;
+    return scale * (rpm + kVelocityGain * (rpm - motor.state.velocity));
+  };
+  auto positionLoop = [&](double angle, double maxRpm) {
+    double rpm = kPositionGain * (angle - motor.state.angle);
+    return velocityLoop(std::clamp(rpm, -maxRpm, maxRpm));
+  };
+
+  const MotorPort::Command &command = motor.applied;
+  switch (command.mode) {
+    case MotorPort::Mode::voltage:
+      return command.target;
+    case MotorPort::Mode::velocity:
+      return velocityLoop(command.target);
+    case MotorPort::Mode::position:
+      return positionLoop(command.target, command.profileVelocity);
+    case MotorPort::Mode::brake:
+      break;
+  }
+  switch (motor.brakeMode) {
+    case pros::MotorBrake::brake:
+      return 0;
+    case pros::MotorBrake::hold:
+      return positionLoop(command.target, model.freeSpeed);
+    default:
+      return NAN;
+  }
+}
+
+// Applies the motor's command against its current speed and returns the
+// output torque. Current and temperature follow from the torque
+void sim::World::stepMotor(MotorPort &motor, double dt) {
+  MotorModel model = motorModel(motor.gearset);
+  MotorReport &state = motor.state;
+  double voltage = commandedVoltage(motor);
+  if (std::isnan(voltage)) {
+    state.voltage = 0;
+    state.torque = 0;
+    state.current = 0;
+  } else {
+    double limit = std::min(12000.0, batteryState.voltage - kDriverDrop);
+    if (motor.voltageLimit > 0) limit = std::min<double>(limit, motor.voltageLimit);
+    state.voltage = std::clamp(voltage, -limit, limit);
+    state.torque = motorTorque(model, state.voltage, state.velocity);
+    state.current = state.torque / model.stallTorque * model.stallCurrent;
+    double currentLimit =
+        std::min<double>(motor.currentLimit, model.stallCurrent);
+    if (std::abs(state.current) > currentLimit) {
+      state.torque *= currentLimit / std::abs(state.current);
+      state.current = std::copysign(currentLimit, state.current);
+    }
+  }
+  // first order thermal model: heats with I^2, cools towards ambient
+  double amps = state.current / 1000;
+  state.temperature +=
+      (0.6 * amps * amps - 0.01 * (state.temperature - 25)) * dt;
+}
+
+void sim::World::step() {
+  time += kStep;
+  double dt = kStep / 1e6;
+  bool coupled[kNumPorts + 1] = {};
+
+  if (now() % kCommandPeriod == 0) {
+    for (MotorPort &m : motors) m.applied = {m.mode, m.target, m.profileVelocity};
+  }
+
+  if (drivetrain) {
+    auto sideForce = [&](const std::vector<std::int8_t> &ports,
+                         double sideSpeed) {
+      double force = 0;
+      for (std::int8_t port : ports) {
+        // a port without a motor in it contributes nothing
+        if (types[std::abs(port)] != pros::DeviceType::motor) continue;
+        int dir = port < 0 ? -1 : 1;
+        MotorPort &m = motors[std::abs(port)];
+        coupled[std::abs(port)] = true;
+        m.state.velocity = dir * drivetrain->motorRpm(sideSpeed);
+        stepMotor(m, dt);
+        force += dir * drivetrain->wheelForce(m.state.torque);
+      }
+      return force;
+    };
+    double left = sideForce(leftPorts, drivetrain->leftSpeed());
+    double right = sideForce(rightPorts, drivetrain->rightSpeed());
+    drivetrain->step(left, right, dt);
+
+    auto moveShafts = [&](const std::vector<std::int8_t> &ports,
+                          double sideSpeed) {
+      for (std::int8_t port : ports) {
+        MotorPort &m = motors[std::abs(port)];
+        m.state.velocity =
+            (port < 0 ? -1 : 1) * drivetrain->motorRpm(sideSpeed);
+        m.state.angle += m.state.velocity * kRpmToDps * dt;
+      }
+    };
+    moveShafts(leftPorts, drivetrain->leftSpeed());
+    moveShafts(rightPorts, drivetrain->rightSpeed());
+  }
+
+  // everything else spins a lumped inertia with some viscous drag
+  for (int port = 1; port <= kNumPorts; port++) {
+    if (types[port] != pros::DeviceType::motor || coupled[port]) continue;
+    MotorPort &m = motors[port];
+    stepMotor(m, dt);
+    double omega = m.state.velocity * 2 * kPi / 60;
+    double alpha = (m.state.torque - 0.002 * omega) / robot.mechanismInertia;
+    omega += alpha * dt;
+    m.state.velocity = omega * 60 / (2 * kPi);
+    m.state.angle += m.state.velocity * kRpmToDps * dt;
+  }
+
+  updateSensors(dt);
+  report();
+}
+
+void sim::World::updateSensors(double dt) {
+  std::uint32_t ms = now();
+  BodyState body = drivetrain ? drivetrain->state() : BodyState();
+
+  // battery sags with the current drawn by every motor
+  double current = kBrainCurrent;
+  for (int port = 1; port <= kNumPorts; port++) {
+    if (types[port] == pros::DeviceType::motor) {
+      current += std::abs(motors[port].state.current);
+    }
+  }
+  batteryState.current = current;
+  batteryState.capacity = std::max(
+      0.0, batteryState.capacity - current * dt / 3600 / kBatteryCapacity * 100);
+  double openCircuit =
+      kBatteryEmpty +
+      (kBatteryFull - kBatteryEmpty) * batteryState.capacity / 100;
+  batteryState.voltage = openCircuit - kBatteryResistance * current;
+
+  if (valid(robot.imuPort)) {
+    ImuPort &imu = imus[robot.imuPort];
+    if (imu.calibrating && ms >= imu.calibrationDone) imu.calibrating = false;
+  }
+  // the gyro integrates its own errors into the rotation it reports
+  for (int port = 1; port <= kNumPorts; port++) {
+    if (types[port] != pros::DeviceType::imu) continue;
+    double rate = body.omega * 180 / kPi * (1 + robot.errors.gyroScale) +
+                  robot.errors.gyroBias;
+    imus[port].rotation += rate * dt;
+  }
+
+  for (const TrackingWheelSpec &wheel : robot.trackingWheels) {
+    if (wheel.axis == WheelAxis::none) continue;
+    // same model LemLib odometry inverts: a wheel sees the robot's motion
+    // along its axis minus the arc swept by its offset
+    double speed = wheel.axis == WheelAxis::vertical ? body.v / kInch : 0;
+    double travel = (speed - wheel.offset * body.omega) * dt;
+    double turns = travel / (kPi * wheel.diameter) * wheel.gearRatio;
+    if (valid(wheel.port)) {
+      RotationPort &rotation = rotations[wheel.port];
+      rotation.angle += turns * 36000;
+      rotation.velocity = turns * 36000 / dt;
+    } else if (adiIndex(wheel.adiTop)) {
+      adiPorts[adiIndex(wheel.adiTop)].encoder += turns * 360;
+    }
+  }
+}
+
+void sim::World::report() {
+  std::uint32_t ms = now();
+  auto due = [ms](auto &sampled) { return ms - sampled.time >= sampled.period; };
+  BodyState body = drivetrain ? drivetrain->state() : BodyState();
+  auto gaussian = [this](double deviation) {
+    return std::normal_distribution<double>(0, deviation)(noise);
+  };
+
+  for (int port = 1; port <= kNumPorts; port++) {
+    switch (types[port]) {
+      case pros::DeviceType::motor:
+        if (due(motors[port].report)) {
+          motors[port].report.value = motors[port].state;
+          motors[port].report.time = ms;
+        }
+        break;
+      case pros::DeviceType::imu:
+        if (due(imus[port].report)) {
+          ImuReport &value = imus[port].report.value;
+          value.rotation = imus[port].rotation;
+          value.gyro = body.omega * 180 / kPi * (1 + robot.errors.gyroScale) +
+                       robot.errors.gyroBias +
+                       gaussian(robot.errors.gyroNoise);
+          value.accelX =
+              body.lateral / kGravity + gaussian(robot.errors.accelNoise);
+          value.accelY =
+              body.accel / kGravity + gaussian(robot.errors.accelNoise);
+          imus[port].report.time = ms;
+        }
+        break;
+      case pros::DeviceType::gps:
+        if (due(gpsPorts[port].report)) {
+          // the field origin is wherever the robot started
+          GpsReport &value = gpsPorts[port].report.value;
+          value.x = body.x + gaussian(robot.errors.gpsNoise);
+          value.y = body.y + gaussian(robot.errors.gpsNoise);
+          double heading = body.theta * 180 / kPi +
+                           gaussian(robot.errors.gpsHeadingNoise);
+          value.heading = std::fmod(std::fmod(heading, 360) + 360, 360);
+          value.error = robot.errors.gpsNoise;
+          value.gyro = body.omega * 180 / kPi;
+          value.accelX = body.lateral / kGravity;
+          value.accelY = body.accel / kGravity;
+          gpsPorts[port].report.time = ms;
+        }
+        break;
+      case pros::DeviceType::rotation:
+        if (due(rotations[port].report)) {
+          rotations[port].report.value = rotations[port].angle;
+          rotations[port].report.time = ms;
+          rotations[port].velocityReport.value = rotations[port].velocity;
+          rotations[port].velocityReport.time = ms;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+}
@@ -0,0 +1,86 @@
+#include "input/dispatcher.h"
+
+#include <algorithm>
+
+input::Dispatcher::Dispatcher(pros::Controller &controller,
+                              std::uint32_t period)
+    : controller(controller), period(period) {}
+
+void input::Dispatcher::subscribe(pros::controller_digital_e_t button,
+                                  EventType type,
+                                  Handler handler) {
+  subscriptions.push_back({button, type, std::move(handler)});
+  if (std::find(watched.begin(), watched.end(), button) == watched.end()) {
+    watched.push_back(button);
+  }
+}
+
+void input::Dispatcher::dispatch(const Event &event) {
+  for (const Subscription &subscription : subscriptions) {
+    if (subscription.button == event.button &&
+        subscription.type == event.type) {
+      subscription.handler(event);
+    }
+  }
+}
+
+void input::Dispatcher::poll() {
+  std::uint32_t now = pros::millis();
+  for (pros::controller_digital_e_t button : watched) {
+    ButtonState &state = buttons[button];
+    // one read per button, with the edges taken against the last sample
+    bool down = controller.get_digital(button);
+
+    if (state.down && !down) {
+      state.down = false;
+      dispatch({button, EventType::release, now, now - state.pressedAt});
+    }
+    if (down && !state.down) {
+      state.down = true;
+      state.pressedAt = now;
+      dispatch({button, EventType::press, now, 0});
+    } else if (down) {
+      dispatch({button, EventType::hold, now, now - state.pressedAt});
+    }
+  }
+}
+
+void input::Dispatcher::start() {
+  if (running) return;
+  running = true;
+  if (task != nullptr) {
+    // started again from a handler, on the polling task itself, which has
+    // not got round to seeing it was stopped
+    if (static_cast<pros::task_t>(*task) == pros::c::task_get_current()) {
+      return;
+    }
+    // stopped from a handler, so nothing has waited for the task yet
+    task->join();
+    delete task;
+  }
+  // buttons changed while stopped are seen afresh, so one still down from
+  // before is pressed again
+  for (ButtonState &state : buttons) state = {};
+  task = new pros::Task([this]() {
+    std::uint32_t wake = pros::millis();
+    while (running) {
+      poll();
+      // sample on a fixed period, however long the handlers took
+      pros::Task::delay_until(&wake, period);
+    }
+  });
+}
+
+void input::Dispatcher::stop() {
+  running = false;
+  // A handler cannot wait on the task it runs on, so then start() waits for
+  // it instead. Otherwise the task has finished its last poll once this
+  // returns, and a start() straight after cannot leave two polling
+  if (task == nullptr ||
+      static_cast<pros::task_t>(*task) == pros::c::task_get_current()) {
+    return;
+  }
+  task->join();
+  delete task;
+  task = nullptr;
+}
@@ -4,6 +4,8 @@
 
 // controller
 pros::Controller controller(pros::E_CONTROLLER_MASTER);
+// button events for driver control
+input::Dispatcher buttons(controller);
 
 // motor groups
 pros::MotorGroup
@@ -75,24 +77,43 @@ lemlib::OdomSensors sensors(nullptr, // vertical tracking wheel
                             &imu // inertial sensor
 );
 
-// input curve for throttle input during driver control
-lemlib::ExpoDriveCurve
-    throttleCurve(3,    // joystick deadband out of 127
-                  10,   // minimum output where drivetrain will move out of 127
-                  1.019 // expo curve gain
-    );
+// input curve for throttle input during driver control, LemLib's expo curve
+// baked into a table when compiled
+constinit input::TableCurve throttleCurve(input::Expo{
+    3,    // joystick deadband out of 127
+    10,   // minimum output where drivetrain will move out of 127
+    1.019 // expo curve gain
+});
 
 // input curve for steer input during driver control
-lemlib::ExpoDriveCurve
-    steerCurve(3,    // joystick deadband out of 127
-               10,   // minimum output where drivetrain will move out of 127
-               1.019 // expo curve gain
-    );
+constinit input::TableCurve steerCurve(input::Expo{
+    3,    // joystick deadband out of 127
+    10,   // minimum output where drivetrain will move out of 127
+    1.019 // expo curve gain
+});
 
 // create the chassis
-lemlib::Chassis chassis(drivetrain, linearController, angularController,
+motion::Chassis chassis(drivetrain, linearController, angularController,
                         sensors, &throttleCurve, &steerCurve);
 
+// every drivetrain sensor, read together once per odometry update
+odom::SensorReader sensorReader(drivetrain,
+                                &horizontalEnc, // horizontal tracking wheel
+                                lemlib::Omniwheel::NEW_2, // wheel diameter
+                                2.5,  // horizontal wheel offset
+                                &imu  // inertial sensor
+);
+
+// fuses the sensors into a pose. odom::Tracker is plain dead reckoning
+odom::Ekf estimator(sensorReader.getTrackWidth(),
+                    sensorReader.getHorizontalOffset());
+
+// runs odometry every 10 ms and keeps track of how well it holds that rate
+odom::Scheduler odometry(sensorReader, estimator, 10);
+
+// records autonomous runs to the SD card at the odometry rate
+telemetry::Recorder recorder;
+
 pros::Motor intake(5, pros::MotorGearset::green);
 
 pros::Motor stakeMotor(-7, pros::MotorGearset::red);
@@ -101,6 +122,39 @@ pros::adi::DigitalOut clamp('A');
 pros::adi::Encoder stakeEncoder('C', 'D', true);
 
 bool testing = true;
+// Autonomous tunes the lateral and angular PIDs instead of running the
+// routine, and logs the gains to paste into the controllers above. The same
+// tuning runs against the simulator with sim/bench/tune.cpp
+bool tuning = false;
+
+// sends one reading of each drive motor, left then right, to the recorder
+template <typename F> void recordDriveMotors(std::uint8_t channel, F read) {
+  recorder.send(channel, {float(read(leftMotors, 0)), float(read(leftMotors, 1)),
+                          float(read(leftMotors, 2)), float(read(rightMotors, 0)),
+                          float(read(rightMotors, 1)),
+                          float(read(rightMotors, 2))});
+}
+
+// one flight recorder sample of the drivetrain. Temperatures change slowly, so
+// they are only recorded every tenth sample
+void recordDrive(std::uint32_t sample) {
+  lemlib::Pose pose = odometry.getPose().pose;
+  recorder.send(telemetry::kPoseChannel, {pose.x, pose.y, pose.theta});
+  recordDriveMotors(telemetry::kVelocityChannel,
+                    [](pros::MotorGroup &group, std::uint8_t motor) {
+                      return group.get_actual_velocity(motor);
+                    });
+  recordDriveMotors(telemetry::kMotorChannel,
+                    [](pros::MotorGroup &group, std::uint8_t motor) {
+                      return group.get_current_draw(motor);
+                    });
+  if (sample % 10 == 0) {
+    recordDriveMotors(telemetry::kTemperatureChannel,
+                      [](pros::MotorGroup &group, std::uint8_t motor) {
+                        return group.get_temperature(motor);
+                      });
+  }
+}
 
 /**
  * Runs initialization code. This occurs as soon as the program is started.
@@ -110,7 +164,13 @@ bool testing = true;
  */
 void initialize() {
   pros::lcd::initialize(); // initialize brain screen
-  chassis.calibrate();     // calibrate sensors
+  odometry.calibrate();    // calibrate sensors
+  // the trackers need the robot's speed, which only the scheduler measures
+  chassis.setOdometry(odometry);
+  // drive by voltage, up to all the battery gives as it sags
+  chassis.setMixer({});
+  // write telemetry out from a task of its own, so logging never blocks
+  telemetry::telemetryLog().start();
 
   // the default rate is 50. however, if you need to change the rate, you
   // can do the following.
@@ -121,20 +181,38 @@ void initialize() {
   // for more information on how the formatting for the loggers
   // works, refer to the fmtlib docs
 
-  // thread to for brain screen and position logging
-  pros::Task screenTask([&]() {
+  // thread to for brain screen and position logging. Static, so calling
+  // initialize() again from a test run doesn't start a second sender on the
+  // telemetry channels
+  static pros::Task screenTask([]() {
+    std::uint32_t lastTimingLog = pros::millis();
     while (true) {
+      // read the pose and sensors once, so everything below agrees. Neither
+      // read waits on the odometry task
+      lemlib::Pose pose = odometry.getPose().pose;
+      odom::SensorFrame frame = odometry.frame();
       // print robot location to the brain screen
-      pros::lcd::print(0, "X: %f", chassis.getPose().x);         // x
-      pros::lcd::print(1, "Y: %f", chassis.getPose().y);         // y
-      pros::lcd::print(2, "Theta: %f", chassis.getPose().theta); // heading
-      // log position telemetry
-      lemlib::telemetrySink()->info("Chassis pose: {}", chassis.getPose());
-
-      std::cout << "X: " << chassis.getPose().x << std::endl;         // x
-      std::cout << "Y: " << chassis.getPose().y << std::endl;         // y
-      std::cout << "Theta: " << chassis.getPose().theta << std::endl; // heading
-      std::cout << "\n\n\n\n\n" << std::endl;
+      pros::lcd::print(0, "X: %f", pose.x);         // x
+      pros::lcd::print(1, "Y: %f", pose.y);         // y
+      pros::lcd::print(2, "Theta: %f", pose.theta); // heading
+      pros::lcd::print(3, "IMU: %f", frame.imuHeading);
+      // send position and drive current telemetry
+      telemetry::telemetryStream().send(telemetry::kPoseChannel,
+                                        {pose.x, pose.y, pose.theta});
+      telemetry::telemetryStream().send(
+          telemetry::kMotorChannel,
+          {float(leftMotors.get_current_draw(0)),
+           float(leftMotors.get_current_draw(1)),
+           float(leftMotors.get_current_draw(2)),
+           float(rightMotors.get_current_draw(0)),
+           float(rightMotors.get_current_draw(1)),
+           float(rightMotors.get_current_draw(2))});
+      // log odometry timing once a second
+      if (pros::millis() - lastTimingLog >= 1000) {
+        odometry.logTiming();
+        lastTimingLog = pros::millis();
+      }
+
       // delay to save resources
       pros::delay(50);
     }
@@ -144,7 +222,11 @@ void initialize() {
 /**
  * Runs while the robot is disabled
  */
-void disabled() {}
+void disabled() {
+  buttons.stop();
+  // the run is over; write out the rest of its recording
+  recorder.stop();
+}
 
 /**
  * runs after initialize if the robot is connected to field control
@@ -155,6 +237,11 @@ void competition_initialize() {}
 // this needs to be put outside a function
 ASSET(example_txt); // '.' replaced with "_" to make c++ happy
 ASSET(my_lemlib_tarball_file_txt);
+// the tarball's paths by name, indexed once here so autonomous only looks
+// them up, e.g. chassis.follow(paths["Path 1"], 15, 4000)
+path::Tarball paths(my_lemlib_tarball_file_txt);
+// the same path converted with `make paths`, so following it parses nothing
+ASSET(example_path);
 
 /**
  * Runs during auto
@@ -167,8 +254,24 @@ void autonomous() {
         initialize();
         pros::delay(1000);
     }
+  // record the run, if there is a card to record it on. The sampling task
+  // outlives the run and only samples while recording
+  recorder.start("auton");
+  static pros::Task recordTask([]() {
+    std::uint32_t wake = pros::millis();
+    for (std::uint32_t sample = 0;; sample++) {
+      if (recorder.isRecording()) recordDrive(sample);
+      pros::Task::delay_until(&wake, 10);
+    }
+  });
+  odometry.setPose({0, 0, 0});
+  if (tuning) {
+    tune::Autotuner tuner(chassis);
+    tuner.tune(tune::Loop::Angular, tune::kAngularTuning);
+    tuner.tune(tune::Loop::Lateral, tune::kLateralTuning);
+    return;
+  }
   // Move to x: 20 and y: 15, and face heading 90. Timeout set to 4000 ms
-  chassis.setPose(0, 0, 0);
   chassis.turnToHeading(90, 9999999);
   // chassis.moveToPose(20, 15, 90, 4000);
   // Move to x: 0 and y: 0 and face heading 270, going backwards. Timeout set to
@@ -188,7 +291,7 @@ void autonomous() {
 //   // Follow the path in path.txt. Lookahead at 15, Timeout set to 4000
 //   // following the path with the back of the robot (forwards = false)
 //   // see line 116 to see how to define a path
-//   chassis.follow(example_txt, 15, 4000, false);
+//   chassis.follow(path::BinaryPath(example_path), 15, 4000, false);
 //   // wait until the chassis has traveled 10 inches. Otherwise the code directly
 //   // after the movement will run immediately Unless its another movement, in
 //   // which case it will wait
@@ -211,84 +314,74 @@ bool stakeIsActive = false;
 int stakeLowerLimit = 22;
 int stakeUpperLimit = 100;
 
-void buttonControls(void *param) {
-    stakeMotor.set_brake_mode(pros::MotorBrake::hold);
-    stakeMotor.set_zero_position(0);
-  while (true) {
-    // clamp
-    if (controller.get_digital(DIGITAL_A) && isClamped) {
-      clamp.set_value(false);
-      isClamped = false;
-      while (controller.get_digital(DIGITAL_A)) {
-        pros::delay(50);
-      }
-    } else if (controller.get_digital(DIGITAL_A) && !isClamped) {
-      clamp.set_value(true);
-      isClamped = true;
-      while (controller.get_digital(DIGITAL_A)) {
-        pros::delay(50);
-      }
-    }
+// Each mechanism is a small state machine driven by button events, so nothing
+// here waits on a button
+void buttonControls() {
+  // opcontrol starts over each time driver control is re-enabled
+  static bool subscribed = false;
+  if (subscribed) {
+    buttons.start();
+    return;
+  }
+  subscribed = true;
 
-    // intake
-    if (controller.get_digital(DIGITAL_R2) && (!isIntaking || intakeReversed)) {
-      intake.move(127);
-      isIntaking = true;
-      intakeReversed = false;
-      while (controller.get_digital(DIGITAL_R2)) {
-        pros::delay(50);
-      }
-    } else if (controller.get_digital(DIGITAL_R2) && isIntaking &&
-               !intakeReversed) {
+  stakeMotor.set_brake_mode(pros::MotorBrake::hold);
+  stakeMotor.set_zero_position(0);
+
+  // clamp
+  buttons.subscribe(DIGITAL_A, input::EventType::press, [](const input::Event &) {
+    isClamped = !isClamped;
+    clamp.set_value(isClamped);
+  });
+
+  // intake. R2 runs it forwards and R1 in reverse; pressing the button for the
+  // direction it is already running stops it
+  auto setIntake = [](bool reversed) {
+    if (isIntaking && intakeReversed == reversed) {
       intake.brake();
       isIntaking = false;
       intakeReversed = false;
-      while (controller.get_digital(DIGITAL_R2)) {
-        pros::delay(50);
-      }
-    } else if (controller.get_digital(DIGITAL_R1) &&
-               (!isIntaking || !intakeReversed)) {
-      intake.move(-127);
+    } else {
+      intake.move(reversed ? -127 : 127);
       isIntaking = true;
-      intakeReversed = true;
-      while (controller.get_digital(DIGITAL_R1)) {
-        pros::delay(50);
-      }
-    } else if (controller.get_digital(DIGITAL_R1) && isIntaking &&
-               intakeReversed) {
-      intake.brake();
-      isIntaking = false;
-      intakeReversed = false;
-      while (controller.get_digital(DIGITAL_R1)) {
-        pros::delay(50);
-      }
+      intakeReversed = reversed;
     }
+  };
+  buttons.subscribe(DIGITAL_R2, input::EventType::press,
+                    [setIntake](const input::Event &) { setIntake(false); });
+  buttons.subscribe(DIGITAL_R1, input::EventType::press,
+                    [setIntake](const input::Event &) { setIntake(true); });
 
-    // wall stake arm
-    if (controller.get_digital(DIGITAL_B)) {
-      stakeIsActive = !stakeIsActive;
-      if (stakeIsActive) {
-        stakeMotor.move_absolute( 180, 100);
-      } else {
-        stakeMotor.move_absolute(0, 100);
-      }
-      while (controller.get_digital(DIGITAL_B)) {
-        pros::delay(50);
-      }
-    }
+  // wall stake arm
+  buttons.subscribe(DIGITAL_B, input::EventType::press, [](const input::Event &) {
+    stakeIsActive = !stakeIsActive;
     if (stakeIsActive) {
-      if (controller.get_digital(DIGITAL_L1)) {
-        stakeMotor.move(40);
-      } else if (controller.get_digital(DIGITAL_L2)) {
-        stakeMotor.move(-40);
-      } else {
-        stakeMotor.brake();
-      }
+      stakeMotor.move_absolute(180, 100);
+    } else {
+      stakeMotor.move_absolute(0, 100);
     }
-  }
+  });
+  // manual adjustment while the arm is up: L1 raises it and L2 lowers it for
+  // as long as they are held
+  auto driveStake = [](const input::Event &) {
+    if (!stakeIsActive) return;
+    if (controller.get_digital(DIGITAL_L1)) {
+      stakeMotor.move(40);
+    } else if (controller.get_digital(DIGITAL_L2)) {
+      stakeMotor.move(-40);
+    } else {
+      stakeMotor.brake();
+    }
+  };
+  buttons.subscribe(DIGITAL_L1, input::EventType::press, driveStake);
+  buttons.subscribe(DIGITAL_L1, input::EventType::release, driveStake);
+  buttons.subscribe(DIGITAL_L2, input::EventType::press, driveStake);
+  buttons.subscribe(DIGITAL_L2, input::EventType::release, driveStake);
+
+  buttons.start();
 }
 void opcontrol() {
-  pros::Task BUTTON_CONTROLLS(buttonControls);
+  buttonControls();
   
   leftMotors.set_brake_mode_all(pros::MotorBrake::brake);
   rightMotors.set_brake_mode_all(pros::MotorBrake::brake);
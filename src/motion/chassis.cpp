@@ -0,0 +1,879 @@
+#include "motion/chassis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+#include "pros/misc.hpp"
+
+namespace {
+// how long before reaching a target a move that hands on lets the next motion
+// take over, in s
+constexpr float kBlendTime = 0.2;
+
+// curvature of the arc from the robot to the lookahead point. `heading` is
+// counterclockwise from +x
+float lookaheadCurvature(const lemlib::Pose &pose, float heading,
+                         const lemlib::Pose &lookahead) {
+  float side = lemlib::sgn(std::sin(heading) * (lookahead.x - pose.x) -
+                           std::cos(heading) * (lookahead.y - pose.y));
+  float a = -std::tan(heading);
+  float c = std::tan(heading) * pose.x - pose.y;
+  float x = std::fabs(a * lookahead.x + lookahead.y + c) / std::sqrt(a * a + 1);
+  float d = std::hypot(lookahead.x - pose.x, lookahead.y - pose.y);
+  return side * (2 * x / (d * d));
+}
+
+// LemLib's moveToPose carrot point. `heading` is standard radians
+lemlib::Pose carrotPoint(const lemlib::Pose &pose, const lemlib::Pose &target,
+                         float heading, float lead) {
+  float d = pose.distance(target);
+  return {target.x - std::cos(heading) * lead * d,
+          target.y - std::sin(heading) * lead * d};
+}
+
+// length of the quadratic curve from a through b to c
+float curveLength(const lemlib::Pose &a, const lemlib::Pose &b,
+                  const lemlib::Pose &c) {
+  constexpr int kSteps = 16;
+  float length = 0;
+  lemlib::Pose last = a;
+  for (int i = 1; i <= kSteps; i++) {
+    float t = float(i) / kSteps;
+    float u = 1 - t;
+    lemlib::Pose point(u * u * a.x + 2 * u * t * b.x + t * t * c.x,
+                       u * u * a.y + 2 * u * t * b.y + t * t * c.y);
+    length += point.distance(last);
+    last = point;
+  }
+  return length;
+}
+
+// LemLib's small error exit condition, or the settle condition in place of it
+// if there is one. `speed` is per second, either way
+bool smallExit(std::optional<motion::SettleCondition> &settle,
+               lemlib::ExitCondition &small, float error, float speed) {
+  if (settle) return settle->update(error, speed);
+  return small.update(error);
+}
+
+// A point is approached in a straight line, and a pose along the curve from
+// the robot through the first carrot point. `heading` is standard radians
+float moveLength(const lemlib::Pose &start, const lemlib::Pose &target,
+                 std::optional<float> heading, float lead) {
+  if (!heading) return start.distance(target);
+  return curveLength(start, carrotPoint(start, target, *heading, lead),
+                     target);
+}
+}  // namespace
+
+motion::Chassis::Chassis(lemlib::Drivetrain drivetrain,
+                         lemlib::ControllerSettings linearSettings,
+                         lemlib::ControllerSettings angularSettings,
+                         lemlib::OdomSensors sensors,
+                         ProfileSettings profileSettings,
+                         lemlib::DriveCurve *throttleCurve,
+                         lemlib::DriveCurve *steerCurve)
+    : lemlib::Chassis(drivetrain, linearSettings, angularSettings, sensors,
+                      throttleCurve, steerCurve),
+      profileSettings(profileSettings) {}
+
+// The same controller as lemlib::Chassis::follow, only reading its points from
+// the binary path instead of a vector parsed from text, and searching them
+// through a path::PathIndex
+motion::Handle motion::Chassis::follow(path::BinaryPath path,
+                                      float lookahead, int timeout,
+                                      bool forwards, bool async) {
+  auto state = std::make_shared<MotionState>();
+  startMotion(state, async, [=, this]() {
+    if (path.empty()) return;
+    pursue(path, lookahead, timeout, forwards, 0);
+
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    // -1 marks the motion as finished
+    distTraveled = -1;
+  });
+  return Handle(state);
+}
+
+// `travelled` is how far the robot had come before the path, for waitUntil
+void motion::Chassis::pursue(path::BinaryPath path, float lookahead,
+                             int timeout, bool forwards, float travelled) {
+  lemlib::Pose lastPose = getPose();
+  path::PathIndex index(path);
+  const int compState = pros::competition::get_status();
+  distTraveled = travelled;
+
+  for (int i = 0; i < timeout / 10 &&
+                  pros::competition::get_status() == compState && running();
+       i++) {
+    lemlib::Pose pose = controlPose(true);
+    if (!forwards) pose.theta -= M_PI;
+    distTraveled += pose.distance(lastPose);
+    lastPose = pose;
+    report(distTraveled - travelled);
+
+    std::size_t closest = index.closest(pose);
+    // the path ends where its speed drops to 0
+    float targetVel = path[closest].speed;
+    if (targetVel == 0) break;
+
+    float curvature = lookaheadCurvature(pose, M_PI / 2 - pose.theta,
+                                         index.lookahead(pose, lookahead));
+
+    float targetLeftVel = targetVel * (2 + curvature * drivetrain.trackWidth) / 2;
+    float targetRightVel = targetVel * (2 - curvature * drivetrain.trackWidth) / 2;
+    if (forwards) {
+      drive(targetLeftVel, targetRightVel);
+    } else {
+      drive(-targetRightVel, -targetLeftVel);
+    }
+    pros::delay(10);
+  }
+}
+
+motion::Handle motion::Chassis::follow(const TimedPath &path, int timeout,
+                                      TimedFollowParams params, bool async) {
+  auto state = std::make_shared<MotionState>();
+  startMotion(state, async, [=, this, &path]() { followTimed(path, timeout, params); });
+  return Handle(state);
+}
+
+void motion::Chassis::followTimed(const TimedPath &path, int timeout,
+                                  TimedFollowParams params) {
+  if (path.empty()) return;
+
+  lateralPID.reset();
+  lateralLargeExit.reset();
+  lateralSmallExit.reset();
+  if (lateralSettle) lateralSettle->reset();
+  lemlib::Timer timer(timeout);
+  const int compState = pros::competition::get_status();
+  const std::uint32_t startTime = pros::millis();
+  const float halfTrack = drivetrain.trackWidth / 2;
+  lemlib::Pose lastPose = getPose();
+  // where the last step found things, so this one carries on from there
+  std::size_t closest = 0;
+  std::size_t sampled = 0;
+  std::size_t aimed = 0;
+  std::size_t referenced = 0;
+  distTraveled = 0;
+
+  while (!timer.isDone() && running() &&
+         pros::competition::get_status() == compState) {
+    lemlib::Pose pose = controlPose(true);
+    if (!params.forwards) pose.theta -= M_PI;
+    distTraveled += pose.distance(lastPose);
+    lastPose = pose;
+    report(distTraveled);
+
+    closest = path.closest(pose, closest);
+    const float progress = path.progress(pose, closest);
+    const float elapsed = (pros::millis() - startTime) / 1000.0f;
+    const ProfileState state = path.sample(elapsed, sampled);
+
+    const float remaining = path.getLength() - progress;
+    lateralLargeExit.update(remaining);
+    const bool settled = smallExit(lateralSettle, lateralSmallExit, remaining,
+                                   localSpeed().y);
+    if (elapsed >= path.getDuration() &&
+        (settled || lateralLargeExit.getExit())) {
+      break;
+    }
+
+    // the trackers' corrections fade out as the reference comes to rest, so
+    // pure pursuit's PID on the distance left settles the end
+    float leftPower;
+    float rightPower;
+    if (params.tracker == Tracker::PurePursuit ||
+        elapsed >= path.getDuration()) {
+      const lemlib::Pose aim =
+          path.pointAt(progress + params.lookahead, aimed);
+      const float curvature =
+          lookaheadCurvature(pose, M_PI / 2 - pose.theta, aim);
+      const float behind = state.position - progress;
+      float power =
+          profileSettings.feedforward.power(state.velocity,
+                                            state.acceleration) +
+          lateralPID.update(behind);
+      // past the end of the profile, still overcome friction, so the PID
+      // settles the last inch rather than stalling short of it
+      if (elapsed >= path.getDuration()) {
+        power += profileSettings.feedforward.kS * lemlib::sgn(behind);
+      }
+      leftPower = power * (2 + curvature * drivetrain.trackWidth) / 2;
+      rightPower = power * (2 - curvature * drivetrain.trackWidth) / 2;
+    } else {
+      // the path's curvature is positive turning clockwise
+      const Reference reference = {
+          path.pointAt(state.position, referenced), state.velocity,
+          -state.velocity * path[referenced].curvature};
+      const lemlib::Pose standard(pose.x, pose.y, M_PI / 2 - pose.theta);
+      const Command command = params.tracker == Tracker::Ramsete
+                                  ? ramsete.calculate(standard, reference)
+                                  : ltv.calculate(standard, reference);
+      // backwards, the robot is driving a mirror image of itself, whose
+      // forwards is the robot's backwards and which turns the same way
+      const lemlib::Pose speed = localSpeed();
+      const float velocity = params.forwards ? speed.y : -speed.y;
+      const float angularVelocity = -speed.theta;
+      const float left = command.velocity - command.angularVelocity * halfTrack;
+      const float right =
+          command.velocity + command.angularVelocity * halfTrack;
+      const Feedforward &feedforward = profileSettings.feedforward;
+      leftPower = feedforward.power(left, state.acceleration) +
+                  profileSettings.kVelocity *
+                      (left - (velocity - angularVelocity * halfTrack));
+      rightPower = feedforward.power(right, state.acceleration) +
+                   profileSettings.kVelocity *
+                       (right - (velocity + angularVelocity * halfTrack));
+    }
+
+    if (params.forwards) {
+      drive(leftPower, rightPower);
+    } else {
+      drive(-rightPower, -leftPower);
+    }
+    pros::delay(10);
+  }
+
+  drivetrain.leftMotors->move(0);
+  drivetrain.rightMotors->move(0);
+  // -1 marks the motion as finished
+  distTraveled = -1;
+}
+
+lemlib::Pose motion::Chassis::controlPose(bool radians, bool standardPos) {
+  if (!compensate || odometry == nullptr) return getPose(radians, standardPos);
+  lemlib::Pose pose = odometry->getCompensatedPose(true);
+  if (standardPos) pose.theta = M_PI_2 - pose.theta;
+  if (!radians) pose.theta = lemlib::radToDeg(pose.theta);
+  return pose;
+}
+
+lemlib::Pose motion::Chassis::localSpeed() const {
+  if (odometry != nullptr) return odometry->getPose(true).localVelocity;
+  return lemlib::getLocalSpeed(true);
+}
+
+void motion::Chassis::tank(int left, int right, bool disableDriveCurve) {
+  if (!mixer) return lemlib::Chassis::tank(left, right, disableDriveCurve);
+  float leftPower = left;
+  float rightPower = right;
+  if (!disableDriveCurve) {
+    leftPower = throttleCurve->curve(left);
+    rightPower = throttleCurve->curve(right);
+  }
+  const DriveMixer::Voltages voltages = mixer->driver(leftPower, rightPower);
+  drivetrain.leftMotors->move_voltage(voltages.left);
+  drivetrain.rightMotors->move_voltage(voltages.right);
+}
+
+void motion::Chassis::arcade(int throttle, int turn, bool disableDriveCurve,
+                             float desaturateBias) {
+  if (!mixer) {
+    return lemlib::Chassis::arcade(throttle, turn, disableDriveCurve,
+                                   desaturateBias);
+  }
+  float throttlePower = throttle;
+  float turnPower = turn;
+  if (!disableDriveCurve) {
+    throttlePower = throttleCurve->curve(throttle);
+    turnPower = steerCurve->curve(turn);
+  }
+  const DriveMixer::Voltages voltages =
+      mixer->arcade(throttlePower, turnPower, desaturateBias);
+  drivetrain.leftMotors->move_voltage(voltages.left);
+  drivetrain.rightMotors->move_voltage(voltages.right);
+}
+
+// LemLib's curvature drive: the turn sets the arc's curvature rather than how
+// fast the robot turns, except in place
+void motion::Chassis::curvature(int throttle, int turn,
+                                bool disableDriveCurve) {
+  if (!mixer) {
+    return lemlib::Chassis::curvature(throttle, turn, disableDriveCurve);
+  }
+  float throttlePower = throttle;
+  float turnPower = turn;
+  if (!disableDriveCurve) {
+    throttlePower = throttleCurve->curve(throttle);
+    turnPower = steerCurve->curve(turn);
+  }
+  if (int(throttlePower) != 0) {
+    turnPower *= std::fabs(throttlePower) / 127;
+  } else {
+    throttlePower = 0;
+  }
+  const DriveMixer::Voltages voltages =
+      mixer->driver(throttlePower + turnPower, throttlePower - turnPower);
+  drivetrain.leftMotors->move_voltage(voltages.left);
+  drivetrain.rightMotors->move_voltage(voltages.right);
+}
+
+// LemLib's PIDs and exit conditions keep their settings in const members, so
+// they are made again in place the way LemLib's constructor makes them
+void motion::Chassis::setLateralSettings(
+    const lemlib::ControllerSettings &settings) {
+  lateralSettings = settings;
+  std::destroy_at(&lateralPID);
+  std::construct_at(&lateralPID, settings.kP, settings.kI, settings.kD,
+                    settings.windupRange, true);
+  std::destroy_at(&lateralLargeExit);
+  std::construct_at(&lateralLargeExit, settings.largeError,
+                    int(settings.largeErrorTimeout));
+  std::destroy_at(&lateralSmallExit);
+  std::construct_at(&lateralSmallExit, settings.smallError,
+                    int(settings.smallErrorTimeout));
+}
+
+void motion::Chassis::setAngularSettings(
+    const lemlib::ControllerSettings &settings) {
+  angularSettings = settings;
+  std::destroy_at(&angularPID);
+  std::construct_at(&angularPID, settings.kP, settings.kI, settings.kD,
+                    settings.windupRange, true);
+  std::destroy_at(&angularLargeExit);
+  std::construct_at(&angularLargeExit, settings.largeError,
+                    int(settings.largeErrorTimeout));
+  std::destroy_at(&angularSmallExit);
+  std::construct_at(&angularSmallExit, settings.smallError,
+                    int(settings.smallErrorTimeout));
+}
+
+motion::Handle motion::Chassis::turnToHeading(
+    float theta, int timeout, lemlib::TurnToHeadingParams params, bool async) {
+  auto state = std::make_shared<MotionState>();
+  startMotion(state, async, [=, this]() {
+    turn(theta, timeout, params, true);
+
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    // -1 marks the motion as finished
+    distTraveled = -1;
+  });
+  return Handle(state);
+}
+
+motion::Handle motion::Chassis::profiledMoveToPoint(float x, float y,
+                                                   int timeout,
+                                                   ProfiledMoveParams params,
+                                                   bool async) {
+  auto state = std::make_shared<MotionState>();
+  startMotion(state, async, [=, this]() {
+    profiledMove({x, y}, std::nullopt, timeout, params);
+  });
+  return Handle(state);
+}
+
+motion::Handle motion::Chassis::profiledMoveToPose(float x, float y,
+                                                  float theta, int timeout,
+                                                  ProfiledMoveParams params,
+                                                  bool async) {
+  auto state = std::make_shared<MotionState>();
+  startMotion(state, async, [=, this]() {
+    profiledMove({x, y}, M_PI / 2 - lemlib::degToRad(theta), timeout, params);
+  });
+  return Handle(state);
+}
+
+void motion::Chassis::profiledMove(lemlib::Pose target,
+                                   std::optional<float> heading, int timeout,
+                                   ProfiledMoveParams params) {
+  // backwards, the back of the robot arrives at the heading
+  if (heading && !params.forwards) *heading += M_PI;
+  const Profile profile =
+      params.profile
+          ? *params.profile
+          : Profile(moveLength(getPose(true, true), target, heading,
+                               params.lead),
+                    params.constraints.value_or(profileSettings.constraints));
+  profiledDrive(target, heading, timeout, params, profile, 0, nullptr);
+
+  drivetrain.leftMotors->move(0);
+  drivetrain.rightMotors->move(0);
+  // -1 marks the motion as finished
+  distTraveled = -1;
+}
+
+// `heading` is already turned around for a move backwards, and `travelled` is
+// how far along the route the move starts, for waitUntil
+float motion::Chassis::profiledDrive(lemlib::Pose target,
+                                     std::optional<float> heading, int timeout,
+                                     const ProfiledMoveParams &params,
+                                     Profile profile, float travelled,
+                                     const std::atomic<float> *handoff) {
+  lateralPID.reset();
+  lateralLargeExit.reset();
+  lateralSmallExit.reset();
+  if (lateralSettle) lateralSettle->reset();
+  angularPID.reset();
+
+  const lemlib::Pose start = getPose(true, true);
+  // a point is approached in a straight line, so progress is measured along
+  // it. A pose is approached along a curve, so progress is the distance
+  // driven
+  const float length = start.distance(target);
+  const float lineX = length > 0 ? (target.x - start.x) / length : 0;
+  const float lineY = length > 0 ? (target.y - start.y) / length : 0;
+  // the way the robot travels as it passes through the target
+  const float arrival =
+      heading ? *heading : std::atan2(target.y - start.y, target.x - start.x);
+  const float direction = params.forwards ? 1 : -1;
+
+  lemlib::Timer timer(timeout);
+  const int compState = pros::competition::get_status();
+  std::uint32_t lastTime = pros::millis();
+  float elapsed = 0; // s along the profile
+  float offset = 0;  // how far along the move the profile starts
+  float requested = handoff ? handoff->load() : 0;
+  float driven = 0;
+  lemlib::Pose lastPose = start;
+  bool close = false;
+  distTraveled = travelled;
+
+  while (!timer.isDone() && running() &&
+         pros::competition::get_status() == compState) {
+    const lemlib::Pose pose = controlPose(true, true);
+    driven += pose.distance(lastPose);
+    distTraveled = travelled + driven;
+    lastPose = pose;
+    report(driven);
+
+    // once close, LemLib stops steering for the target, which would swing
+    // the robot around as it arrives
+    const float distTarget = pose.distance(target);
+    if (distTarget < 7.5) close = true;
+    const lemlib::Pose aim = heading && !close
+                                 ? carrotPoint(pose, target, *heading,
+                                               params.lead)
+                                 : target;
+
+    const float robotTheta = params.forwards ? pose.theta : pose.theta + M_PI;
+    float angularError = 0;
+    if (!close) {
+      angularError = lemlib::angleError(robotTheta, pose.angle(aim));
+    } else if (heading) {
+      angularError = lemlib::angleError(robotTheta, *heading);
+    }
+    float angularOut = angularPID.update(lemlib::radToDeg(angularError));
+    if (close && !heading) angularOut = 0;
+
+    // A robot facing away from where it is going makes no progress however
+    // fast it drives, so the profile only runs as fast as the robot faces
+    // along it. Otherwise it would run ahead while the robot turns, and the
+    // robot would overshoot catching up
+    const float facing = close ? 1 : std::max(0.0f, std::cos(angularError));
+    const std::uint32_t now = pros::millis();
+    elapsed += (now - lastTime) / 1000.0f * facing;
+    lastTime = now;
+    ProfileState state = profile.sample(elapsed);
+    // a move queued after this one has changed the speed to hand on at, so
+    // the rest of the profile is remade from where it has got to
+    if (handoff != nullptr && handoff->load() != requested) {
+      requested = handoff->load();
+      profile = Profile(profile.getDistance() - state.position,
+                        params.constraints.value_or(
+                            profileSettings.constraints),
+                        state.velocity, requested);
+      offset += state.position;
+      elapsed = 0;
+      state = profile.sample(0);
+    }
+    const bool profileDone = elapsed >= profile.getDuration();
+    // Handing on, the next motion takes over just before the robot passes
+    // the target, so it starts turning for the next target in time to pass
+    // close to this one rather than swinging wide of it
+    const bool passing = profile.getEndVelocity() > 0;
+    if (passing &&
+        (pose.x - target.x) * std::cos(arrival) +
+                (pose.y - target.y) * std::sin(arrival) >=
+            -profile.getEndVelocity() * kBlendTime) {
+      return profile.getEndVelocity();
+    }
+
+    // LemLib's lateral error: the distance to what the robot aims at, along
+    // the way it faces
+    const float remaining =
+        pose.distance(aim) *
+        std::cos(lemlib::angleError(pose.theta, pose.angle(aim)));
+    lateralLargeExit.update(remaining);
+    const bool settled = smallExit(lateralSettle, lateralSmallExit, remaining,
+                                   localSpeed().y);
+    if (profileDone && !passing && (settled || lateralLargeExit.getExit())) {
+      break;
+    }
+
+    const float progress =
+        heading ? driven
+                : (pose.x - start.x) * lineX + (pose.y - start.y) * lineY;
+    float lateralOut =
+        profileDone && !passing
+            ? lateralPID.update(remaining)
+            : direction * facing *
+                  (profileSettings.feedforward.power(state.velocity,
+                                                     state.acceleration) +
+                   lateralPID.update(offset + state.position - progress));
+
+    lateralOut = std::clamp(lateralOut, -params.maxSpeed, params.maxSpeed);
+    angularOut = std::clamp(angularOut, -params.maxSpeed, params.maxSpeed);
+    drive(lateralOut + angularOut, lateralOut - angularOut, params.maxSpeed);
+    pros::delay(10);
+  }
+  return 0;
+}
+
+motion::Handle motion::Chassis::queueMoveToPoint(float x, float y, int timeout,
+                                       ProfiledMoveParams params) {
+  QueuedMotion motion;
+  motion.kind = QueuedMotion::Kind::Move;
+  motion.timeout = timeout;
+  motion.target = {x, y, 0};
+  motion.move = params;
+  motion.forwards = params.forwards;
+  return enqueue(motion);
+}
+
+motion::Handle motion::Chassis::queueMoveToPose(float x, float y, float theta,
+                                      int timeout, ProfiledMoveParams params) {
+  QueuedMotion motion;
+  motion.kind = QueuedMotion::Kind::Move;
+  motion.timeout = timeout;
+  motion.target = {x, y, 0};
+  // backwards, the back of the robot arrives at the heading
+  motion.heading = M_PI / 2 - lemlib::degToRad(theta) +
+                   (params.forwards ? 0 : M_PI);
+  motion.move = params;
+  motion.forwards = params.forwards;
+  return enqueue(motion);
+}
+
+motion::Handle motion::Chassis::queueTurnToHeading(float theta, int timeout,
+                                         lemlib::TurnToHeadingParams params) {
+  QueuedMotion motion;
+  motion.kind = QueuedMotion::Kind::Turn;
+  motion.timeout = timeout;
+  motion.theta = theta;
+  motion.turn = params;
+  return enqueue(motion);
+}
+
+motion::Handle motion::Chassis::queueFollow(path::BinaryPath path, float lookahead,
+                                  int timeout, bool forwards) {
+  if (path.empty()) return Handle();
+  QueuedMotion motion;
+  motion.kind = QueuedMotion::Kind::Follow;
+  motion.timeout = timeout;
+  motion.path = path;
+  motion.lookahead = lookahead;
+  motion.forwards = forwards;
+  return enqueue(motion);
+}
+
+void motion::Chassis::plan(QueuedMotion &motion, lemlib::Pose start) const {
+  motion.start = start;
+  motion.end = start;
+  motion.length = 0;
+  switch (motion.kind) {
+    case QueuedMotion::Kind::Move: {
+      motion.length = moveLength(start, motion.target, motion.heading,
+                                 motion.move.lead);
+      // a pose sets off towards its first carrot point
+      const lemlib::Pose first =
+          motion.heading ? carrotPoint(start, motion.target, *motion.heading,
+                                       motion.move.lead)
+                         : motion.target;
+      motion.start.theta = std::atan2(first.y - start.y, first.x - start.x);
+      motion.end = motion.target;
+      motion.end.theta = motion.heading.value_or(motion.start.theta);
+      break;
+    }
+    case QueuedMotion::Kind::Turn:
+      motion.end.theta = M_PI / 2 - lemlib::degToRad(motion.theta);
+      break;
+    case QueuedMotion::Kind::Follow: {
+      const path::BinaryPath &path = *motion.path;
+      const std::size_t n = path.size();
+      const path::Point first = path[0];
+      const path::Point second = path[n > 1 ? 1 : 0];
+      const path::Point last = path[n - 1];
+      const path::Point beforeLast = path[n > 1 ? n - 2 : 0];
+      motion.start = {first.x, first.y,
+                      std::atan2(second.y - first.y, second.x - first.x)};
+      motion.end = {last.x, last.y,
+                    std::atan2(last.y - beforeLast.y, last.x - beforeLast.x)};
+      motion.length = path.length();
+      break;
+    }
+  }
+}
+
+motion::Handle motion::Chassis::enqueue(QueuedMotion motion) {
+  motion.state = std::make_shared<MotionState>();
+  const Handle handle(motion.state);
+  queueMutex.take();
+  // queueing never waits, so a full queue turns the motion away
+  if (queued == kQueueLength) {
+    queueMutex.give();
+    motion.state->cancel();
+    motion.state->finish();
+    return handle;
+  }
+  const bool starting = !routeRunning;
+  QueuedMotion *previous =
+      queued > 0 ? &queue[(queueHead + queued - 1) % kQueueLength] : nullptr;
+  plan(motion, previous ? previous->end : getPose(true, true));
+
+  // A move hands on to a move or path that carries on the same way. The
+  // sharper the route turns between them, the slower, down to stopping to
+  // turn around
+  const Constraints constraints =
+      motion.move.constraints.value_or(profileSettings.constraints);
+  float entry = 0;
+  if (previous != nullptr && previous->kind == QueuedMotion::Kind::Move &&
+      !previous->move.profile && motion.kind != QueuedMotion::Kind::Turn &&
+      previous->forwards == motion.forwards) {
+    const float turn =
+        std::remainder(motion.start.theta - previous->end.theta, 2 * M_PI);
+    entry = previous->move.exitSpeed * (1 + std::cos(turn)) / 2;
+    if (motion.kind == QueuedMotion::Kind::Move) {
+      entry = std::min(entry, stoppingVelocity(motion.length, constraints));
+    }
+    previous->profile =
+        Profile(previous->length,
+                previous->move.constraints.value_or(
+                    profileSettings.constraints),
+                previous->profile.sample(0).velocity, entry);
+    entry = previous->profile.getEndVelocity();
+    // the previous move may be running already
+    if (previous == &queue[queueHead]) handoff = entry;
+  }
+  if (motion.kind == QueuedMotion::Kind::Move) {
+    motion.profile = motion.move.profile
+                         ? *motion.move.profile
+                         : Profile(motion.length, constraints, entry);
+  }
+  queue[(queueHead + queued) % kQueueLength] = motion;
+  queued++;
+  routeRunning = true;
+  queueMutex.give();
+  if (!starting) return handle;
+
+  // The route starts after any motion running already, as LemLib's motions
+  // do, but waits for it on its own task rather than the caller's. Yielding
+  // lets that task get in line for the chassis before the caller can start
+  // anything after the route
+  pros::Task task([this]() { runRoute(); });
+  pros::delay(0);
+  return handle;
+}
+
+// cancels every motion still queued
+void motion::Chassis::dropRoute() {
+  queueMutex.take();
+  for (; queued > 0; queued--) {
+    std::shared_ptr<MotionState> state = std::move(queue[queueHead].state);
+    queueHead = (queueHead + 1) % kQueueLength;
+    state->cancel();
+    state->finish();
+  }
+  routeRunning = false;
+  queueMutex.give();
+}
+
+void motion::Chassis::runRoute() {
+  requestMotionStart();
+  float speed = 0; // that the last motion handed on at
+  distTraveled = 0;
+  while (motionRunning) {
+    queueMutex.take();
+    if (queued == 0) {
+      routeRunning = false;
+      queueMutex.give();
+      break;
+    }
+    QueuedMotion motion = queue[queueHead];
+    handoff = motion.profile.getEndVelocity();
+    queueMutex.give();
+
+    const float travelled = distTraveled;
+    current = motion.state;
+    currentStart = pros::millis();
+    // a motion cancelled before it started is skipped
+    speed = motion.state->isCancelled() ? 0
+                                        : runQueued(motion, speed, travelled);
+    current = nullptr;
+
+    queueMutex.take();
+    queue[queueHead].state = nullptr;
+    queueHead = (queueHead + 1) % kQueueLength;
+    queued--;
+    queueMutex.give();
+    motion.state->finish();
+  }
+
+  // cancelling the route drops what is left of it
+  dropRoute();
+  drivetrain.leftMotors->move(0);
+  drivetrain.rightMotors->move(0);
+  // -1 marks the motion as finished
+  distTraveled = -1;
+  endMotion();
+}
+
+// Runs one motion of a route, started at `speed` and `travelled` inches
+// along it, and returns the speed it hands on at
+float motion::Chassis::runQueued(QueuedMotion &motion, float speed,
+                                 float travelled) {
+  switch (motion.kind) {
+    case QueuedMotion::Kind::Move: {
+      // the plan is only remade if the motion before did not hand on where
+      // or as fast as it was meant to
+      const lemlib::Pose pose = getPose(true, true);
+      if (!motion.move.profile &&
+          (pose.distance(motion.start) > 1 ||
+           std::fabs(speed - motion.profile.sample(0).velocity) > 1)) {
+        motion.profile = Profile(
+            moveLength(pose, motion.target, motion.heading, motion.move.lead),
+            motion.move.constraints.value_or(profileSettings.constraints),
+            speed, handoff);
+      }
+      return profiledDrive(motion.target, motion.heading, motion.timeout,
+                           motion.move, motion.profile, travelled, &handoff);
+    }
+    case QueuedMotion::Kind::Turn:
+      turn(motion.theta, motion.timeout, motion.turn, false);
+      distTraveled = travelled;
+      return 0;
+    case QueuedMotion::Kind::Follow:
+      pursue(*motion.path, motion.lookahead, motion.timeout, motion.forwards,
+             travelled);
+      return 0;
+  }
+  return 0;
+}
+
+// The same controller as lemlib::Chassis::turnToHeading
+void motion::Chassis::turn(float theta, int timeout,
+                           lemlib::TurnToHeadingParams params, bool counted) {
+  params.minSpeed = std::abs(params.minSpeed);
+  float prevMotorPower = 0;
+  bool settling = false;
+  std::optional<float> prevRawDeltaTheta;
+  std::optional<float> prevDeltaTheta;
+  lemlib::Timer timer(timeout);
+  angularLargeExit.reset();
+  angularSmallExit.reset();
+  if (angularSettle) angularSettle->reset();
+  angularPID.reset();
+  if (turnPid) turnPid->reset();
+  const float startTheta = getPose().theta;
+  if (counted) distTraveled = 0;
+  bool settled = false;
+  const int compState = pros::competition::get_status();
+
+  while (!timer.isDone() && !angularLargeExit.getExit() && !settled &&
+         running() && pros::competition::get_status() == compState) {
+    const lemlib::Pose pose = controlPose();
+    const float turned =
+        std::fabs(lemlib::angleError(pose.theta, startTheta, false));
+    if (counted) distTraveled = turned;
+    report(turned);
+    // once the robot crosses the heading, it settles by the shortest way
+    const float rawDeltaTheta = lemlib::angleError(theta, pose.theta, false);
+    if (!prevRawDeltaTheta) prevRawDeltaTheta = rawDeltaTheta;
+    if (lemlib::sgn(rawDeltaTheta) != lemlib::sgn(*prevRawDeltaTheta)) {
+      settling = true;
+    }
+    prevRawDeltaTheta = rawDeltaTheta;
+    const float deltaTheta =
+        settling ? rawDeltaTheta
+                 : lemlib::angleError(theta, pose.theta, false,
+                                      params.direction);
+    if (!prevDeltaTheta) prevDeltaTheta = deltaTheta;
+
+    // with a minimum speed, the turn hands on early instead of settling
+    if (params.minSpeed != 0 &&
+        (std::fabs(deltaTheta) < params.earlyExitRange ||
+         lemlib::sgn(deltaTheta) != lemlib::sgn(*prevDeltaTheta))) {
+      break;
+    }
+    prevDeltaTheta = deltaTheta;
+
+    float motorPower =
+        turnPid ? turnPid->update(deltaTheta, pose.theta, params.maxSpeed)
+                : angularPID.update(deltaTheta);
+    angularLargeExit.update(deltaTheta);
+    settled = smallExit(angularSettle, angularSmallExit, deltaTheta,
+                        lemlib::radToDeg(localSpeed().theta));
+    motorPower = std::clamp(motorPower, -float(params.maxSpeed),
+                            float(params.maxSpeed));
+    if (std::fabs(deltaTheta) > 20) {
+      motorPower = lemlib::slew(motorPower, prevMotorPower,
+                                angularSettings.slew);
+    }
+    if (motorPower < 0 && motorPower > -params.minSpeed) {
+      motorPower = -params.minSpeed;
+    } else if (motorPower > 0 && motorPower < params.minSpeed) {
+      motorPower = params.minSpeed;
+    }
+    prevMotorPower = motorPower;
+    drive(motorPower, -motorPower);
+    pros::delay(10);
+  }
+}
+
+// Starts a motion the way LemLib's start: after the one running and any
+// queued before it, on a task of its own if `async`. `body` drives the motion
+// and stops the robot
+void motion::Chassis::startMotion(std::shared_ptr<MotionState> state,
+                                  bool async, std::function<void()> body) {
+  requestMotionStart();
+  if (!motionRunning) {
+    state->cancel();
+    state->finish();
+    return;
+  }
+  if (async) {
+    pros::Task task([=, this]() { startMotion(state, false, body); });
+    endMotion();
+    pros::delay(10);
+    return;
+  }
+  current = state;
+  currentStart = pros::millis();
+  body();
+  current = nullptr;
+  endMotion();
+  state->finish();
+}
+
+bool motion::Chassis::running() const {
+  return motionRunning && !(current && current->isCancelled());
+}
+
+void motion::Chassis::report(float distance) {
+  if (current) {
+    current->report({distance, pros::millis() - currentStart, getPose()});
+  }
+}
+
+void motion::Chassis::drive(float left, float right, float limit) {
+  if (mixer) {
+    const DriveMixer::Voltages voltages = mixer->power(left, right, limit);
+    drivetrain.leftMotors->move_voltage(voltages.left);
+    drivetrain.rightMotors->move_voltage(voltages.right);
+    return;
+  }
+  const float ratio = std::max(std::fabs(left), std::fabs(right)) / limit;
+  if (ratio > 1) {
+    left /= ratio;
+    right /= ratio;
+  }
+  drivetrain.leftMotors->move(left);
+  drivetrain.rightMotors->move(right);
+}
@@ -0,0 +1,113 @@
+#include "motion/handle.h"
+
+#include <utility>
+
+void motion::MotionState::report(const Progress &progress) {
+  // Actions run outside the lock, so they may add more. Nothing is allocated
+  // unless one is due
+  std::vector<Action> due;
+  mutex.take();
+  last = progress;
+  for (std::size_t i = 0; i < triggers.size();) {
+    if (triggers[i].condition && triggers[i].condition(progress)) {
+      due.push_back(std::move(triggers[i].action));
+      triggers[i] = std::move(triggers.back());
+      triggers.pop_back();
+    } else {
+      i++;
+    }
+  }
+  mutex.give();
+  for (Action &action : due) action();
+}
+
+void motion::MotionState::finish() {
+  std::vector<Trigger> ended;
+  mutex.take();
+  done = true;
+  std::swap(ended, triggers);
+  mutex.give();
+  for (Trigger &trigger : ended) {
+    if (trigger.orDone) trigger.action();
+  }
+}
+
+void motion::MotionState::add(Condition condition, Action action,
+                              bool orDone) {
+  mutex.take();
+  if (!done) {
+    triggers.push_back({std::move(condition), std::move(action), orDone});
+    mutex.give();
+    return;
+  }
+  mutex.give();
+  if (orDone) action();
+}
+
+motion::Progress motion::MotionState::progress() {
+  mutex.take();
+  Progress progress = last;
+  mutex.give();
+  return progress;
+}
+
+motion::Handle::Handle() : state(std::make_shared<MotionState>()) {
+  state->cancel();
+  state->finish();
+}
+
+motion::Handle::Handle(std::shared_ptr<MotionState> state)
+    : state(std::move(state)) {}
+
+motion::Handle &motion::Handle::atDistance(float distance, Action action) {
+  return when(
+      [distance](const Progress &progress) {
+        return progress.distance >= distance;
+      },
+      std::move(action));
+}
+
+motion::Handle &motion::Handle::atTime(std::uint32_t time, Action action) {
+  return when(
+      [time](const Progress &progress) { return progress.time >= time; },
+      std::move(action));
+}
+
+motion::Handle &motion::Handle::when(Condition condition, Action action) {
+  state->add(std::move(condition), std::move(action), false);
+  return *this;
+}
+
+motion::Handle &motion::Handle::onDone(Action action) {
+  state->add(nullptr, std::move(action), true);
+  return *this;
+}
+
+void motion::Handle::waitUntil(float distance) const {
+  wait([distance](const Progress &progress) {
+    return progress.distance >= distance;
+  });
+}
+
+void motion::Handle::waitUntilDone() const { wait(nullptr); }
+
+void motion::Handle::cancel() { state->cancel(); }
+
+// The motion notifies the waiting task once, from whichever task gets there.
+// Anything else that notifies the task only wakes it to go back to sleep. A
+// motion that has already ended runs the action on the waiting task itself,
+// which must not notify itself: nothing would take that notification, and
+// the task's next notify_take would return straight away
+void motion::Handle::wait(Condition condition) const {
+  if (state->isDone()) return;
+  pros::task_t self = pros::c::task_get_current();
+  auto woken = std::make_shared<std::atomic<bool>>(false);
+  state->add(
+      std::move(condition),
+      [self, woken] {
+        *woken = true;
+        if (pros::c::task_get_current() != self) pros::c::task_notify(self);
+      },
+      true);
+  while (!*woken) pros::Task::notify_take(true, TIMEOUT_MAX);
+}
@@ -0,0 +1,92 @@
+#include "motion/mixer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "pros/misc.hpp"
+
+namespace {
+// what move() maps power out of 127 onto, and so what feedforward and PID
+// gains tuned through it are in, in mV
+constexpr float kFullPower = 12000;
+
+// Brings the sides under `ceiling`, both together, or by `bias` between the
+// throttle and the turn
+motion::DriveMixer::Voltages desaturate(motion::DriveMixer::Voltages voltages,
+                                        float ceiling,
+                                        std::optional<float> bias) {
+  const float most =
+      std::max(std::fabs(voltages.left), std::fabs(voltages.right));
+  if (most <= ceiling) return voltages;
+  if (!bias) {
+    return {voltages.left * ceiling / most, voltages.right * ceiling / most};
+  }
+  // the larger side is |throttle| + |turn|, so that is what must come down.
+  // Whatever one of them cannot give up comes off the other
+  float throttle = (voltages.left + voltages.right) / 2;
+  float turn = (voltages.left - voltages.right) / 2;
+  const float excess = most - ceiling;
+  const float fromTurn = std::min(
+      std::fabs(turn), excess - std::min(std::fabs(throttle), excess * *bias));
+  const float fromThrottle = excess - fromTurn;
+  throttle -= std::copysign(fromThrottle, throttle);
+  turn -= std::copysign(fromTurn, turn);
+  return {throttle + turn, throttle - turn};
+}
+
+// mV full power drives a side at, before the battery's ceiling
+float fullVoltage(const motion::MixerSettings &settings) {
+  return settings.maxVoltage > 0 ? std::min(settings.maxVoltage, kFullPower)
+                                 : kFullPower;
+}
+}  // namespace
+
+motion::DriveMixer::Voltages motion::DriveMixer::arcade(float throttle,
+                                                        float turn,
+                                                        float bias) const {
+  // LemLib's arcade, on whole power as it has it
+  int wholeThrottle = throttle;
+  int wholeTurn = turn;
+  if (std::abs(wholeThrottle) + std::abs(wholeTurn) > 127) {
+    const int oldThrottle = wholeThrottle;
+    const int oldTurn = wholeTurn;
+    wholeThrottle *= (1 - bias * std::abs(oldTurn / 127.0));
+    wholeTurn *= (1 - (1 - bias) * std::abs(oldThrottle / 127.0));
+  }
+  const Voltages full = voltages(wholeThrottle + wholeTurn,
+                                 wholeThrottle - wholeTurn);
+  return desaturate(full, ceiling(), bias);
+}
+
+motion::DriveMixer::Voltages motion::DriveMixer::driver(float left,
+                                                        float right) const {
+  return desaturate(voltages(left, right), ceiling(), std::nullopt);
+}
+
+motion::DriveMixer::Voltages motion::DriveMixer::power(float left, float right,
+                                                       float limit) const {
+  return desaturate({left * kFullPower / 127, right * kFullPower / 127},
+                    std::min(ceiling(), limit * kFullPower / 127),
+                    std::nullopt);
+}
+
+float motion::DriveMixer::ceiling() const {
+  return std::clamp(pros::battery::get_voltage() - settings.headroom, 0.0f,
+                    fullVoltage(settings));
+}
+
+motion::DriveMixer::Voltages motion::DriveMixer::voltages(float left,
+                                                          float right) const {
+  const float full = fullVoltage(settings);
+  if (settings.left.kV != 0 && settings.right.kV != 0) {
+    // the feedforward can ask for more than full voltage, which is shared
+    // out the way tank drive's is, keeping the arc
+    const float scale = settings.topSpeed / 127;
+    return desaturate(
+        {settings.left.power(left * scale, 0) * kFullPower / 127,
+         settings.right.power(right * scale, 0) * kFullPower / 127},
+        full, std::nullopt);
+  }
+  return {left * full / 127, right * full / 127};
+}
@@ -0,0 +1,74 @@
+#include "motion/pid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+motion::Gains lerp(const motion::Gains &a, const motion::Gains &b, float t) {
+  return {a.kP + (b.kP - a.kP) * t, a.kI + (b.kI - a.kI) * t,
+          a.kD + (b.kD - a.kD) * t};
+}
+}  // namespace
+
+motion::GainSchedule::GainSchedule(Gains gains)
+    : points{{0, gains, gains}}, count(1), speed(0) {}
+
+motion::GainSchedule::GainSchedule(float speed,
+                                   std::initializer_list<GainPoint> points)
+    : count(std::min(points.size(), kMaxPoints)), speed(speed) {
+  std::copy_n(points.begin(), count, this->points);
+}
+
+motion::Gains motion::GainSchedule::at(float error, float speed) const {
+  if (count == 0) return {0, 0, 0};
+  error = std::fabs(error);
+  std::size_t i = 0;
+  while (i < count && points[i].error < error) i++;
+  const GainPoint &high = points[std::min(i, count - 1)];
+  const GainPoint &low = points[i == 0 ? 0 : i - 1];
+  float t = high.error > low.error
+                ? (error - low.error) / (high.error - low.error)
+                : 0;
+  float s = this->speed > 0 ? std::min(std::fabs(speed) / this->speed, 1.0f)
+                            : 0;
+  return lerp(lerp(low.rest, high.rest, t), lerp(low.moving, high.moving, t),
+              s);
+}
+
+motion::Pid::Pid(GainSchedule schedule, float filter, float windupRange,
+                 float period)
+    : schedule(schedule), alpha(period / (filter + period)),
+      windupRange(windupRange), period(period) {}
+
+float motion::Pid::update(float error, float measurement, float limit) {
+  if (!started) {
+    prevMeasurement = measurement;
+    started = true;
+  }
+  // how the error changes with the target held still
+  derivative += alpha * (prevMeasurement - measurement - derivative);
+  prevMeasurement = measurement;
+  speed = -derivative * 1000 / period;
+  const Gains gains = schedule.at(error, speed);
+
+  if (windupRange != 0 && std::fabs(error) > windupRange) {
+    integral = 0;
+  } else {
+    // integrate only while that does not push a saturated output further
+    float output = gains.kP * error + gains.kI * (integral + error) +
+                   gains.kD * derivative;
+    if (std::fabs(output) < limit || (error > 0) != (output > 0)) {
+      integral += error;
+    }
+  }
+  return std::clamp(
+      gains.kP * error + gains.kI * integral + gains.kD * derivative, -limit,
+      limit);
+}
+
+void motion::Pid::reset() {
+  integral = 0;
+  derivative = 0;
+  speed = 0;
+  started = false;
+}
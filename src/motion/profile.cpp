@@ -0,0 +1,162 @@
+#include "motion/profile.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// How long changing speed takes as fast as the constraints allow. With the
+// jerk limited, `jerkTime` is how long the acceleration takes to build up at
+// each end, and a change too small to reach full acceleration never holds it
+float rampTime(float from, float to, const motion::Constraints &constraints,
+               float &jerkTime) {
+  float change = std::fabs(to - from);
+  float a = constraints.maxAcceleration;
+  float j = constraints.maxJerk;
+  if (j <= 0) {
+    jerkTime = 0;
+    return change / a;
+  }
+  if (change >= a * a / j) {
+    jerkTime = a / j;
+    return change / a + jerkTime;
+  }
+  jerkTime = std::sqrt(change / j);
+  return 2 * jerkTime;
+}
+
+// a ramp's speed is symmetric about its middle, so it covers the mean of its
+// ends for its whole time
+float rampDistance(float from, float to,
+                   const motion::Constraints &constraints) {
+  float jerkTime;
+  return (from + to) / 2 * rampTime(from, to, constraints, jerkTime);
+}
+
+// the value between `good` and `bad` nearest `bad` that still fits
+template <typename F> float bisect(float good, float bad, F &&fits) {
+  for (int i = 0; i < 32; i++) {
+    float middle = (good + bad) / 2;
+    (fits(middle) ? good : bad) = middle;
+  }
+  return good;
+}
+}  // namespace
+
+float motion::Feedforward::power(float velocity, float acceleration) const {
+  float sign = velocity > 0 ? 1 : velocity < 0 ? -1 : 0;
+  return kS * sign + kV * velocity + kA * acceleration;
+}
+
+motion::Profile::Profile(float distance, const Constraints &constraints,
+                         float startVelocity, float endVelocity)
+    : distance(std::fabs(distance)),
+      startVelocity(std::max(0.0f, startVelocity)),
+      endVelocity(std::max(0.0f, endVelocity)) {
+  const float v0 = this->startVelocity;
+  float &v1 = this->endVelocity;
+  const float d = this->distance;
+  if ((d == 0 && v0 == 0) || constraints.maxVelocity <= 0 ||
+      constraints.maxAcceleration <= 0) {
+    v1 = 0;
+    addPhase(0, 0, 0);
+    return;
+  }
+
+  // A start faster than the top speed may be too fast to slow to it within
+  // the distance. Then the profile only slows as far as the distance allows,
+  // and ends faster than the top speed
+  const float slowest = std::min(v0, constraints.maxVelocity);
+  v1 = std::min(v1, constraints.maxVelocity);
+  if (rampDistance(v0, slowest, constraints) > d) {
+    v1 = bisect(v0, slowest, [&](float end) {
+      return rampDistance(v0, end, constraints) <= d;
+    });
+    addRamp(v0, v1, constraints);
+    return;
+  }
+
+  // The length of the ramps to a speed to cruise at and from it to the end.
+  // The start may be faster than the top speed, and the cruise is never
+  // slower than the end, so the slowest it can be is the larger of the end and
+  // `slowest`
+  auto length = [&](float cruise, float end) {
+    return rampDistance(v0, cruise, constraints) +
+           rampDistance(cruise, end, constraints);
+  };
+  if (length(std::max(v1, slowest), v1) > d) {
+    // the end speed nearest the one asked for that the distance allows
+    v1 = bisect(slowest, v1, [&](float end) {
+      return length(std::max(end, slowest), end) <= d;
+    });
+  }
+  const float cruise =
+      length(constraints.maxVelocity, v1) <= d
+          ? constraints.maxVelocity
+          : bisect(std::max(v1, slowest), constraints.maxVelocity,
+                   [&](float speed) { return length(speed, v1) <= d; });
+
+  addRamp(v0, cruise, constraints);
+  addPhase(cruise > 0 ? std::max(0.0f, (d - length(cruise, v1)) / cruise) : 0,
+           0, 0);
+  addRamp(cruise, v1, constraints);
+}
+
+float motion::stoppingVelocity(float distance,
+                               const Constraints &constraints) {
+  if (constraints.maxVelocity <= 0 || constraints.maxAcceleration <= 0) {
+    return 0;
+  }
+  return bisect(0, constraints.maxVelocity, [&](float speed) {
+    return rampDistance(speed, 0, constraints) <= std::fabs(distance);
+  });
+}
+
+void motion::Profile::addRamp(float from, float to,
+                              const Constraints &constraints) {
+  float jerkTime;
+  float time = rampTime(from, to, constraints, jerkTime);
+  float sign = to > from ? 1 : -1;
+  if (constraints.maxJerk <= 0) {
+    addPhase(time, 0, sign * constraints.maxAcceleration);
+    return;
+  }
+  float peak = constraints.maxJerk * jerkTime;
+  addPhase(jerkTime, sign * constraints.maxJerk, 0);
+  addPhase(time - 2 * jerkTime, 0, sign * peak);
+  addPhase(jerkTime, -sign * constraints.maxJerk, sign * peak);
+}
+
+// starts a phase where the last one ended, at the given acceleration
+void motion::Profile::addPhase(float length, float jerk, float acceleration) {
+  ProfileState start = {0, startVelocity, acceleration};
+  if (count > 0) {
+    const Phase &last = phases[count - 1];
+    float t = last.duration;
+    start.position = last.start.position + last.start.velocity * t +
+                     last.start.acceleration * t * t / 2 +
+                     last.jerk * t * t * t / 6;
+    start.velocity = last.start.velocity + last.start.acceleration * t +
+                     last.jerk * t * t / 2;
+  }
+  phases[count++] = {std::max(0.0f, length), jerk, start};
+  duration += phases[count - 1].duration;
+}
+
+motion::ProfileState motion::Profile::sample(float time) const {
+  if (time >= duration) {
+    return {distance + endVelocity * (time - duration), endVelocity, 0};
+  }
+  time = std::max(time, 0.0f);
+  std::size_t i = 0;
+  while (i + 1 < count && time >= phases[i].duration) {
+    time -= phases[i].duration;
+    i++;
+  }
+  const Phase &phase = phases[i];
+  float t = time;
+  return {phase.start.position + phase.start.velocity * t +
+              phase.start.acceleration * t * t / 2 + phase.jerk * t * t * t / 6,
+          phase.start.velocity + phase.start.acceleration * t +
+              phase.jerk * t * t / 2,
+          phase.start.acceleration + phase.jerk * t};
+}
@@ -0,0 +1,62 @@
+#include "motion/settle.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "pros/rtos.hpp"
+
+namespace {
+// how much of each new reading the deceleration takes
+constexpr float kFilter = 0.5;
+}  // namespace
+
+bool motion::SettleCondition::update(float error, float speed) {
+  const std::uint32_t now = pros::millis();
+  const bool closing = started && std::fabs(error) < std::fabs(prevError);
+  // how fast the robot is slowing, from the speed odometry measures rather
+  // than from differencing the error twice
+  if (started && now > prevTime) {
+    const float dt = (now - prevTime) / 1000.0f;
+    deceleration +=
+        kFilter *
+        ((std::fabs(prevSpeed) - std::fabs(speed)) / dt - deceleration);
+  }
+  prevError = error;
+  prevSpeed = speed;
+  prevTime = now;
+  started = true;
+
+  // Within range and stopped, or stopped within the stall range once the
+  // robot has got going. Before then it has stopped only because the motion
+  // has not moved it yet
+  if (std::fabs(speed) >= settings.speed) moved = true;
+  const float reach = moved ? std::max(settings.range, settings.stallRange)
+                            : settings.range;
+  bool on = std::fabs(error) < reach && std::fabs(speed) < settings.speed;
+  // Closing on the target and slowing: with the deceleration held, the robot
+  // stops after speed / deceleration s, having covered half what the speed
+  // would cover in that time
+  if (!on && settings.horizon != 0 && closing && deceleration > 0) {
+    const float stopping = std::fabs(speed) / deceleration;
+    on = stopping * 1000 <= settings.horizon &&
+         std::fabs(std::fabs(error) - std::fabs(speed) * stopping / 2) <
+             settings.range;
+  }
+
+  if (!on) {
+    settling = false;
+  } else if (!settling) {
+    settling = true;
+    since = now;
+  }
+  if (settling && now - since >= settings.time) done = true;
+  return done;
+}
+
+void motion::SettleCondition::reset() {
+  deceleration = 0;
+  started = false;
+  moved = false;
+  settling = false;
+  done = false;
+}
@@ -0,0 +1,187 @@
+#include "motion/timedPath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "lemlib/util.hpp"
+
+namespace {
+float squaredDistance(const motion::TimedPath::Point &point,
+                      const lemlib::Pose &pose) {
+  float dx = point.x - pose.x;
+  float dy = point.y - pose.y;
+  return dx * dx + dy * dy;
+}
+}  // namespace
+
+motion::TimedPath::TimedPath(const path::BinaryPath &path,
+                             const Constraints &constraints,
+                             float trackWidth) {
+  for (std::size_t i = 0; i < path.size(); i++) {
+    path::Point point = path[i];
+    points.push_back({point.x, point.y, point.distance, point.curvature});
+    if (point.speed == 0) break;
+  }
+  parameterize(constraints, trackWidth);
+}
+
+motion::TimedPath::TimedPath(const asset &text, const Constraints &constraints,
+                             float trackWidth) {
+  const char *data = reinterpret_cast<const char *>(text.buf);
+  std::size_t start = 0;
+  while (start < text.size) {
+    const char *end = static_cast<const char *>(
+        std::memchr(data + start, '\n', text.size - start));
+    std::size_t length = end ? end - (data + start) : text.size - start;
+    char line[64] = {};
+    std::memcpy(line, data + start, std::min(length, sizeof(line) - 1));
+    start += length + 1;
+    if (std::strncmp(line, "endData", 7) == 0) break;
+    float x, y, speed;
+    if (std::sscanf(line, "%f , %f , %f", &x, &y, &speed) != 3) continue;
+    float distance = 0;
+    if (!points.empty()) {
+      distance = points.back().distance +
+                 std::hypot(x - points.back().x, y - points.back().y);
+    }
+    points.push_back({x, y, distance});
+    if (speed == 0) break;
+  }
+
+  // the curvature of the arc through each point's neighbours, leaving the
+  // point along the line between them. The ends take their neighbours'
+  for (std::size_t i = 0; i < points.size() && points.size() >= 3; i++) {
+    std::size_t middle = std::clamp<std::size_t>(i, 1, points.size() - 2);
+    const Point &a = points[middle - 1];
+    const Point &b = points[middle];
+    const Point &c = points[middle + 1];
+    if (b.distance == a.distance || c.distance == b.distance) continue;
+    points[i].curvature = lemlib::getCurvature(
+        {b.x, b.y, std::atan2(c.y - a.y, c.x - a.x)}, {c.x, c.y});
+  }
+  parameterize(constraints, trackWidth);
+}
+
+void motion::TimedPath::parameterize(const Constraints &constraints,
+                                     float trackWidth) {
+  const float a = constraints.maxAcceleration;
+  const float v = constraints.maxVelocity;
+  if (points.empty() || a <= 0 || v <= 0) return;
+
+  // the slowest of the limits at each point
+  for (Point &point : points) {
+    float k = std::fabs(point.curvature);
+    point.velocity = v;
+    if (k > 0) {
+      point.velocity = std::min({point.velocity, v / (1 + k * trackWidth / 2),
+                                 std::sqrt(a / k)});
+    }
+  }
+  // from rest at the start, and back to rest at the end
+  points.front().velocity = 0;
+  for (std::size_t i = 1; i < points.size(); i++) {
+    float ds = points[i].distance - points[i - 1].distance;
+    points[i].velocity =
+        std::min(points[i].velocity,
+                 std::sqrt(points[i - 1].velocity * points[i - 1].velocity +
+                           2 * a * ds));
+  }
+  points.back().velocity = 0;
+  for (std::size_t i = points.size() - 1; i-- > 0;) {
+    float ds = points[i + 1].distance - points[i].distance;
+    points[i].velocity =
+        std::min(points[i].velocity,
+                 std::sqrt(points[i + 1].velocity * points[i + 1].velocity +
+                           2 * a * ds));
+  }
+
+  // constant acceleration between points, which is what makes the square of
+  // the velocity change linearly with distance
+  points.front().time = 0;
+  for (std::size_t i = 0; i + 1 < points.size(); i++) {
+    Point &point = points[i];
+    const Point &next = points[i + 1];
+    float ds = next.distance - point.distance;
+    float speeds = point.velocity + next.velocity;
+    point.acceleration =
+        ds > 0 ? (next.velocity * next.velocity -
+                  point.velocity * point.velocity) /
+                     (2 * ds)
+               : 0;
+    points[i + 1].time = point.time + (speeds > 0 ? 2 * ds / speeds : 0);
+  }
+  points.back().acceleration = 0;
+}
+
+motion::ProfileState motion::TimedPath::sample(float time,
+                                               std::size_t &hint) const {
+  if (empty()) return {0, 0, 0};
+  if (time >= getDuration()) return {getLength(), 0, 0};
+  time = std::max(time, 0.0f);
+  if (hint >= size() || points[hint].time > time) hint = 0;
+  while (hint + 1 < size() && points[hint + 1].time <= time) hint++;
+  const Point &point = points[hint];
+  float t = time - point.time;
+  return {point.distance + point.velocity * t + point.acceleration * t * t / 2,
+          point.velocity + point.acceleration * t, point.acceleration};
+}
+
+std::size_t motion::TimedPath::closest(const lemlib::Pose &pose,
+                                       std::size_t from) const {
+  if (empty()) return 0;
+  std::size_t i = std::min(from, size() - 1);
+  float distance = squaredDistance(points[i], pose);
+  while (i + 1 < size()) {
+    float next = squaredDistance(points[i + 1], pose);
+    if (next > distance) break;
+    distance = next;
+    i++;
+  }
+  return i;
+}
+
+float motion::TimedPath::progress(const lemlib::Pose &pose,
+                                  std::size_t index) const {
+  if (size() < 2) return 0;
+  index = std::min(index, size() - 1);
+  // the segment the robot is beside: the one leaving the point, unless the
+  // robot has not reached the point yet or it is the last
+  std::size_t from = index + 1 < size() ? index : index - 1;
+  auto along = [&](std::size_t i) {
+    const Point &a = points[i];
+    const Point &b = points[i + 1];
+    float length = b.distance - a.distance;
+    if (length == 0) return 0.0f;
+    return ((pose.x - a.x) * (b.x - a.x) + (pose.y - a.y) * (b.y - a.y)) /
+           length;
+  };
+  float t = along(from);
+  if (t < 0 && from == index && index > 0) {
+    from = index - 1;
+    t = along(from);
+  }
+  // past the end counts, so the robot can tell that it overshot
+  float length = points[from + 1].distance - points[from].distance;
+  if (from + 2 < size()) t = std::min(t, length);
+  return points[from].distance + std::max(t, 0.0f);
+}
+
+lemlib::Pose motion::TimedPath::pointAt(float distance,
+                                        std::size_t &hint) const {
+  if (empty()) return {0, 0, 0};
+  if (size() == 1) return {points[0].x, points[0].y, 0};
+  distance = std::max(distance, 0.0f);
+  if (hint + 1 >= size() || points[hint].distance > distance) hint = 0;
+  while (hint + 2 < size() && points[hint + 1].distance < distance) hint++;
+  // past the end, the line of the last segment carries on, so there is still
+  // a point to steer at as the robot arrives
+  const Point &a = points[hint];
+  const Point &b = points[hint + 1];
+  float length = b.distance - a.distance;
+  if (length == 0) return {b.x, b.y, 0};
+  float t = (distance - a.distance) / length;
+  return {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t,
+          std::atan2(b.y - a.y, b.x - a.x)};
+}
@@ -0,0 +1,134 @@
+#include "motion/tracker.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// sin(x) / x, which is 1 at 0
+float sinc(float x) { return std::fabs(x) < 1e-6 ? 1 : std::sin(x) / x; }
+
+// Solves the discrete algebraic Riccati equation for the unicycle linearized
+// at `velocity`, by iterating it until the LQR gain it gives settles. At a
+// standstill the sideways error cannot be corrected, so its part of the
+// solution never settles, but its gains are zero all the same. `p` is where
+// to start from, and is left with the solution: the solution at a nearby
+// velocity settles much sooner than Q does
+void unicycleGain(double velocity, double dt, const double q[3],
+                  const double r[2], double p[3][3], float k[2][3]) {
+  const double a[3][3] = {{1, 0, 0}, {0, 1, velocity * dt}, {0, 0, 1}};
+  const double b[3][2] = {{dt, 0}, {0, velocity * dt * dt / 2}, {0, dt}};
+  double gain[2][3] = {};
+  for (int iteration = 0; iteration < 5000; iteration++) {
+    // BᵀP, then BᵀPA and R + BᵀPB
+    double bp[2][3] = {};
+    double bpa[2][3] = {};
+    double s[2][2] = {{r[0], 0}, {0, r[1]}};
+    for (int i = 0; i < 2; i++) {
+      for (int j = 0; j < 3; j++) {
+        for (int l = 0; l < 3; l++) bp[i][j] += b[l][i] * p[l][j];
+      }
+      for (int j = 0; j < 3; j++) {
+        for (int l = 0; l < 3; l++) bpa[i][j] += bp[i][l] * a[l][j];
+      }
+      for (int j = 0; j < 2; j++) {
+        for (int l = 0; l < 3; l++) s[i][j] += bp[i][l] * b[l][j];
+      }
+    }
+    // K = S⁻¹BᵀPA
+    double det = s[0][0] * s[1][1] - s[0][1] * s[1][0];
+    double inverse[2][2] = {{s[1][1] / det, -s[0][1] / det},
+                            {-s[1][0] / det, s[0][0] / det}};
+    double change = 0;
+    for (int i = 0; i < 2; i++) {
+      for (int j = 0; j < 3; j++) {
+        double next = inverse[i][0] * bpa[0][j] + inverse[i][1] * bpa[1][j];
+        change = std::max(change, std::fabs(next - gain[i][j]));
+        gain[i][j] = next;
+      }
+    }
+    if (change < 1e-5) break;
+    // P = Q + AᵀP(A - BK)
+    double closed[3][3];
+    double pc[3][3] = {};
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++) {
+        closed[i][j] = a[i][j] - b[i][0] * gain[0][j] - b[i][1] * gain[1][j];
+      }
+    }
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++) {
+        for (int l = 0; l < 3; l++) pc[i][j] += p[i][l] * closed[l][j];
+      }
+    }
+    double next[3][3] = {};
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++) {
+        for (int l = 0; l < 3; l++) next[i][j] += a[l][i] * pc[l][j];
+        if (i == j) next[i][j] += q[i];
+      }
+    }
+    std::copy(&next[0][0], &next[0][0] + 9, &p[0][0]);
+  }
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < 3; j++) k[i][j] = gain[i][j];
+  }
+}
+}  // namespace
+
+motion::TrackingError::TrackingError(const lemlib::Pose &pose,
+                                     const Reference &reference) {
+  float dx = reference.pose.x - pose.x;
+  float dy = reference.pose.y - pose.y;
+  x = std::cos(pose.theta) * dx + std::sin(pose.theta) * dy;
+  y = -std::sin(pose.theta) * dx + std::cos(pose.theta) * dy;
+  theta = std::remainder(reference.pose.theta - pose.theta, 2 * M_PI);
+}
+
+motion::Command motion::Ramsete::calculate(const lemlib::Pose &pose,
+                                           const Reference &reference) const {
+  TrackingError error(pose, reference);
+  float v = reference.velocity;
+  float w = reference.angularVelocity;
+  float k = 2 * zeta * std::sqrt(w * w + b * v * v);
+  return {v * std::cos(error.theta) + k * error.x,
+          w + k * error.theta + b * v * sinc(error.theta) * error.y};
+}
+
+motion::LtvUnicycle::LtvUnicycle(LtvTolerances tolerances, float period,
+                                 float maxVelocity, float velocityStep)
+    : velocityStep(std::max(velocityStep, maxVelocity / (kGains - 1))) {
+  const double q[3] = {1 / (tolerances.x * tolerances.x),
+                       1 / (tolerances.y * tolerances.y),
+                       1 / (tolerances.theta * tolerances.theta)};
+  const double r[2] = {
+      1 / (tolerances.velocity * tolerances.velocity),
+      1 / (tolerances.angularVelocity * tolerances.angularVelocity)};
+  count = std::min<std::size_t>(kGains, maxVelocity / this->velocityStep + 1);
+  double p[3][3] = {{q[0], 0, 0}, {0, q[1], 0}, {0, 0, q[2]}};
+  // from the fastest down, since the solution at a standstill has the
+  // sideways part that never settles
+  for (std::size_t i = count; i-- > 0;) {
+    unicycleGain(i * this->velocityStep, period, q, r, p, gains[i].k);
+  }
+}
+
+motion::Command motion::LtvUnicycle::calculate(
+    const lemlib::Pose &pose, const Reference &reference) const {
+  TrackingError error(pose, reference);
+  // between the two nearest velocities in the table. Backwards, the unicycle
+  // is the same one mirrored left to right
+  float speed = std::fabs(reference.velocity) / velocityStep;
+  std::size_t i = std::min<std::size_t>(speed, count - 1);
+  std::size_t j = std::min(i + 1, count - 1);
+  float t = std::clamp(speed - i, 0.0f, 1.0f);
+  float side = reference.velocity < 0 ? -1 : 1;
+  const float e[3] = {error.x, side * error.y, error.theta};
+  float u[2] = {};
+  for (int row = 0; row < 2; row++) {
+    for (int col = 0; col < 3; col++) {
+      u[row] += (gains[i].k[row][col] * (1 - t) + gains[j].k[row][col] * t) *
+                e[col];
+    }
+  }
+  return {reference.velocity + u[0], reference.angularVelocity + u[1]};
+}
@@ -0,0 +1,212 @@
+#include "odom/ekf.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "lemlib/util.hpp"
+
+namespace {
+// smoothing of the speed estimates, the same as the tracker's
+constexpr float kSpeedSmoothing = 0.95;
+constexpr double kGravity = 386.09; // in/s^2
+// measurements further than this many standard deviations out are rejected
+constexpr double kGate = 5;
+// the wheels have to be still this long, in us, before the robot is taken to
+// be. A slow turn can go a few updates without an encoder count
+constexpr std::uint64_t kStillTime = 100000;
+// uncertainty of the gyro bias before any calibration, rad/s
+constexpr double kInitialBias = 0.002;
+// slip beyond this fraction of the distance travelled is no slower to correct
+constexpr double kMaxSlip = 1;
+
+double square(double value) { return value * value; }
+}  // namespace
+
+odom::Ekf::Ekf(float trackWidth, float horizontalOffset, EkfNoise noise)
+    : trackWidth(trackWidth), horizontalOffset(horizontalOffset), noise(noise) {
+  covariance[kBias][kBias] = square(kInitialBias);
+}
+
+void odom::Ekf::reset(const SensorFrame &frame) {
+  last = frame;
+  lastForward = 0;
+  movedAt = frame.time;
+  speed = {0, 0, 0};
+  localSpeed = {0, 0, 0};
+}
+
+void odom::Ekf::setPose(lemlib::Pose pose) {
+  state[kX] = pose.x;
+  state[kY] = pose.y;
+  state[kTheta] = pose.theta;
+  // the pose is known exactly, and tells nothing about the gyro
+  for (int i = 0; i < kStates; i++) {
+    for (int j = 0; j < kStates; j++) {
+      if (i != kBias || j != kBias) covariance[i][j] = 0;
+    }
+  }
+}
+
+lemlib::Pose odom::Ekf::getPose() const {
+  return {float(state[kX]), float(state[kY]), float(state[kTheta])};
+}
+
+lemlib::Pose odom::Ekf::getUncertainty() const {
+  return {float(std::sqrt(covariance[kX][kX])),
+          float(std::sqrt(covariance[kY][kY])),
+          float(std::sqrt(covariance[kTheta][kTheta]))};
+}
+
+lemlib::Pose odom::Ekf::update(const SensorFrame &frame) {
+  double dt = (frame.time - last.time) / 1e6;
+  predict(frame, dt);
+
+  bool newFix = frame.gpsX != lastGpsX || frame.gpsY != lastGpsY ||
+                frame.gpsHeading != lastGpsHeading;
+  if (frame.gpsValid && newFix) {
+    lastGpsX = frame.gpsX;
+    lastGpsY = frame.gpsY;
+    lastGpsHeading = frame.gpsHeading;
+    double variance = square(frame.gpsError);
+    correct(kX, frame.gpsX - state[kX], variance);
+    correct(kY, frame.gpsY - state[kY], variance);
+    // the GPS heading wraps, the pose's does not
+    double heading = lemlib::degToRad(frame.gpsHeading) - state[kTheta];
+    correct(kTheta, std::remainder(heading, 2 * M_PI),
+            square(lemlib::degToRad(noise.gpsHeading)));
+  }
+
+  last = frame;
+  return getPose();
+}
+
+void odom::Ekf::predict(const SensorFrame &frame, double dt) {
+  double deltaLeft = frame.left - last.left;
+  double deltaRight = frame.right - last.right;
+  double deltaX = frame.horizontal - last.horizontal;
+  double deltaY = (deltaLeft + deltaRight) / 2;
+  bool gyro = frame.imuValid && last.imuValid;
+
+  // encoders only count once a new motor report is in, so no change between
+  // two reads of the same report says nothing
+  bool moved = deltaLeft != 0 || deltaRight != 0 || deltaX != 0;
+  if (moved) movedAt = frame.time;
+  bool reported = frame.leftTimestamp != last.leftTimestamp;
+  bool still = !moved && reported && frame.time - movedAt >= kStillTime;
+
+  double deltaHeading;
+  double headingVariance;
+  if (gyro && still) {
+    // a robot whose wheels are not turning is not turning either, so the
+    // gyro's reading is all bias
+    double gyroDelta = lemlib::degToRad(frame.imuRotation - last.imuRotation);
+    if (dt > 0) {
+      correct(kBias, gyroDelta / dt - state[kBias],
+              square(noise.gyroNoise) / dt);
+    }
+    deltaHeading = 0;
+    headingVariance = 0;
+  } else if (gyro) {
+    deltaHeading = lemlib::degToRad(frame.imuRotation - last.imuRotation) -
+                   state[kBias] * dt;
+    headingVariance = square(noise.gyroNoise) * dt;
+  } else {
+    deltaHeading = (deltaLeft - deltaRight) / trackWidth;
+    headingVariance = square(noise.encoderHeading * deltaHeading);
+  }
+
+  // the same arc model as the tracker
+  double localX = deltaX;
+  double localY = deltaY;
+  if (deltaHeading != 0) {
+    double chord = 2 * std::sin(deltaHeading / 2);
+    localX = chord * (deltaX / deltaHeading + horizontalOffset);
+    localY = chord * (deltaY / deltaHeading);
+  }
+  double avgHeading = state[kTheta] + deltaHeading / 2;
+  double sin = std::sin(avgHeading);
+  double cos = std::cos(avgHeading);
+  state[kX] += localY * sin - localX * cos;
+  state[kY] += localY * cos + localX * sin;
+  state[kTheta] += deltaHeading;
+
+  // a wheel breaking traction shows up as the encoders accelerating
+  // differently to the robot
+  double slip = noise.wheelSlip;
+  if (dt > 0) {
+    double forward = deltaY / dt;
+    if (gyro) {
+      double encoderAccel = (forward - lastForward) / dt / kGravity;
+      slip += noise.slipPerG * std::abs(encoderAccel - frame.imuAccel.y);
+      slip = std::min(slip, kMaxSlip);
+    }
+    lastForward = forward;
+  }
+
+  // P = F P F' + Q, where F is the identity apart from the heading's, and the
+  // bias's through the heading, effect on the position
+  double dXdTheta = localY * cos + localX * sin;
+  double dYdTheta = -localY * sin + localX * cos;
+  double dThetadBias = gyro && !still ? -dt : 0;
+  double jacobian[kStates][kStates] = {
+      {1, 0, dXdTheta, dXdTheta * dThetadBias / 2},
+      {0, 1, dYdTheta, dYdTheta * dThetadBias / 2},
+      {0, 0, 1, dThetadBias},
+      {0, 0, 0, 1},
+  };
+  double product[kStates][kStates] = {};
+  for (int i = 0; i < kStates; i++) {
+    for (int j = 0; j < kStates; j++) {
+      for (int k = 0; k < kStates; k++) {
+        product[i][j] += jacobian[i][k] * covariance[k][j];
+      }
+    }
+  }
+  for (int i = 0; i < kStates; i++) {
+    for (int j = 0; j < kStates; j++) {
+      double sum = 0;
+      for (int k = 0; k < kStates; k++) sum += product[i][k] * jacobian[j][k];
+      covariance[i][j] = sum;
+    }
+  }
+
+  // slip along and across the robot, turned into the field frame
+  double forwardVariance = square(slip * deltaY);
+  double sideVariance = square(slip * deltaX);
+  covariance[kX][kX] += forwardVariance * sin * sin + sideVariance * cos * cos;
+  covariance[kY][kY] += forwardVariance * cos * cos + sideVariance * sin * sin;
+  double crossVariance = (forwardVariance - sideVariance) * sin * cos;
+  covariance[kX][kY] += crossVariance;
+  covariance[kY][kX] += crossVariance;
+  covariance[kTheta][kTheta] += headingVariance;
+  covariance[kBias][kBias] += square(noise.gyroBiasDrift) * dt;
+
+  if (dt > 0) {
+    double deltaXField = localY * sin - localX * cos;
+    double deltaYField = localY * cos + localX * sin;
+    speed.x = lemlib::ema(deltaXField / dt, speed.x, kSpeedSmoothing);
+    speed.y = lemlib::ema(deltaYField / dt, speed.y, kSpeedSmoothing);
+    speed.theta = lemlib::ema(deltaHeading / dt, speed.theta, kSpeedSmoothing);
+    localSpeed.x = lemlib::ema(localX / dt, localSpeed.x, kSpeedSmoothing);
+    localSpeed.y = lemlib::ema(localY / dt, localSpeed.y, kSpeedSmoothing);
+    localSpeed.theta =
+        lemlib::ema(deltaHeading / dt, localSpeed.theta, kSpeedSmoothing);
+  }
+}
+
+bool odom::Ekf::correct(int index, double innovation, double variance) {
+  double total = covariance[index][index] + variance;
+  if (total <= 0 || square(innovation) > square(kGate) * total) return false;
+
+  double gain[kStates];
+  double row[kStates];
+  for (int i = 0; i < kStates; i++) {
+    gain[i] = covariance[i][index] / total;
+    row[i] = covariance[index][i];
+  }
+  for (int i = 0; i < kStates; i++) {
+    state[i] += gain[i] * innovation;
+    for (int j = 0; j < kStates; j++) covariance[i][j] -= gain[i] * row[j];
+  }
+  return true;
+}
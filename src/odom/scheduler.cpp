@@ -0,0 +1,157 @@
+#include "odom/scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/util.hpp"
+#include "telemetry/log.h"
+
+namespace {
+// above the screen, logger and driver tasks, so none of them can delay it
+constexpr std::uint32_t kPriority = TASK_PRIORITY_DEFAULT + 2;
+constexpr int kImuAttempts = 5;
+// smoothing of the latency estimate, so one late update does not throw the
+// pose forwards
+constexpr float kLatencySmoothing = 0.1;
+}  // namespace
+
+odom::Scheduler::Scheduler(SensorReader &reader, Estimator &estimator,
+                           std::uint32_t period)
+    : reader(reader),
+      estimator(estimator),
+      requestHandled(requested.getVersion()),
+      period(period) {}
+
+void odom::Scheduler::calibrate() {
+  // an update against a calibrating IMU would read garbage
+  stop();
+
+  pros::Imu *imu = reader.getImu();
+  if (imu != nullptr) {
+    // without a working IMU, frames are marked invalid and odometry falls back
+    // to the drive encoders for heading
+    for (int attempt = 1; attempt <= kImuAttempts; attempt++) {
+      imu->reset(true);
+      if (std::isfinite(imu->get_heading())) break;
+    }
+  }
+
+  reader.tare();
+  estimator.reset(reader.read());
+  start();
+  pros::c::controller_rumble(pros::E_CONTROLLER_MASTER, ".");
+}
+
+void odom::Scheduler::setPeriod(std::uint32_t period) {
+  this->period = period;
+}
+
+void odom::Scheduler::start() {
+  if (running) return;
+  running = true;
+  task = new pros::Task([this]() { run(); }, kPriority,
+                        TASK_STACK_DEPTH_DEFAULT, "odometry");
+}
+
+void odom::Scheduler::stop() {
+  running = false;
+  // the task finishes its last update before it notices
+  if (task != nullptr) task->join();
+  delete task;
+  task = nullptr;
+}
+
+void odom::Scheduler::run() {
+  std::uint32_t wake = pros::millis();
+  std::uint64_t lastStart = 0;
+  while (running) {
+    std::uint64_t start = pros::micros();
+    SensorFrame frame = reader.read();
+    if (requested.getVersion() != requestHandled) {
+      requestHandled = requested.getVersion();
+      estimator.setPose(requested.read());
+    }
+    PoseSample sample;
+    sample.time = frame.time;
+    sample.pose = estimator.update(frame);
+    sample.velocity = estimator.getSpeed();
+    sample.localVelocity = estimator.getLocalSpeed();
+    poses.write(sample);
+    frames.write(frame);
+
+    std::uint32_t nominal = period;
+    std::uint64_t elapsed = pros::micros() - start;
+    // motors report every 10 ms, so the encoders are already a little old
+    double sensorAge = frame.time / 1000.0 - frame.leftTimestamp;
+    double measured = (std::max(sensorAge, 0.0) + elapsed / 1000.0 +
+                       nominal / 2.0 + commandLatency) /
+                      1000;
+    latency = lemlib::ema(measured, latency, kLatencySmoothing);
+    lemlib::setPose(sample.pose, true);
+    execution.record(pros::micros() - start);
+
+    if (lastStart != 0) {
+      std::int64_t late = std::int64_t(start - lastStart) - nominal * 1000;
+      jitter.record(std::llabs(late));
+    }
+    lastStart = start;
+    pros::Task::delay_until(&wake, nominal);
+  }
+}
+
+lemlib::Pose odom::Scheduler::estimatePose(float seconds, bool radians) const {
+  PoseSample sample = poses.read();
+  float age = (pros::micros() - sample.time) / 1e6;
+  lemlib::Pose pose =
+      extrapolate(sample.pose, sample.localVelocity, age + seconds);
+  if (!radians) pose.theta = lemlib::radToDeg(pose.theta);
+  return pose;
+}
+
+lemlib::Pose odom::Scheduler::getCompensatedPose(bool radians) const {
+  PoseSample sample = poses.read();
+  lemlib::Pose pose = extrapolate(sample.pose, sample.localVelocity, latency);
+  if (!radians) pose.theta = lemlib::radToDeg(pose.theta);
+  return pose;
+}
+
+void odom::Scheduler::setCommandLatency(std::uint32_t commandLatency) {
+  this->commandLatency = commandLatency;
+}
+
+odom::PoseSample odom::Scheduler::getPose(bool radians) const {
+  PoseSample sample = poses.read();
+  if (!radians) {
+    sample.pose.theta = lemlib::radToDeg(sample.pose.theta);
+    sample.velocity.theta = lemlib::radToDeg(sample.velocity.theta);
+    sample.localVelocity.theta = lemlib::radToDeg(sample.localVelocity.theta);
+  }
+  return sample;
+}
+
+void odom::Scheduler::setPose(lemlib::Pose pose, bool radians) {
+  if (!radians) pose.theta = lemlib::degToRad(pose.theta);
+  requested.write(pose);
+  lemlib::setPose(pose, true);
+}
+
+odom::Timing odom::Scheduler::timing() const {
+  return {execution.summary(), jitter.summary()};
+}
+
+void odom::Scheduler::resetTiming() {
+  execution.reset();
+  jitter.reset();
+}
+
+void odom::Scheduler::logTiming() const {
+  Timing now = timing();
+  telemetry::telemetryLog().info(
+      "Odom timing: period {} ms, execution us min {} mean {:.1f} p99 {} max "
+      "{}, jitter us min {} mean {:.1f} p99 {} max {}",
+      getPeriod(), now.execution.min, now.execution.mean, now.execution.p99,
+      now.execution.max, now.jitter.min, now.jitter.mean, now.jitter.p99,
+      now.jitter.max);
+}
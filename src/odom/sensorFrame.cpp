@@ -0,0 +1,120 @@
+#include "odom/sensorFrame.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "pros/error.h"
+
+namespace {
+constexpr double kMetersPerInch = 0.0254;
+
+// raw encoder counts per output revolution, and free speed, of each cartridge
+double countsPerRev(pros::MotorGears gearset) {
+  switch (gearset) {
+    case pros::MotorGears::red:
+      return 1800;
+    case pros::MotorGears::blue:
+      return 300;
+    default:
+      return 900;
+  }
+}
+
+double cartridgeRpm(pros::MotorGears gearset) {
+  switch (gearset) {
+    case pros::MotorGears::red:
+      return 100;
+    case pros::MotorGears::blue:
+      return 600;
+    default:
+      return 200;
+  }
+}
+
+// inches the wheels move per raw count of the side's motors
+double inchesPerCount(pros::MotorGroup *motors, float wheelDiameter,
+                      float rpm) {
+  pros::MotorGears gearset = motors->get_gearing();
+  double wheelRevsPerMotorRev = rpm / cartridgeRpm(gearset);
+  return M_PI * wheelDiameter * wheelRevsPerMotorRev / countsPerRev(gearset);
+}
+}  // namespace
+
+odom::SensorReader::SensorReader(const lemlib::Drivetrain &drivetrain,
+                                 pros::Rotation *horizontal,
+                                 float horizontalDiameter,
+                                 float horizontalOffset,
+                                 pros::Imu *imu,
+                                 pros::Gps *gps)
+    : leftMotors(drivetrain.leftMotors),
+      rightMotors(drivetrain.rightMotors),
+      trackWidth(drivetrain.trackWidth),
+      wheelDiameter(drivetrain.wheelDiameter),
+      rpm(drivetrain.rpm),
+      horizontal(horizontal),
+      horizontalDiameter(horizontalDiameter),
+      horizontalOffset(horizontalOffset),
+      imu(imu),
+      gps(gps) {}
+
+double odom::SensorReader::readSide(pros::MotorGroup *motors,
+                                    const std::int32_t *zero,
+                                    double inchesPerCount,
+                                    std::int32_t *raw,
+                                    std::uint32_t *timestamp) {
+  int count = std::min<int>(motors->size(), kMaxSideMotors);
+  double total = 0;
+  int working = 0;
+  for (int i = 0; i < count; i++) {
+    raw[i] = motors->get_raw_position(timestamp, i);
+    // an unplugged motor drops out of the average
+    if (raw[i] == PROS_ERR) continue;
+    total += raw[i] - zero[i];
+    working++;
+  }
+  return working ? total / working * inchesPerCount : 0;
+}
+
+odom::SensorFrame odom::SensorReader::read() {
+  SensorFrame frame;
+  frame.time = pros::micros();
+  frame.left = readSide(leftMotors, leftZero, leftInchesPerCount,
+                        frame.leftRaw, &frame.leftTimestamp);
+  frame.right = readSide(rightMotors, rightZero, rightInchesPerCount,
+                         frame.rightRaw, &frame.rightTimestamp);
+
+  if (horizontal != nullptr) {
+    std::int32_t centidegrees = horizontal->get_position();
+    if (centidegrees != PROS_ERR) {
+      frame.horizontal = centidegrees / 36000.0 * M_PI * horizontalDiameter;
+    }
+  }
+
+  if (imu != nullptr) {
+    frame.imuRotation = imu->get_rotation();
+    frame.imuHeading = imu->get_heading();
+    frame.imuAccel = imu->get_accel();
+    // errors, including a calibrating IMU, read as infinity
+    frame.imuValid = std::isfinite(frame.imuRotation);
+  }
+
+  if (gps != nullptr) {
+    pros::gps_status_s_t status = gps->get_position_and_orientation();
+    frame.gpsX = status.x / kMetersPerInch;
+    frame.gpsY = status.y / kMetersPerInch;
+    frame.gpsHeading = status.yaw;
+    frame.gpsError = gps->get_error() / kMetersPerInch;
+    frame.gpsValid = std::isfinite(frame.gpsX) && std::isfinite(frame.gpsError);
+  }
+  return frame;
+}
+
+void odom::SensorReader::tare() {
+  // raw counts cannot be zeroed, so distances are measured from here instead
+  SensorFrame frame = read();
+  std::copy(std::begin(frame.leftRaw), std::end(frame.leftRaw), leftZero);
+  std::copy(std::begin(frame.rightRaw), std::end(frame.rightRaw), rightZero);
+  leftInchesPerCount = inchesPerCount(leftMotors, wheelDiameter, rpm);
+  rightInchesPerCount = inchesPerCount(rightMotors, wheelDiameter, rpm);
+  if (horizontal != nullptr) horizontal->reset_position();
+}
@@ -0,0 +1,75 @@
+#include "odom/tracker.h"
+
+#include <cmath>
+
+#include "lemlib/util.hpp"
+
+namespace {
+// smoothing of the speed estimates, the same as LemLib's
+constexpr float kSpeedSmoothing = 0.95;
+}  // namespace
+
+odom::Tracker::Tracker(float trackWidth, float horizontalOffset)
+    : trackWidth(trackWidth), horizontalOffset(horizontalOffset) {}
+
+void odom::Tracker::reset(const SensorFrame &frame) {
+  last = frame;
+  speed = {0, 0, 0};
+  localSpeed = {0, 0, 0};
+}
+
+lemlib::Pose odom::Tracker::update(const SensorFrame &frame) {
+  double deltaLeft = frame.left - last.left;
+  double deltaRight = frame.right - last.right;
+  double deltaX = frame.horizontal - last.horizontal;
+  double deltaY = (deltaLeft + deltaRight) / 2;
+
+  double deltaHeading;
+  if (frame.imuValid && last.imuValid) {
+    deltaHeading = lemlib::degToRad(frame.imuRotation - last.imuRotation);
+  } else {
+    deltaHeading = (deltaLeft - deltaRight) / trackWidth;
+  }
+  double avgHeading = pose.theta + deltaHeading / 2;
+
+  // the robot moves along an arc; these are the chords of it in its own frame
+  double localX = deltaX;
+  double localY = deltaY;
+  if (deltaHeading != 0) {
+    double chord = 2 * std::sin(deltaHeading / 2);
+    localX = chord * (deltaX / deltaHeading + horizontalOffset);
+    localY = chord * (deltaY / deltaHeading);
+  }
+
+  lemlib::Pose previous = pose;
+  pose.x += localY * std::sin(avgHeading) - localX * std::cos(avgHeading);
+  pose.y += localY * std::cos(avgHeading) + localX * std::sin(avgHeading);
+  pose.theta += deltaHeading;
+
+  // speeds use the time the frames were actually read, not the nominal period
+  double dt = (frame.time - last.time) / 1e6;
+  if (dt > 0) {
+    speed.x = lemlib::ema((pose.x - previous.x) / dt, speed.x, kSpeedSmoothing);
+    speed.y = lemlib::ema((pose.y - previous.y) / dt, speed.y, kSpeedSmoothing);
+    speed.theta = lemlib::ema(deltaHeading / dt, speed.theta, kSpeedSmoothing);
+    localSpeed.x = lemlib::ema(localX / dt, localSpeed.x, kSpeedSmoothing);
+    localSpeed.y = lemlib::ema(localY / dt, localSpeed.y, kSpeedSmoothing);
+    localSpeed.theta =
+        lemlib::ema(deltaHeading / dt, localSpeed.theta, kSpeedSmoothing);
+  }
+  last = frame;
+  return pose;
+}
+
+lemlib::Pose odom::extrapolate(lemlib::Pose pose, lemlib::Pose localVelocity,
+                               float seconds) {
+  // Pose's scalar multiply leaves theta alone, so scale by hand
+  float deltaX = localVelocity.x * seconds;
+  float deltaY = localVelocity.y * seconds;
+  float deltaTheta = localVelocity.theta * seconds;
+  float avgHeading = pose.theta + deltaTheta / 2;
+  pose.x += deltaY * std::sin(avgHeading) - deltaX * std::cos(avgHeading);
+  pose.y += deltaY * std::cos(avgHeading) + deltaX * std::sin(avgHeading);
+  pose.theta += deltaTheta;
+  return pose;
+}
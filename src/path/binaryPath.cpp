@@ -0,0 +1,16 @@
+#include "path/binaryPath.h"
+
+path::BinaryPath::BinaryPath(const asset &file) {
+  if (file.size < sizeof(Header)) return;
+  Header header;
+  std::memcpy(&header, file.buf, sizeof(Header));
+  if (header.magic != kMagic || header.version != kVersion ||
+      header.pointSize != sizeof(Point) ||
+      // divided rather than multiplied, so a corrupt count cannot wrap
+      header.count > (file.size - sizeof(Header)) / sizeof(Point)) {
+    return;
+  }
+  points = file.buf + sizeof(Header);
+  count = header.count;
+  pathLength = header.length;
+}
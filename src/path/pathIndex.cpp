@@ -0,0 +1,149 @@
+#include "path/pathIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr std::size_t kLeaf = 16;
+
+float squaredDistance(const path::Point &point, const lemlib::Pose &pose) {
+  float dx = point.x - pose.x;
+  float dy = point.y - pose.y;
+  return dx * dx + dy * dy;
+}
+
+// How far along the segment from p1 to p2 it crosses the lookahead circle, or
+// -1 if it does not. Prefers the crossing further down the path
+float circleIntersect(const path::Point &p1, const path::Point &p2,
+                      const lemlib::Pose &pose, float lookahead) {
+  float dx = p2.x - p1.x;
+  float dy = p2.y - p1.y;
+  float fx = p1.x - pose.x;
+  float fy = p1.y - pose.y;
+  float a = dx * dx + dy * dy;
+  float b = 2 * (fx * dx + fy * dy);
+  float c = fx * fx + fy * fy - lookahead * lookahead;
+  float discriminant = b * b - 4 * a * c;
+  if (discriminant >= 0 && a > 0) {
+    discriminant = std::sqrt(discriminant);
+    float t1 = (-b - discriminant) / (2 * a);
+    float t2 = (-b + discriminant) / (2 * a);
+    if (t2 >= 0 && t2 <= 1) return t2;
+    if (t1 >= 0 && t1 <= 1) return t1;
+  }
+  return -1;
+}
+}  // namespace
+
+path::PathIndex::PathIndex(BinaryPath path, float window)
+    : path(path), window(window) {
+  if (!path.empty()) lastLookahead = {path[0].x, path[0].y, 0};
+  build();
+}
+
+float path::PathIndex::Box::squaredDistance(const lemlib::Pose &pose) const {
+  float dx = std::max({minX - pose.x, 0.0f, pose.x - maxX});
+  float dy = std::max({minY - pose.y, 0.0f, pose.y - maxY});
+  return dx * dx + dy * dy;
+}
+
+std::size_t path::PathIndex::closest(const lemlib::Pose &pose) {
+  if (path.empty()) return 0;
+  // the robot only moves on along the path, so look from the last closest
+  // point to the end of the window
+  const float end = path[last].distance + window;
+  std::size_t best = last;
+  float bestDistance = squaredDistance(path[last], pose);
+  for (std::size_t i = last + 1; i < path.size(); i++) {
+    Point point = path[i];
+    if (point.distance > end) break;
+    float d = squaredDistance(point, pose);
+    if (d < bestDistance) {
+      best = i;
+      bestDistance = d;
+    }
+  }
+  if (bestDistance > window * window) {
+    fallbacks++;
+    best = nearest(pose);
+  }
+  last = best;
+  return best;
+}
+
+lemlib::Pose path::PathIndex::lookahead(const lemlib::Pose &pose,
+                                        float radius) {
+  if (path.size() < 2) return lastLookahead;
+  std::size_t start = std::max(last, std::size_t(lastLookahead.theta));
+  // a path still inside the circle a window past the far side of it is
+  // winding around the robot, and is not worth following to its end
+  const float end = path[last].distance + 2 * radius + window;
+  for (std::size_t i = start; i + 1 < path.size(); i++) {
+    Point p1 = path[i];
+    if (p1.distance > end) break;
+    Point p2 = path[i + 1];
+    float t = circleIntersect(p1, p2, pose, radius);
+    if (t != -1) {
+      lastLookahead = {p1.x + (p2.x - p1.x) * t, p1.y + (p2.y - p1.y) * t,
+                       float(i)};
+      break;
+    }
+  }
+  return lastLookahead;
+}
+
+std::size_t path::PathIndex::nearest(const lemlib::Pose &pose) {
+  std::size_t best = 0;
+  float bestDistance = squaredDistance(path[0], pose);
+  // depth first, nearer child first, skipping boxes further than the best
+  // point so far. Each level pushes one node, so the stack is as deep as the
+  // tree
+  std::size_t stack[2 * sizeof(std::size_t) * 8];
+  std::size_t depth = 0;
+  stack[depth++] = 1;
+  while (depth > 0) {
+    std::size_t node = stack[--depth];
+    if (boxes[node].squaredDistance(pose) >= bestDistance) continue;
+    if (node >= leaves) {
+      std::size_t first = (node - leaves) * kLeaf;
+      for (std::size_t i = first; i < std::min(first + kLeaf, path.size());
+           i++) {
+        float d = squaredDistance(path[i], pose);
+        if (d < bestDistance) {
+          best = i;
+          bestDistance = d;
+        }
+      }
+      continue;
+    }
+    std::size_t near = 2 * node;
+    std::size_t far = 2 * node + 1;
+    if (boxes[far].squaredDistance(pose) < boxes[near].squaredDistance(pose)) {
+      std::swap(near, far);
+    }
+    stack[depth++] = far;
+    stack[depth++] = near;
+  }
+  return best;
+}
+
+void path::PathIndex::build() {
+  leaves = 1;
+  while (leaves * kLeaf < path.size()) leaves *= 2;
+  // leaves with no points have boxes no pose is ever inside or near
+  boxes.assign(2 * leaves, {INFINITY, INFINITY, -INFINITY, -INFINITY});
+  for (std::size_t i = 0; i < path.size(); i++) {
+    Point point = path[i];
+    Box &box = boxes[leaves + i / kLeaf];
+    box.minX = std::min(box.minX, point.x);
+    box.minY = std::min(box.minY, point.y);
+    box.maxX = std::max(box.maxX, point.x);
+    box.maxY = std::max(box.maxY, point.y);
+  }
+  for (std::size_t node = leaves - 1; node > 0; node--) {
+    const Box &a = boxes[2 * node];
+    const Box &b = boxes[2 * node + 1];
+    boxes[node] = {std::min(a.minX, b.minX), std::min(a.minY, b.minY),
+                   std::max(a.maxX, b.maxX), std::max(a.maxY, b.maxY)};
+  }
+}
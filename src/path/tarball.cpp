@@ -0,0 +1,53 @@
+#include "path/tarball.h"
+
+#include <algorithm>
+
+namespace {
+constexpr std::string_view kMarker = "#PATH-POINTS-START ";
+}  // namespace
+
+path::Tarball::Tarball(const asset &tarball) {
+  std::string_view text(reinterpret_cast<const char *>(tarball.buf),
+                        tarball.size);
+  auto lineEnd = [&](std::size_t start) {
+    std::size_t end = text.find('\n', start);
+    return end == std::string_view::npos ? text.size() : end;
+  };
+
+  // each path runs from the line after its marker to the next line starting
+  // with #, which is either the next marker or the path generator's metadata
+  auto close = [&](std::size_t end) {
+    Entry &entry = entries.back();
+    entry.points.size = end - (entry.points.buf - tarball.buf);
+  };
+  bool open = false;
+  for (std::size_t start = 0; start < text.size();
+       start = lineEnd(start) + 1) {
+    if (text[start] != '#') continue;
+    if (open) close(start);
+    open = false;
+    std::string_view line = text.substr(start, lineEnd(start) - start);
+    if (line.substr(0, kMarker.size()) != kMarker) continue;
+    std::string_view name = line.substr(kMarker.size());
+    if (!name.empty() && name.back() == '\r') name.remove_suffix(1);
+    std::size_t body = std::min(lineEnd(start) + 1, text.size());
+    entries.push_back({name, {tarball.buf + body, 0}});
+    open = true;
+  }
+  if (open) close(text.size());
+
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry &a, const Entry &b) { return a.name < b.name; });
+}
+
+const path::Tarball::Entry *path::Tarball::find(std::string_view name) const {
+  auto entry = std::lower_bound(
+      entries.begin(), entries.end(), name,
+      [](const Entry &entry, std::string_view name) { return entry.name < name; });
+  return entry != entries.end() && entry->name == name ? &*entry : nullptr;
+}
+
+asset path::Tarball::get(std::string_view name) const {
+  const Entry *entry = find(name);
+  return entry != nullptr ? entry->points : asset{nullptr, 0};
+}
@@ -0,0 +1,50 @@
+#include "telemetry/histogram.h"
+
+#include <algorithm>
+
+void telemetry::Histogram::record(std::uint32_t value) {
+  std::uint32_t bucket = std::min(value / kBucketWidth, kBuckets);
+  buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  // single writer, so plain loads and stores are enough for the extremes
+  if (value < min.load(std::memory_order_relaxed)) {
+    min.store(value, std::memory_order_relaxed);
+  }
+  if (value > max.load(std::memory_order_relaxed)) {
+    max.store(value, std::memory_order_relaxed);
+  }
+  sum.fetch_add(value, std::memory_order_relaxed);
+  count.fetch_add(1, std::memory_order_release);
+}
+
+telemetry::Summary telemetry::Histogram::summary() const {
+  Summary summary{};
+  summary.count = count.load(std::memory_order_acquire);
+  if (!summary.count) return summary;
+  summary.min = min.load(std::memory_order_relaxed);
+  summary.max = max.load(std::memory_order_relaxed);
+  summary.mean = double(sum.load(std::memory_order_relaxed)) / summary.count;
+
+  // the 99th percentile is reported as the top of the bucket it falls in,
+  // capped at the largest sample
+  std::uint32_t rank = summary.count - summary.count / 100;
+  std::uint32_t seen = 0;
+  summary.p99 = summary.max;
+  for (std::uint32_t i = 0; i < kBuckets; i++) {
+    seen += buckets[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      summary.p99 = std::min((i + 1) * kBucketWidth - 1, summary.max);
+      break;
+    }
+  }
+  return summary;
+}
+
+void telemetry::Histogram::reset() {
+  for (std::atomic<std::uint32_t> &bucket : buckets) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  min.store(UINT32_MAX, std::memory_order_relaxed);
+  max.store(0, std::memory_order_relaxed);
+  sum.store(0, std::memory_order_relaxed);
+  count.store(0, std::memory_order_release);
+}
@@ -0,0 +1,72 @@
+#include "telemetry/log.h"
+
+#include <cstdio>
+
+namespace {
+// below the control and screen tasks, so writing never delays them
+constexpr std::uint32_t kPriority = TASK_PRIORITY_DEFAULT - 1;
+// bytes moved from the ring to the output at a time, on the draining stack
+constexpr std::size_t kBatchSize = 512;
+// Bytes written to stdout per drain. Not the space left in the serial
+// buffer, which PROS does not report: a fixed batch, sized to the buffer so
+// that the drain task mostly writes into free space, but can still block in
+// fwrite or fflush while the buffer is full
+constexpr std::size_t kStdoutBatch = 2048;
+}  // namespace
+
+const telemetry::Output telemetry::kStdout = {
+    []() -> std::size_t { return kStdoutBatch; },
+    [](const char *bytes, std::size_t size) {
+      std::fwrite(bytes, 1, size, stdout);
+      std::fflush(stdout);
+    }};
+
+telemetry::Log::Log(Output output, const char *prefix, const char *suffix,
+                    util::Overflow overflow, lemlib::Level lowestLevel)
+    : output(output),
+      prefix(prefix),
+      suffix(suffix),
+      prefixSize(std::strlen(prefix)),
+      suffixSize(std::strlen(suffix)),
+      lowestLevel(lowestLevel),
+      ring(overflow) {}
+
+std::size_t telemetry::Log::drain() {
+  char batch[kBatchSize];
+  std::size_t space = output.space();
+  std::size_t written = 0;
+  while (written < space) {
+    std::size_t size =
+        ring.pop(batch, std::min(kBatchSize, space - written));
+    if (size == 0) break;
+    output.write(batch, size);
+    written += size;
+  }
+  return written;
+}
+
+void telemetry::Log::start(std::uint32_t period) {
+  if (running) return;
+  running = true;
+  task = new pros::Task(
+      [this, period]() {
+        std::uint32_t wake = pros::millis();
+        while (running) {
+          drain();
+          pros::Task::delay_until(&wake, period);
+        }
+      },
+      kPriority, TASK_STACK_DEPTH_DEFAULT, "log");
+}
+
+void telemetry::Log::stop() {
+  running = false;
+  if (task != nullptr) task->join();
+  delete task;
+  task = nullptr;
+}
+
+telemetry::Log &telemetry::telemetryLog() {
+  static Log log(kStdout, "TELE_START", "TELE_END\n");
+  return log;
+}
@@ -0,0 +1,156 @@
+#include "telemetry/recorder.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pros/misc.hpp"
+
+namespace {
+// below the log's task, since a block can keep the card busy for a while
+constexpr std::uint32_t kPriority = TASK_PRIORITY_DEFAULT - 2;
+// how often the writer empties the queue, ms
+constexpr std::uint32_t kPeriod = 20;
+constexpr int kMaxFiles = 1000;
+constexpr std::size_t kNameSize = 5;
+constexpr std::size_t kFrameRoom =
+    telemetry::kBlockSize - sizeof(telemetry::BlockHeader);
+}  // namespace
+
+telemetry::Recorder::Recorder(const char *directory, std::size_t fileSize)
+    : directory(directory),
+      maxBlocks(std::max<std::size_t>(fileSize / kBlockSize, 1)) {}
+
+bool telemetry::Recorder::start(const char *prefix) {
+  if (running || !pros::usd::is_installed()) return false;
+  // a recording that ended by itself still has its task to wait for
+  stop();
+  std::strncpy(name, prefix, kNameSize);
+  name[kNameSize] = '\0';
+  if (!openFile(0)) return false;
+
+  // samples sent as the last recording stopped belong to it, not this one
+  std::uint8_t message[4 + kMaxEncodedFrame];
+  while (queue.popOne(message, sizeof(message)) != 0) {}
+  header = {};
+  sequence = 0;
+  running = true;
+  task = new pros::Task([this]() { write(); }, kPriority,
+                        TASK_STACK_DEPTH_DEFAULT, "recorder");
+  return true;
+}
+
+void telemetry::Recorder::stop() {
+  if (task == nullptr) return;
+  running = false;
+  task->join();
+  delete task;
+  task = nullptr;
+}
+
+bool telemetry::Recorder::send(std::uint8_t channel,
+                               std::initializer_list<float> values) {
+  if (!running) return false;
+  const Schema *schema = findSchema(channel);
+  if (schema == nullptr || values.size() != schema->count) return false;
+  // the writer needs each frame's time for the block headers, so it travels
+  // ahead of the frame
+  std::uint8_t message[4 + kMaxEncodedFrame];
+  std::uint32_t time = pros::millis();
+  std::memcpy(message, &time, 4);
+  std::size_t size =
+      encodeFrame(*schema, true, time, values.begin(), message + 4);
+  return queue.push(message, 4 + size);
+}
+
+void telemetry::Recorder::write() {
+  std::uint8_t message[4 + kMaxEncodedFrame];
+  while (true) {
+    // read before emptying the queue, so nothing sent before stop is missed
+    bool stopping = !running;
+    std::size_t size;
+    while ((size = queue.popOne(message, sizeof(message))) != 0) {
+      std::uint32_t time;
+      std::memcpy(&time, message, 4);
+      append(time, message + 4, size - 4);
+    }
+    if (stopping) break;
+    pros::delay(kPeriod);
+  }
+  flushBlock();
+  closeFile();
+}
+
+void telemetry::Recorder::append(std::uint32_t time, const std::uint8_t *frame,
+                                 std::size_t size) {
+  if (header.used + size > kFrameRoom) flushBlock();
+  if (header.frames == 0) header.firstTime = time;
+  std::memcpy(block + sizeof(BlockHeader) + header.used, frame, size);
+  header.used += size;
+  header.frames++;
+  header.lastTime = time;
+}
+
+// Writes the block being filled, starting the next file first if this one is
+// full, and its index entry straight after, so a recording cut off by the
+// power going keeps the index of every block on the card. A block that
+// cannot be written is lost, and the next is written over whatever part of it
+// made it out, so every block stays where its number says. Recording carries
+// on, unless there is no next file to start, which ends the recording
+bool telemetry::Recorder::flushBlock() {
+  if (header.frames == 0) return true;
+  if (blocks == maxBlocks) {
+    closeFile();
+    if (!openFile(number + 1)) running = false;
+  }
+  header.magic = kBlockMagic;
+  header.sequence = sequence++;
+  std::memcpy(block, &header, sizeof(BlockHeader));
+  std::memset(block + sizeof(BlockHeader) + header.used, 0,
+              kFrameRoom - header.used);
+  const long offset = file != nullptr ? std::ftell(file) : -1;
+  bool written = offset >= 0 && std::fwrite(block, kBlockSize, 1, file) == 1 &&
+                 std::fflush(file) == 0;
+  if (written) {
+    blocks++;
+    const IndexEntry entry = {header.firstTime, header.lastTime,
+                              std::uint32_t(offset / kBlockSize)};
+    if (index != nullptr &&
+        (std::fwrite(&entry, sizeof(entry), 1, index) != 1 ||
+         std::fflush(index) != 0)) {
+      // an entry written in part would throw off every entry after it, so
+      // the index stops short and a reader takes the rest from the headers
+      std::fclose(index);
+      index = nullptr;
+    }
+  } else if (offset >= 0) {
+    std::fseek(file, offset, SEEK_SET);
+  }
+  header = {};
+  return written;
+}
+
+// opens the first file numbered `from` or later that is not in use, leaving
+// earlier recordings alone, and its index
+bool telemetry::Recorder::openFile(int from) {
+  char path[64];
+  for (number = from; number < kMaxFiles; number++) {
+    std::snprintf(path, sizeof(path), "%s/%s%03d.tlm", directory, name, number);
+    std::FILE *existing = std::fopen(path, "rb");
+    if (existing == nullptr) break;
+    std::fclose(existing);
+  }
+  if (number == kMaxFiles) return false;
+  file = std::fopen(path, "wb");
+  if (file == nullptr) return false;
+  blocks = 0;
+  std::snprintf(path, sizeof(path), "%s/%s%03d.idx", directory, name, number);
+  index = std::fopen(path, "wb");
+  return true;
+}
+
+void telemetry::Recorder::closeFile() {
+  if (index != nullptr) std::fclose(index);
+  index = nullptr;
+  if (file != nullptr) std::fclose(file);
+  file = nullptr;
+}
@@ -0,0 +1,33 @@
+#include "telemetry/stream.h"
+
+namespace {
+// how often each channel sends its absolute time, ms
+constexpr std::uint32_t kAbsolutePeriod = 1000;
+}  // namespace
+
+telemetry::Stream::Stream(Log &log) : log(log) {}
+
+bool telemetry::Stream::send(std::uint8_t channel,
+                             std::initializer_list<float> values) {
+  const Schema *schema = findSchema(channel);
+  if (schema == nullptr || values.size() != schema->count) return false;
+
+  std::uint32_t now = pros::millis();
+  bool sync = !started[channel] || now - absolute[channel] >= kAbsolutePeriod;
+  std::uint8_t frame[kMaxEncodedFrame];
+  std::size_t size = encodeFrame(*schema, sync,
+                                 sync ? now : now - previous[channel],
+                                 values.begin(), frame);
+  // a dropped frame leaves the channel's times where they were, so the next
+  // frame's time still counts from the last one sent
+  if (!log.write(frame, size)) return false;
+  previous[channel] = now;
+  if (sync) absolute[channel] = now;
+  started[channel] = true;
+  return true;
+}
+
+telemetry::Stream &telemetry::telemetryStream() {
+  static Stream stream(telemetryLog());
+  return stream;
+}
@@ -0,0 +1,252 @@
+#include "tune/autotuner.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "lemlib/util.hpp"
+#include "pros/rtos.hpp"
+#include "telemetry/log.h"
+
+namespace {
+// ms between the updates of LemLib's PIDs, which is what their kD and kI are
+// per
+constexpr float kPidPeriod = 10;
+// ms to let the robot come to rest between tests
+constexpr std::uint32_t kRest = 300;
+// Relay cycles to let the oscillation settle before measuring it, and to
+// measure. The test gives up after kRelayTimeout ms
+constexpr int kRelaySkip = 2;
+constexpr int kRelayCycles = 4;
+constexpr std::uint32_t kRelayTimeout = 10000;
+
+const char *loopName(tune::Loop loop) {
+  return loop == tune::Loop::Lateral ? "lateral" : "angular";
+}
+
+// how far the robot has come from `start`: forwards along its heading there,
+// or clockwise
+float travelled(tune::Loop loop, const lemlib::Pose &start,
+                const lemlib::Pose &pose) {
+  if (loop == tune::Loop::Angular) {
+    return lemlib::angleError(pose.theta, start.theta, false);
+  }
+  float heading = lemlib::degToRad(start.theta);
+  return (pose.x - start.x) * std::sin(heading) +
+         (pose.y - start.y) * std::cos(heading);
+}
+
+// a candidate of the refinement, with the gains as logarithms so the search
+// moves them by ratios
+struct Vertex {
+  float logP;
+  float logD;
+  float cost;
+  tune::StepResponse response;
+};
+}  // namespace
+
+tune::RelayResponse tune::Autotuner::relay(Loop loop,
+                                          const TuneSettings &settings) {
+  auto drive = [&](float power) {
+    if (loop == Loop::Angular) {
+      chassis.tank(power, -power, true);
+    } else {
+      chassis.tank(power, power, true);
+    }
+  };
+  const lemlib::Pose start = chassis.getPose();
+  float output = settings.relayPower;
+  float high = -INFINITY;
+  float low = INFINITY;
+  int cycles = 0;
+  float periods = 0;
+  float amplitudes = 0;
+  std::uint32_t lastUp = 0;
+  const std::uint32_t begin = pros::millis();
+  std::uint32_t wake = begin;
+
+  while (pros::millis() - begin < kRelayTimeout &&
+         cycles < kRelaySkip + kRelayCycles) {
+    // how far the robot is short of where it started
+    float error = -travelled(loop, start, chassis.getPose());
+    high = std::max(high, error);
+    low = std::min(low, error);
+    if (output < 0 && error > settings.hysteresis) {
+      // one whole cycle since the last switch this way
+      output = settings.relayPower;
+      std::uint32_t now = pros::millis();
+      if (lastUp != 0 && cycles++ >= kRelaySkip) {
+        periods += now - lastUp;
+        amplitudes += (high - low) / 2;
+      }
+      lastUp = now;
+      high = error;
+      low = error;
+    } else if (output > 0 && error < -settings.hysteresis) {
+      output = -settings.relayPower;
+    }
+    drive(output);
+    pros::Task::delay_until(&wake, kPidPeriod);
+  }
+  drive(0);
+  pros::delay(kRest);
+
+  const int measured = cycles - kRelaySkip;
+  if (measured <= 0) return {0, 0, 0};
+  RelayResponse response = {amplitudes / measured, periods / measured, 0};
+  // the describing function of a relay with hysteresis
+  float swing = std::sqrt(std::max(
+      response.amplitude * response.amplitude -
+          settings.hysteresis * settings.hysteresis,
+      1e-6f));
+  response.ultimateGain = 4 * settings.relayPower / (float(M_PI) * swing);
+  return response;
+}
+
+tune::StepResponse tune::Autotuner::step(
+    Loop loop, const lemlib::ControllerSettings &gains,
+    const TuneSettings &settings) {
+  if (loop == Loop::Lateral) {
+    chassis.setLateralSettings(gains);
+  } else {
+    chassis.setAngularSettings(gains);
+  }
+  StepResponse away = stepOnce(loop, settings.step, settings);
+  StepResponse back = stepOnce(loop, -settings.step, settings);
+  return {(away.rise + back.rise) / 2, (away.overshoot + back.overshoot) / 2,
+          (away.settle + back.settle) / 2, (away.error + back.error) / 2};
+}
+
+// Samples the motion at the rate its PID runs, for the whole window whether
+// or not the exit conditions end the motion sooner
+tune::StepResponse tune::Autotuner::stepOnce(Loop loop, float distance,
+                                             const TuneSettings &settings) {
+  const lemlib::Pose start = chassis.getPose();
+  const std::uint32_t begin = pros::millis();
+  if (loop == Loop::Angular) {
+    chassis.turnToHeading(start.theta + distance, settings.window);
+  } else {
+    float heading = lemlib::degToRad(start.theta);
+    chassis.moveToPoint(start.x + distance * std::sin(heading),
+                        start.y + distance * std::cos(heading),
+                        settings.window, {.forwards = distance > 0});
+  }
+
+  const float size = std::fabs(distance);
+  const float sign = lemlib::sgn(distance);
+  float low = -1;
+  float high = -1;
+  StepResponse response = {float(settings.window), 0, 0, 0};
+  std::uint32_t wake = begin;
+  for (std::uint32_t elapsed = 0; elapsed < std::uint32_t(settings.window);
+       elapsed = pros::millis() - begin) {
+    float progress = sign * travelled(loop, start, chassis.getPose());
+    if (low < 0 && progress >= 0.1f * size) low = elapsed;
+    if (high < 0 && progress >= 0.9f * size) high = elapsed;
+    response.overshoot = std::max(response.overshoot, progress - size);
+    response.error = std::fabs(progress - size);
+    if (response.error > settings.tolerance) {
+      response.settle = elapsed + kPidPeriod;
+    }
+    pros::Task::delay_until(&wake, kPidPeriod);
+  }
+  if (low >= 0 && high >= 0) response.rise = high - low;
+  if (response.error > settings.tolerance) response.settle = settings.window;
+  chassis.waitUntilDone();
+  pros::delay(kRest);
+  return response;
+}
+
+float tune::Autotuner::cost(const StepResponse &response,
+                            const TuneSettings &settings) const {
+  return response.settle +
+         settings.overshootCost *
+             (std::max(response.overshoot - settings.tolerance, 0.0f) +
+              std::max(response.error - settings.tolerance, 0.0f));
+}
+
+lemlib::ControllerSettings tune::Autotuner::relayGains(
+    Loop loop, const TuneSettings &settings) {
+  lemlib::ControllerSettings gains = loop == Loop::Lateral
+                                         ? chassis.getLateralSettings()
+                                         : chassis.getAngularSettings();
+  RelayResponse relayed = relay(loop, settings);
+  if (relayed.period > 0) {
+    // kP of 0.8 Ku, and a derivative time of an eighth of the period
+    gains.kP = 0.8f * relayed.ultimateGain;
+    gains.kD = gains.kP * relayed.period / 8 / kPidPeriod;
+  } else {
+    telemetry::telemetryLog().warn(
+        "Tuning {}: the relay test never oscillated, refining the gains it "
+        "had",
+        loopName(loop));
+  }
+  return gains;
+}
+
+lemlib::ControllerSettings tune::Autotuner::tune(Loop loop,
+                                                 const TuneSettings &settings) {
+  lemlib::ControllerSettings gains = relayGains(loop, settings);
+
+  // Nelder-Mead over log kP and log kD, from the relay's gains and ones half
+  // as large again in each
+  int evaluations = 0;
+  auto evaluate = [&](float logP, float logD) {
+    lemlib::ControllerSettings candidate = gains;
+    candidate.kP = std::exp(logP);
+    candidate.kD = std::exp(logD);
+    StepResponse response = step(loop, candidate, settings);
+    evaluations++;
+    return Vertex{logP, logD, cost(response, settings), response};
+  };
+  const float logP = std::log(std::max(gains.kP, 1e-4f));
+  const float logD = std::log(std::max(gains.kD, 1e-4f));
+  const float spread = std::log(1.5f);
+  Vertex simplex[3] = {evaluate(logP, logD), evaluate(logP + spread, logD),
+                       evaluate(logP, logD + spread)};
+  auto byCost = [](const Vertex &a, const Vertex &b) { return a.cost < b.cost; };
+
+  while (evaluations < settings.evaluations) {
+    std::sort(simplex, simplex + 3, byCost);
+    Vertex &worst = simplex[2];
+    const float centreP = (simplex[0].logP + simplex[1].logP) / 2;
+    const float centreD = (simplex[0].logD + simplex[1].logD) / 2;
+    auto toward = [&](float by) {
+      return evaluate(centreP + by * (worst.logP - centreP),
+                      centreD + by * (worst.logD - centreD));
+    };
+    Vertex reflected = toward(-1);
+    if (reflected.cost < simplex[0].cost) {
+      Vertex expanded = toward(-2);
+      worst = expanded.cost < reflected.cost ? expanded : reflected;
+    } else if (reflected.cost < simplex[1].cost) {
+      worst = reflected;
+    } else {
+      Vertex contracted = toward(reflected.cost < worst.cost ? -0.5f : 0.5f);
+      if (contracted.cost < std::min(reflected.cost, worst.cost)) {
+        worst = contracted;
+      } else {
+        // shrink towards the best
+        for (int i = 1; i < 3; i++) {
+          simplex[i] = evaluate((simplex[0].logP + simplex[i].logP) / 2,
+                                (simplex[0].logD + simplex[i].logD) / 2);
+        }
+      }
+    }
+  }
+  const Vertex &best = *std::min_element(simplex, simplex + 3, byCost);
+
+  gains.kP = std::exp(best.logP);
+  gains.kD = std::exp(best.logD);
+  if (loop == Loop::Lateral) {
+    chassis.setLateralSettings(gains);
+  } else {
+    chassis.setAngularSettings(gains);
+  }
+  telemetry::telemetryLog().info(
+      "Tuned {} PID: kP {:.4g} kI {:.4g} kD {:.4g}; rise {:.0f} ms, overshoot "
+      "{:.2f}, settle {:.0f} ms",
+      loopName(loop), gains.kP, gains.kI, gains.kD, best.response.rise,
+      best.response.overshoot, best.response.settle);
+  return gains;
+}
@@ -0,0 +1,100 @@
+// Converts LemLib path text into the binary path format of path/binaryPath.h,
+// so the robot reads paths in place instead of parsing them when a motion
+// starts. Run on the host; `make paths` builds it and converts every path
+// listed in host.mk.
+//
+//   usage: pathConverter <path.txt> <path.path>
+//
+// The text is what LemLib's follow reads: one "x, y, speed" point per line, up
+// to a line reading endData. Anything after that is path generator metadata
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "path/binaryPath.h"
+
+namespace {
+struct Waypoint {
+  double x;
+  double y;
+  double speed;
+};
+
+// Signed curvature of the circle through three points, positive turning
+// clockwise. Repeated points make a straight line
+double curvature(const Waypoint &a, const Waypoint &b, const Waypoint &c) {
+  double ab = std::hypot(b.x - a.x, b.y - a.y);
+  double bc = std::hypot(c.x - b.x, c.y - b.y);
+  double ca = std::hypot(a.x - c.x, a.y - c.y);
+  if (ab * bc * ca == 0) return 0;
+  // counterclockwise turns have a positive cross product
+  double cross = (b.x - a.x) * (c.y - b.y) - (b.y - a.y) * (c.x - b.x);
+  return -2 * cross / (ab * bc * ca);
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    std::fprintf(stderr, "usage: %s <path.txt> <path.path>\n", argv[0]);
+    return 2;
+  }
+
+  std::ifstream in(argv[1]);
+  if (!in) {
+    std::fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
+    return 1;
+  }
+  std::vector<Waypoint> waypoints;
+  std::string line;
+  while (std::getline(in, line) && line.rfind("endData", 0) != 0) {
+    Waypoint point;
+    if (std::sscanf(line.c_str(), "%lf , %lf , %lf", &point.x, &point.y,
+                    &point.speed) == 3) {
+      waypoints.push_back(point);
+    }
+  }
+  if (waypoints.empty()) {
+    std::fprintf(stderr, "%s: no points in %s\n", argv[0], argv[1]);
+    return 1;
+  }
+
+  std::vector<path::Point> points;
+  double distance = 0;
+  for (std::size_t i = 0; i < waypoints.size(); i++) {
+    const Waypoint &point = waypoints[i];
+    if (i > 0) {
+      distance += std::hypot(point.x - waypoints[i - 1].x,
+                             point.y - waypoints[i - 1].y);
+    }
+    // the ends take the curvature of their neighbours
+    double k = 0;
+    if (waypoints.size() >= 3) {
+      std::size_t middle = std::min(std::max<std::size_t>(i, 1),
+                                    waypoints.size() - 2);
+      k = curvature(waypoints[middle - 1], waypoints[middle],
+                    waypoints[middle + 1]);
+    }
+    points.push_back({float(point.x), float(point.y), float(point.speed),
+                      float(distance), float(k)});
+  }
+
+  path::Header header = {path::kMagic, path::kVersion, sizeof(path::Point),
+                         std::uint32_t(points.size()), float(distance)};
+  std::FILE *out = std::fopen(argv[2], "wb");
+  if (out == nullptr) {
+    std::fprintf(stderr, "%s: cannot write %s\n", argv[0], argv[2]);
+    return 1;
+  }
+  bool written = std::fwrite(&header, sizeof(header), 1, out) == 1 &&
+                 std::fwrite(points.data(), sizeof(path::Point), points.size(),
+                             out) == points.size();
+  if (std::fclose(out) != 0 || !written) {
+    std::fprintf(stderr, "%s: cannot write %s\n", argv[0], argv[2]);
+    return 1;
+  }
+  std::printf("%s: %zu points, %.1f in\n", argv[2], points.size(), distance);
+  return 0;
+}
@@ -0,0 +1,207 @@
+// Converts telemetry into one CSV per channel. Reads either a capture of the
+// robot's serial output, with the binary frames of telemetry/frame.h among
+// its text, or a recording from the SD card in the format of
+// telemetry/record.h. Run on the host; `make tools` builds it.
+//
+//   usage: telemetryDecoder [--from ms] [--to ms] <capture> [<prefix>]
+//
+// Writes <prefix>.<channel>.csv for each channel in the capture, with the time
+// in ms since the program started and then the channel's fields. The prefix
+// defaults to the capture's name without its extension. --from and --to keep
+// only the samples in that span of time; a recording's index, the .idx file
+// next to it, lets them seek straight to the first block that is needed.
+//
+// In a serial capture, a channel's samples before its first absolute time are
+// skipped, since their times are unknown
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "telemetry/frame.h"
+#include "telemetry/record.h"
+
+namespace {
+struct Channel {
+  std::FILE *file = nullptr;
+  bool timed = false; // seen an absolute time
+  std::uint32_t time = 0;
+  std::size_t samples = 0;
+};
+
+struct Decoder {
+  std::string prefix;
+  std::uint32_t from = 0;
+  std::uint32_t to = UINT32_MAX;
+  Channel channels[telemetry::kChannels];
+  std::size_t skipped = 0;
+
+  // false if a CSV file cannot be opened
+  bool add(const telemetry::Frame &frame) {
+    Channel &channel = channels[frame.schema->id];
+    if (frame.absolute) {
+      channel.time = frame.time;
+      channel.timed = true;
+    } else {
+      channel.time += frame.time;
+    }
+    if (!channel.timed) {
+      skipped++;
+      return true;
+    }
+    if (channel.time < from || channel.time > to) return true;
+    if (channel.file == nullptr) {
+      std::string path = prefix + "." + frame.schema->name + ".csv";
+      channel.file = std::fopen(path.c_str(), "w");
+      if (channel.file == nullptr) {
+        std::fprintf(stderr, "cannot write %s\n", path.c_str());
+        return false;
+      }
+      std::fprintf(channel.file, "time");
+      for (std::size_t f = 0; f < frame.schema->count; f++) {
+        std::fprintf(channel.file, ",%s", frame.schema->fields[f].name);
+      }
+      std::fprintf(channel.file, "\n");
+    }
+    std::fprintf(channel.file, "%u", channel.time);
+    for (std::size_t f = 0; f < frame.schema->count; f++) {
+      std::fprintf(channel.file, ",%g", frame.values[f]);
+    }
+    std::fprintf(channel.file, "\n");
+    channel.samples++;
+    return true;
+  }
+
+  // decodes every frame between zero delimiters, skipping anything else
+  bool addFrames(const std::uint8_t *bytes, std::size_t size) {
+    std::size_t start = 0;
+    for (std::size_t i = 0; i <= size; i++) {
+      if (i < size && bytes[i] != 0) continue;
+      telemetry::Frame frame;
+      if (i > start && telemetry::decodeFrame(bytes + start, i - start, frame) &&
+          !add(frame)) {
+        return false;
+      }
+      start = i + 1;
+    }
+    return true;
+  }
+};
+
+std::vector<std::uint8_t> readFile(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<std::uint8_t>((std::istreambuf_iterator<char>(in)),
+                                   std::istreambuf_iterator<char>());
+}
+
+bool isRecording(const std::vector<std::uint8_t> &file) {
+  std::uint32_t magic = 0;
+  if (file.size() >= 4) std::memcpy(&magic, file.data(), 4);
+  return magic == telemetry::kBlockMagic &&
+         file.size() >= telemetry::kBlockSize;
+}
+
+// The first block that could hold samples from `from`: from the index, and
+// from the block headers past where it stops, or all of them without one. A
+// recording cut off by the power going may end part way through a block,
+// which is left out
+std::size_t firstBlock(const std::vector<std::uint8_t> &file,
+                       const std::string &path, std::uint32_t from) {
+  std::string indexPath = path.substr(0, path.rfind('.')) + ".idx";
+  std::vector<std::uint8_t> bytes = readFile(indexPath);
+  std::vector<telemetry::IndexEntry> index(bytes.size() /
+                                           sizeof(telemetry::IndexEntry));
+  std::memcpy(index.data(), bytes.data(),
+              index.size() * sizeof(telemetry::IndexEntry));
+  const std::size_t blocks = file.size() / telemetry::kBlockSize;
+  for (std::size_t block = index.empty() ? 0 : index.back().block + 1;
+       block < blocks; block++) {
+    telemetry::BlockHeader header;
+    std::memcpy(&header, file.data() + block * telemetry::kBlockSize,
+                sizeof(header));
+    if (header.magic != telemetry::kBlockMagic) continue;
+    index.push_back({header.firstTime, header.lastTime,
+                     std::uint32_t(block)});
+  }
+  // blocks are in time order
+  auto entry = std::lower_bound(
+      index.begin(), index.end(), from,
+      [](const telemetry::IndexEntry &entry, std::uint32_t time) {
+        return entry.lastTime < time;
+      });
+  return entry == index.end() ? blocks : entry->block;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  Decoder decoder;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; i++) {
+    if (!std::strcmp(argv[i], "--from") && i + 1 < argc) {
+      decoder.from = std::strtoul(argv[++i], nullptr, 10);
+    } else if (!std::strcmp(argv[i], "--to") && i + 1 < argc) {
+      decoder.to = std::strtoul(argv[++i], nullptr, 10);
+    } else {
+      paths.push_back(argv[i]);
+    }
+  }
+  if (paths.empty() || paths.size() > 2) {
+    std::fprintf(stderr,
+                 "usage: %s [--from ms] [--to ms] <capture> [<prefix>]\n",
+                 argv[0]);
+    return 2;
+  }
+  std::ifstream in(paths[0], std::ios::binary);
+  if (!in) {
+    std::fprintf(stderr, "%s: cannot open %s\n", argv[0], paths[0].c_str());
+    return 1;
+  }
+  std::vector<std::uint8_t> capture = readFile(paths[0]);
+  decoder.prefix = paths.size() == 2 ? paths[1] : paths[0];
+  if (paths.size() == 1) {
+    std::size_t dot = decoder.prefix.rfind('.');
+    if (dot != std::string::npos &&
+        decoder.prefix.find('/', dot) == std::string::npos) {
+      decoder.prefix.erase(dot);
+    }
+  }
+
+  bool decoded = true;
+  if (isRecording(capture)) {
+    for (std::size_t block = firstBlock(capture, paths[0], decoder.from);
+         decoded && block < capture.size() / telemetry::kBlockSize; block++) {
+      const std::uint8_t *start = capture.data() + block * telemetry::kBlockSize;
+      telemetry::BlockHeader header;
+      std::memcpy(&header, start, sizeof(header));
+      if (header.magic != telemetry::kBlockMagic) continue;
+      if (header.firstTime > decoder.to) break;
+      decoded = decoder.addFrames(start + sizeof(header), header.used);
+    }
+  } else {
+    decoded = decoder.addFrames(capture.data(), capture.size());
+  }
+
+  bool failed = !decoded;
+  for (const telemetry::Schema &schema : telemetry::kSchemas) {
+    Channel &channel = decoder.channels[schema.id];
+    if (channel.file == nullptr) continue;
+    failed |= std::fclose(channel.file) != 0;
+    std::printf("%s.%s.csv: %zu samples\n", decoder.prefix.c_str(), schema.name,
+                channel.samples);
+  }
+  if (decoder.skipped != 0) {
+    std::printf("%zu samples skipped before their channel's first absolute "
+                "time\n",
+                decoder.skipped);
+  }
+  if (failed) {
+    std::fprintf(stderr, "%s: cannot write the CSV files\n", argv[0]);
+    return 1;
+  }
+  return 0;
+}